@@ -0,0 +1,501 @@
+#include "BenchGame.hpp"
+
+#include "BladeEngine.hpp"
+
+#include "Graphics/RenderQueue.hpp"
+#include "Graphics/SpriteSheet.hpp"
+#include "Graphics/TextureLoader.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+namespace BladeEngine {
+
+	// Same seed every run so two reports of the same scene draw the same entities
+	constexpr uint32_t k_BenchSeed = 1337;
+
+	constexpr float k_ViewHeight = 20.0f;
+
+	// Every spawned body is destroyed this long after, so about --count of them are alive in the spawn scene
+	constexpr float k_SpawnLifetime = 1.0f;
+	constexpr float k_SpawnSize = 0.25f;
+
+	// The render queue is sized for this many draws a frame
+	constexpr uint32_t k_SortKeyCount = 100000;
+
+	std::vector<Graphics::TextureHandle> g_BenchTextures;
+
+	Graphics::TextureHandle g_TexturePlayerIdle;
+	Graphics::SpriteSheet* g_SpriteSheetPlayerIdle;
+	SpriteAnimation g_IdleAnimation;
+
+	Graphics::Font* g_OpenSansRegular;
+
+	const char* g_BenchTexturePaths[] = {
+		"assets/sprites/tex_DebugUVTiles.png",
+		"assets/sprites/default-checker-black.png",
+		"assets/sprites/default-checker-gray.png",
+		"assets/sprites/Chick-Boy Free Pack/tile000.png",
+		"assets/sprites/Chick-Boy Free Pack/tile001.png",
+		"assets/sprites/Chick-Boy Free Pack/tile002.png",
+		"assets/sprites/Chick-Boy Free Pack/tile003.png",
+		"assets/sprites/Chick-Boy Free Pack/tile004.png",
+		"assets/sprites/Chick-Boy Free Pack/tile005.png",
+		"assets/sprites/Sunny-land-assets-files/PNG/environment/props/block.png",
+		"assets/sprites/Sunny-land-assets-files/PNG/environment/props/bush.png",
+		"assets/sprites/Sunny-land-assets-files/PNG/environment/props/door.png",
+		"assets/sprites/Sunny-land-assets-files/PNG/environment/props/face-block.png",
+		"assets/sprites/Sunny-land-assets-files/PNG/environment/props/shrooms.png",
+		"assets/sprites/Sunny-land-assets-files/PNG/environment/props/skulls.png",
+		"assets/sprites/Sunny-land-assets-files/PNG/environment/props/spikes.png",
+	};
+
+	struct BenchSceneName
+	{
+		BenchScene Scene;
+		const char* Name;
+	};
+
+	const BenchSceneName g_BenchSceneNames[] = {
+		{ BenchScene::Sprites, "sprites" },
+		{ BenchScene::Animated, "animated" },
+		{ BenchScene::Text, "text" },
+		{ BenchScene::Physics, "physics" },
+		{ BenchScene::Textures, "textures" },
+		{ BenchScene::Mixed, "mixed" },
+		{ BenchScene::Spawn, "spawn" },
+		{ BenchScene::SortKeys, "sortkeys" },
+	};
+
+	struct BenchLifetime
+	{
+		float Remaining;
+	};
+
+	const char* GetSceneName(BenchScene scene)
+	{
+		for (const BenchSceneName& entry : g_BenchSceneNames)
+		{
+			if (entry.Scene == scene) return entry.Name;
+		}
+
+		return "unknown";
+	}
+
+	const char* GetSpriteRenderModeName(Graphics::SpriteRenderMode mode)
+	{
+		switch (mode)
+		{
+		case Graphics::SpriteRenderMode::Batched: return "batched";
+		case Graphics::SpriteRenderMode::Instanced: return "instanced";
+		case Graphics::SpriteRenderMode::Bindless: return "bindless";
+		}
+
+		return "unknown";
+	}
+
+	// Cells of a grid filling the camera view, so every entity passes culling and ends up drawn
+	struct BenchGrid
+	{
+		uint32_t Columns;
+		uint32_t Rows;
+		Vec2 CellSize;
+		Vec2 Origin;
+
+		BenchGrid(uint32_t count, float width, float height)
+		{
+			count = count > 0 ? count : 1;
+
+			Columns = (uint32_t)std::ceil(std::sqrt(count * width / height));
+			Rows = (count + Columns - 1) / Columns;
+			CellSize = Vec2(width / Columns, height / Rows);
+			Origin = Vec2(-width * 0.5f, -height * 0.5f);
+		}
+
+		Vec2 GetCellCenter(uint32_t index) const
+		{
+			return Vec2(
+				Origin.X + (index % Columns + 0.5f) * CellSize.X,
+				Origin.Y + (index / Columns + 0.5f) * CellSize.Y);
+		}
+
+		float GetCellExtent() const { return CellSize.X < CellSize.Y ? CellSize.X : CellSize.Y; }
+	};
+
+	Entity CreateQuad(Vec2 position, float size)
+	{
+		Entity entity = World::CreateEntity();
+		entity.SetComponent<Position>({ position });
+		entity.SetComponent<Rotation>({ 0.0f });
+		entity.SetComponent<Scale>({ { size, size } });
+		entity.AddComponent<LocalToWorld>();
+
+		return entity;
+	}
+
+	void CreateStaticSprite(Vec2 position, float size, Graphics::Texture2D* texture)
+	{
+		Entity sprite = CreateQuad(position, size);
+		sprite.SetComponent<SpriteRenderer>({ texture });
+	}
+
+	void CreateAnimatedSprite(Vec2 position, float size, std::minstd_rand& random)
+	{
+		Entity sprite = CreateQuad(position, size);
+
+		// Every animator points at the one shared animation, started at a random frame so the swaps spread out
+		SpriteAnimator animator;
+		animator.CurrentAnimation = &g_IdleAnimation;
+		animator.CurrentFrame = random() % g_IdleAnimation.Frames.size();
+		animator.Time = (random() % 1000) / 1000.0f * g_IdleAnimation.FrameDuration;
+
+		sprite.SetComponent<SpriteRenderer>(SpriteRenderer(g_IdleAnimation.Frames[animator.CurrentFrame]));
+		sprite.SetComponent<SpriteAnimator>(std::move(animator));
+	}
+
+	void CreateLabel(Vec2 position, float size, uint32_t index)
+	{
+		Entity label = CreateQuad(position, size);
+		label.SetComponent<TextRenderer>({ g_OpenSansRegular, "#" + std::to_string(index) });
+	}
+
+	void CreatePhysicsBody(Vec2 position, float size, Graphics::Texture2D* texture)
+	{
+		Entity body = CreateQuad(position, size);
+		body.SetComponent<SpriteRenderer>({ texture });
+
+		Rigidbody2D rigidbody;
+		rigidbody.Type = Rigidbody2D::BodyType::Dynamic;
+		body.SetComponent<Rigidbody2D>(std::move(rigidbody));
+
+		BoxCollider2D collider;
+		collider.HalfExtents = { size * 0.5f, size * 0.5f };
+		body.SetComponent<BoxCollider2D>(std::move(collider));
+	}
+
+	void SpawnPhysicsBody(Vec2 position, Graphics::Texture2D* texture)
+	{
+		Entity body = CreateQuad(position, k_SpawnSize);
+		body.SetComponent<SpriteRenderer>({ texture });
+		body.SetComponent<BenchLifetime>({ k_SpawnLifetime });
+
+		Rigidbody2D rigidbody;
+		rigidbody.Type = Rigidbody2D::BodyType::Dynamic;
+		body.SetComponent<Rigidbody2D>(std::move(rigidbody));
+
+		BoxCollider2D collider;
+		collider.HalfExtents = { k_SpawnSize * 0.5f, k_SpawnSize * 0.5f };
+		body.SetComponent<BoxCollider2D>(std::move(collider));
+	}
+
+	void CreateStaticCollider(Vec2 position, Vec2 halfExtents, Graphics::Texture2D* texture)
+	{
+		Entity collider = World::CreateEntity();
+		collider.SetComponent<Position>({ position });
+		collider.SetComponent<Rotation>({ 0.0f });
+		collider.SetComponent<Scale>({ { halfExtents.X * 2.0f, halfExtents.Y * 2.0f } });
+		collider.AddComponent<LocalToWorld>();
+		collider.SetComponent<SpriteRenderer>({ texture });
+		collider.AddComponent<Rigidbody2D>();
+
+		BoxCollider2D box;
+		box.HalfExtents = halfExtents;
+		collider.SetComponent<BoxCollider2D>(std::move(box));
+	}
+
+	BenchGame::BenchGame()
+		: Game([]() {
+			// Before the engine logs anything, so piping stdout yields valid JSON
+			Log::RedirectToStderr();
+
+			GameSpecification specification;
+			specification.Title = "BladeBench";
+			specification.FrameLimit = 600;
+			return specification;
+		}())
+	{
+		ParseCommandLine();
+	}
+
+	void BenchGame::ParseCommandLine()
+	{
+		const std::vector<std::string>& commandLine = GetCommandLine();
+
+		for (size_t i = 0; i + 1 < commandLine.size(); i++)
+		{
+			const std::string& argument = commandLine[i];
+
+			if (argument == "--scene")
+			{
+				const std::string& name = commandLine[++i];
+
+				bool found = false;
+				for (const BenchSceneName& entry : g_BenchSceneNames)
+				{
+					if (name == entry.Name)
+					{
+						m_Scene = entry.Scene;
+						found = true;
+					}
+				}
+
+				if (!found) BLD_WARN("Unknown scene {}, running {}", name, GetSceneName(m_Scene));
+			}
+			else if (argument == "--count")
+			{
+				m_Count = (uint32_t)strtoul(commandLine[++i].c_str(), nullptr, 10);
+				m_CountGiven = true;
+			}
+			else if (argument == "--warmup")
+			{
+				m_WarmupFrames = (uint32_t)strtoul(commandLine[++i].c_str(), nullptr, 10);
+			}
+			else if (argument == "--output")
+			{
+				m_OutputPath = commandLine[++i];
+			}
+			else if (argument == "--mode")
+			{
+				const std::string& mode = commandLine[++i];
+
+				if (mode == "batched")
+					Graphics::GraphicsManager::Instance()->SetSpriteRenderMode(Graphics::SpriteRenderMode::Batched);
+				else if (mode == "instanced")
+					Graphics::GraphicsManager::Instance()->SetSpriteRenderMode(Graphics::SpriteRenderMode::Instanced);
+				else if (mode == "bindless")
+					Graphics::GraphicsManager::Instance()->SetSpriteRenderMode(Graphics::SpriteRenderMode::Bindless);
+				else
+					BLD_WARN("Unknown sprite render mode {}", mode);
+			}
+		}
+
+		if (m_Scene == BenchScene::SortKeys && !m_CountGiven)
+		{
+			m_Count = k_SortKeyCount;
+		}
+
+		const uint32_t frameLimit = GetSpecification().FrameLimit;
+		if (frameLimit > 0 && m_WarmupFrames >= frameLimit)
+		{
+			BLD_WARN("{} warmup frames leave nothing to measure in a {} frame run, measuring the last half",
+				m_WarmupFrames, frameLimit);
+			m_WarmupFrames = frameLimit / 2;
+		}
+	}
+
+	void BenchGame::LoadGameResources()
+	{
+		using namespace Graphics;
+
+		Texture2D::SamplerConfiguration samplerConfig;
+		samplerConfig.Filter = SamplerFilter::Nearest;
+		samplerConfig.AdressMode = SamplerAddressMode::ClampToEdges;
+
+		for (const char* path : g_BenchTexturePaths)
+		{
+			g_BenchTextures.push_back(TextureLoader::LoadAsync(path, samplerConfig));
+		}
+
+		g_TexturePlayerIdle = TextureLoader::LoadAsync(
+			"assets/sprites/Sunny-land-assets-files/PNG/spritesheets/player-idle.png", samplerConfig);
+
+		// Nothing may still be decoding or uploading once frames are measured
+		for (TextureHandle& texture : g_BenchTextures)
+		{
+			texture.Wait();
+		}
+		g_TexturePlayerIdle.Wait();
+
+		g_SpriteSheetPlayerIdle = new SpriteSheet(g_TexturePlayerIdle.GetTexture(), 33, 32);
+
+		g_IdleAnimation.Frames = g_SpriteSheetPlayerIdle->GetFrames();
+		g_IdleAnimation.FrameDuration = 1 / 6.0f;
+
+		g_OpenSansRegular = new Font("assets/fonts/open-sans/OpenSans-Regular.ttf");
+	}
+
+	void BenchGame::UnloadGameResources()
+	{
+		using namespace Graphics;
+
+		BenchRun run;
+		run.Scene = GetSceneName(m_Scene);
+		run.Count = m_Count;
+		run.WarmupFrames = m_WarmupFrames;
+		run.SpriteRenderMode = GetSpriteRenderModeName(GraphicsManager::Instance()->GetSpriteRenderMode());
+		run.Headless = GraphicsManager::Instance()->IsHeadless();
+		run.Width = GetSpecification().Width;
+		run.Height = GetSpecification().Height;
+
+		if (m_OutputPath.empty() || m_OutputPath == "-")
+		{
+			m_Report.WriteJSON(run, std::cout);
+		}
+		else if (m_Report.SaveJSON(run, m_OutputPath))
+		{
+			BLD_INFO("Wrote {} frames of {} to {}", m_Report.GetFrameCount(), run.Scene, m_OutputPath);
+		}
+
+		for (TextureHandle& texture : g_BenchTextures)
+		{
+			TextureLoader::Unload(texture);
+		}
+		g_BenchTextures.clear();
+
+		delete g_SpriteSheetPlayerIdle;
+		TextureLoader::Unload(g_TexturePlayerIdle);
+	}
+
+	void BenchGame::SetupWorld()
+	{
+		const GameSpecification& specification = GetSpecification();
+		const float viewWidth = k_ViewHeight * specification.Width / specification.Height;
+
+		Camera::GetMainCamera()->SetPosition({ 0.0f, 0.0f, 100.0f });
+
+		std::minstd_rand random(k_BenchSeed);
+
+		auto randomTexture = [&random]() {
+			return g_BenchTextures[random() % g_BenchTextures.size()].GetTexture();
+		};
+
+		// Spawned bodies come and go at runtime and sort keys draw nothing, the grid stays empty
+		const bool spawning = m_Scene == BenchScene::Spawn;
+		const bool sortingKeys = m_Scene == BenchScene::SortKeys;
+		const uint32_t gridCount = spawning || sortingKeys ? 0 : m_Count;
+
+		// Physics bodies need the bottom row for the ground
+		const bool hasPhysics = m_Scene == BenchScene::Physics || m_Scene == BenchScene::Mixed || spawning;
+		const float groundHeight = hasPhysics ? 1.0f : 0.0f;
+
+		BenchGrid grid(gridCount, viewWidth, k_ViewHeight - groundHeight);
+		grid.Origin.Y += groundHeight;
+
+		const float size = grid.GetCellExtent() * 0.8f;
+
+		for (uint32_t i = 0; i < gridCount; i++)
+		{
+			const Vec2 position = grid.GetCellCenter(i);
+
+			BenchScene scene = m_Scene;
+			if (scene == BenchScene::Mixed)
+			{
+				const BenchScene quarters[] = { BenchScene::Textures, BenchScene::Animated, BenchScene::Text, BenchScene::Physics };
+				scene = quarters[i % 4];
+			}
+
+			switch (scene)
+			{
+			case BenchScene::Sprites:
+				CreateStaticSprite(position, size, g_BenchTextures[0].GetTexture());
+				break;
+			case BenchScene::Animated:
+				CreateAnimatedSprite(position, size, random);
+				break;
+			case BenchScene::Text:
+				CreateLabel(position, size * 0.5f, i);
+				break;
+			case BenchScene::Physics:
+				CreatePhysicsBody(position, size, randomTexture());
+				break;
+			case BenchScene::Textures:
+			default:
+				CreateStaticSprite(position, size, randomTexture());
+				break;
+			}
+		}
+
+		if (hasPhysics)
+		{
+			// Ground and walls keep the pile inside the view
+			Graphics::Texture2D* groundTexture = g_BenchTextures[2].GetTexture();
+			CreateStaticCollider({ 0.0f, -k_ViewHeight * 0.5f + 0.5f }, { viewWidth * 0.5f, 0.5f }, groundTexture);
+			CreateStaticCollider({ -viewWidth * 0.5f - 0.5f, 0.0f }, { 0.5f, k_ViewHeight }, groundTexture);
+			CreateStaticCollider({ viewWidth * 0.5f + 0.5f, 0.0f }, { 0.5f, k_ViewHeight }, groundTexture);
+		}
+
+		if (spawning)
+		{
+			// Spawns across the top of the view at the requested rate, fractions carry over to the next frame
+			World::BindSystemNoQuery(flecs::OnUpdate, "Bench Spawn", [this, viewWidth](flecs::iter& it) {
+				static std::minstd_rand spawnRandom(k_BenchSeed);
+				static float pending = 0.0f;
+
+				pending += m_Count * it.delta_time();
+
+				for (; pending >= 1.0f; pending -= 1.0f)
+				{
+					const float x = ((spawnRandom() % 1000) / 1000.0f - 0.5f) * (viewWidth - k_SpawnSize);
+					SpawnPhysicsBody({ x, k_ViewHeight * 0.5f - k_SpawnSize },
+						g_BenchTextures[spawnRandom() % g_BenchTextures.size()].GetTexture());
+				}
+			});
+
+			World::BindSystem<BenchLifetime>(flecs::OnUpdate, "Bench Despawn", [](flecs::entity e, BenchLifetime& lifetime) {
+				lifetime.Remaining -= e.delta_time();
+
+				if (lifetime.Remaining <= 0.0f)
+				{
+					e.destruct();
+				}
+			});
+		}
+
+		if (sortingKeys)
+		{
+			// Keys are random over all 64 bits so every radix pass runs, only the sort itself is timed
+			World::BindSystemNoQuery(flecs::OnUpdate, "Bench Sort Keys", [this](flecs::iter& it) {
+				using Clock = std::chrono::steady_clock;
+
+				static std::mt19937_64 keyRandom(k_BenchSeed);
+				static Graphics::RenderQueue queue;
+				static uint32_t frameIndex = 0;
+
+				queue.Clear();
+				queue.Reserve(m_Count);
+				for (uint32_t i = 0; i < m_Count; i++)
+				{
+					queue.Submit(keyRandom(), i);
+				}
+
+				const Clock::time_point start = Clock::now();
+				queue.Sort();
+				const double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+				if (frameIndex >= m_WarmupFrames)
+				{
+					m_Report.AddSort(milliseconds, queue.GetLastSortPassCount());
+				}
+
+				frameIndex++;
+			});
+		}
+
+		// Runs after End Drawing, so the interval between two runs is the whole frame and the statistics are this frame's
+		World::BindSystemNoQuery(flecs::OnStore, "Bench Frame End", [this](flecs::iter& it) {
+			using Clock = std::chrono::steady_clock;
+
+			static Clock::time_point lastFrameEnd;
+			static uint32_t frameIndex = 0;
+
+			const Clock::time_point now = Clock::now();
+
+			if (frameIndex > 0 && frameIndex >= m_WarmupFrames)
+			{
+				const double milliseconds = std::chrono::duration<double, std::milli>(now - lastFrameEnd).count();
+				auto graphicsManager = Graphics::GraphicsManager::Instance();
+				m_Report.AddFrame(milliseconds, graphicsManager->GetRenderStatistics(), graphicsManager->GetGPUTimings());
+			}
+
+			lastFrameEnd = now;
+			frameIndex++;
+		});
+
+		BLD_INFO("Running {} with {} entities, {} warmup frames", GetSceneName(m_Scene), m_Count, m_WarmupFrames);
+	}
+
+	Game* CreateGameInstance() { return new BenchGame(); }
+} // namespace BladeEngine
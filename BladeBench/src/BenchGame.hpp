@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Core/Game.hpp"
+
+#include "BenchReport.hpp"
+
+namespace BladeEngine
+{
+    enum class BenchScene
+    {
+        // One texture, nothing moves, the best case for batching
+        Sprites,
+        // Sprite sheet frames swapped every few frames
+        Animated,
+        // Static labels, mostly served by the text layout cache
+        Text,
+        // Dynamic boxes falling onto a ground, physics sync and transform updates every frame
+        Physics,
+        // Static sprites spread over many textures, stresses batching and descriptor updates
+        Textures,
+        // A quarter of each of textures, animated, text and physics
+        Mixed,
+        // Dynamic boxes spawned and destroyed continuously, --count is the spawn rate per second
+        Spawn,
+        // Nothing is drawn, --count random keys are radix sorted through a RenderQueue every frame
+        SortKeys
+    };
+
+    /**
+     * Renders a parameterized scene for a fixed number of frames and reports CPU frame times and render
+     * statistics as JSON. Besides the engine's --headless, --frames and --size it takes
+     *
+     * --scene <sprites|animated|text|physics|textures|mixed|spawn|sortkeys>
+     * --count <entities>  bodies spawned per second for spawn, sort keys for sortkeys (100000 by default)
+     * --warmup <frames>    frames left out of the report while caches and uploads settle
+     * --mode <batched|instanced|bindless>
+     * --output <path>      the report is written here instead of stdout, - for stdout
+     *
+     * Logs go to stderr so stdout holds nothing but the report.
+     */
+    class BenchGame : public Game
+    {
+    public:
+        BenchGame();
+
+    private:
+        virtual void LoadGameResources() override;
+        virtual void UnloadGameResources() override;
+
+        virtual void SetupWorld() override;
+
+        void ParseCommandLine();
+
+    private:
+        BenchScene m_Scene = BenchScene::Sprites;
+        uint32_t m_Count = 1000;
+        bool m_CountGiven = false;
+        uint32_t m_WarmupFrames = 60;
+        std::string m_OutputPath;
+
+        BenchReport m_Report;
+    };
+}
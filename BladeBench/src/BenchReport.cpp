@@ -0,0 +1,253 @@
+#include "BenchReport.hpp"
+
+#include "Core/Log.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#if defined(_WIN32)
+	#define NOMINMAX
+	#include <windows.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+	#include <unistd.h>
+#endif
+
+namespace BladeEngine {
+
+	static uint64_t GetPeakResidentBytes()
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+		return counters.PeakWorkingSetSize;
+#else
+		struct rusage usage;
+		if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+	#if defined(__APPLE__)
+		return (uint64_t)usage.ru_maxrss;
+	#else
+		// Linux reports kilobytes
+		return (uint64_t)usage.ru_maxrss * 1024;
+	#endif
+#endif
+	}
+
+	static uint64_t GetCurrentResidentBytes()
+	{
+#if defined(_WIN32)
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+		return counters.WorkingSetSize;
+#elif defined(__linux__)
+		std::ifstream statm("/proc/self/statm");
+		uint64_t totalPages = 0, residentPages = 0;
+		if (!(statm >> totalPages >> residentPages)) return 0;
+		return residentPages * (uint64_t)sysconf(_SC_PAGESIZE);
+#else
+		return 0;
+#endif
+	}
+
+	void BenchReport::AddFrame(double frameMilliseconds, const Graphics::RenderStatistics& statistics, const Graphics::GPUTimings& gpuTimings)
+	{
+		m_FrameMilliseconds.push_back(frameMilliseconds);
+		m_Statistics.push_back(statistics);
+		m_GPUTimings.push_back(gpuTimings);
+	}
+
+	void BenchReport::AddSort(double sortMilliseconds, uint32_t passCount)
+	{
+		m_SortMilliseconds.push_back(sortMilliseconds);
+		m_SortPassCount = passCount;
+	}
+
+	double BenchReport::Percentile(const std::vector<double>& sorted, double percentile)
+	{
+		if (sorted.empty()) return 0.0;
+
+		size_t rank = (size_t)std::ceil(percentile / 100.0 * sorted.size());
+		return sorted[std::min(std::max(rank, (size_t)1), sorted.size()) - 1];
+	}
+
+	template<typename T>
+	void BenchReport::WriteStatistic(std::ostream& stream, const char* name, T Graphics::RenderStatistics::* member, bool last) const
+	{
+		double sum = 0.0, max = 0.0;
+		for (const Graphics::RenderStatistics& statistics : m_Statistics)
+		{
+			double value = (double)(statistics.*member);
+			sum += value;
+			max = std::max(max, value);
+		}
+
+		double mean = m_Statistics.empty() ? 0.0 : sum / m_Statistics.size();
+
+		stream << "    \"" << name << "\": { \"mean\": " << mean << ", \"max\": " << max << " }" << (last ? "\n" : ",\n");
+	}
+
+	void BenchReport::WriteGPUTimings(std::ostream& stream) const
+	{
+		const bool available = !m_GPUTimings.empty() && m_GPUTimings.back().Available;
+
+		stream << "  \"gpu\": {\n";
+		stream << "    \"available\": " << (available ? "true" : "false");
+
+		if (!available)
+		{
+			stream << "\n  },\n";
+			return;
+		}
+
+		std::vector<double> frameMilliseconds;
+		for (const Graphics::GPUTimings& timings : m_GPUTimings)
+		{
+			// The first frames of a run have nothing resolved yet
+			if (!timings.Scopes.empty()) frameMilliseconds.push_back(timings.FrameMilliseconds);
+		}
+		std::sort(frameMilliseconds.begin(), frameMilliseconds.end());
+
+		double sum = 0.0;
+		for (double milliseconds : frameMilliseconds) sum += milliseconds;
+
+		stream << ",\n    \"frameMs\": { \"mean\": " << (frameMilliseconds.empty() ? 0.0 : sum / frameMilliseconds.size())
+			<< ", \"p50\": " << Percentile(frameMilliseconds, 50.0)
+			<< ", \"p95\": " << Percentile(frameMilliseconds, 95.0)
+			<< ", \"max\": " << (frameMilliseconds.empty() ? 0.0 : frameMilliseconds.back()) << " },\n";
+
+		stream << "    \"scopesMs\": {";
+		const std::vector<Graphics::GPUScopeTiming>& scopes = m_GPUTimings.back().Scopes;
+		for (size_t i = 0; i < scopes.size(); i++)
+		{
+			double scopeSum = 0.0, scopeMax = 0.0;
+			for (const Graphics::GPUTimings& timings : m_GPUTimings)
+			{
+				double milliseconds = timings.GetScopeMilliseconds(scopes[i].Name);
+				scopeSum += milliseconds;
+				scopeMax = std::max(scopeMax, milliseconds);
+			}
+
+			stream << (i == 0 ? "\n" : ",\n") << "      \"" << scopes[i].Name << "\": { \"mean\": "
+				<< scopeSum / m_GPUTimings.size() << ", \"max\": " << scopeMax << " }";
+		}
+		stream << "\n    }";
+
+		const Graphics::GPUTimings& last = m_GPUTimings.back();
+		if (last.PipelineStatisticsAvailable)
+		{
+			stream << ",\n    \"pipelineStatistics\": {\n";
+			stream << "      \"inputAssemblyVertices\": " << last.InputAssemblyVertices << ",\n";
+			stream << "      \"inputAssemblyPrimitives\": " << last.InputAssemblyPrimitives << ",\n";
+			stream << "      \"vertexShaderInvocations\": " << last.VertexShaderInvocations << ",\n";
+			stream << "      \"clippingPrimitives\": " << last.ClippingPrimitives << ",\n";
+			stream << "      \"fragmentShaderInvocations\": " << last.FragmentShaderInvocations << "\n";
+			stream << "    }";
+		}
+
+		stream << "\n  },\n";
+	}
+
+	void BenchReport::WriteSortTimings(std::ostream& stream) const
+	{
+		if (m_SortMilliseconds.empty()) return;
+
+		std::vector<double> sorted = m_SortMilliseconds;
+		std::sort(sorted.begin(), sorted.end());
+
+		double sum = 0.0;
+		for (double milliseconds : sorted) sum += milliseconds;
+
+		stream << "  \"sortMs\": {\n";
+		stream << "    \"passes\": " << m_SortPassCount << ",\n";
+		stream << "    \"mean\": " << sum / sorted.size() << ",\n";
+		stream << "    \"min\": " << sorted.front() << ",\n";
+		stream << "    \"p50\": " << Percentile(sorted, 50.0) << ",\n";
+		stream << "    \"p95\": " << Percentile(sorted, 95.0) << ",\n";
+		stream << "    \"max\": " << sorted.back() << "\n";
+		stream << "  },\n";
+	}
+
+	void BenchReport::WriteJSON(const BenchRun& run, std::ostream& stream) const
+	{
+		using Graphics::RenderStatistics;
+
+		std::vector<double> sorted = m_FrameMilliseconds;
+		std::sort(sorted.begin(), sorted.end());
+
+		double sum = 0.0;
+		for (double milliseconds : sorted) sum += milliseconds;
+
+		const double mean = sorted.empty() ? 0.0 : sum / sorted.size();
+
+		uint64_t transientMax = 0;
+		for (const RenderStatistics& statistics : m_Statistics)
+		{
+			transientMax = std::max(transientMax, statistics.TransientMemoryUsed);
+		}
+
+		stream << "{\n";
+		stream << "  \"scene\": \"" << run.Scene << "\",\n";
+		stream << "  \"count\": " << run.Count << ",\n";
+		stream << "  \"frames\": " << sorted.size() << ",\n";
+		stream << "  \"warmupFrames\": " << run.WarmupFrames << ",\n";
+		stream << "  \"spriteRenderMode\": \"" << run.SpriteRenderMode << "\",\n";
+		stream << "  \"headless\": " << (run.Headless ? "true" : "false") << ",\n";
+		stream << "  \"resolution\": [" << run.Width << ", " << run.Height << "],\n";
+
+		stream << "  \"frameTimeMs\": {\n";
+		stream << "    \"mean\": " << mean << ",\n";
+		stream << "    \"min\": " << (sorted.empty() ? 0.0 : sorted.front()) << ",\n";
+		stream << "    \"p50\": " << Percentile(sorted, 50.0) << ",\n";
+		stream << "    \"p90\": " << Percentile(sorted, 90.0) << ",\n";
+		stream << "    \"p95\": " << Percentile(sorted, 95.0) << ",\n";
+		stream << "    \"p99\": " << Percentile(sorted, 99.0) << ",\n";
+		stream << "    \"max\": " << (sorted.empty() ? 0.0 : sorted.back()) << "\n";
+		stream << "  },\n";
+
+		stream << "  \"perFrame\": {\n";
+		WriteStatistic(stream, "drawCalls", &RenderStatistics::DrawCalls, false);
+		WriteStatistic(stream, "pipelineBinds", &RenderStatistics::PipelineBinds, false);
+		WriteStatistic(stream, "pipelineVariantsCompiled", &RenderStatistics::PipelineVariantsCompiled, false);
+		WriteStatistic(stream, "spriteBatches", &RenderStatistics::SpriteBatches, false);
+		WriteStatistic(stream, "sprites", &RenderStatistics::Sprites, false);
+		WriteStatistic(stream, "strings", &RenderStatistics::Strings, false);
+		WriteStatistic(stream, "glyphs", &RenderStatistics::Glyphs, false);
+		WriteStatistic(stream, "textLayoutCacheMisses", &RenderStatistics::TextLayoutCacheMisses, false);
+		WriteStatistic(stream, "textLayoutMs", &RenderStatistics::TextLayoutMilliseconds, false);
+		WriteStatistic(stream, "cullingCandidates", &RenderStatistics::CullingCandidates, false);
+		WriteStatistic(stream, "culled", &RenderStatistics::Culled, false);
+		WriteStatistic(stream, "descriptorCacheMisses", &RenderStatistics::DescriptorCacheMisses, false);
+		WriteStatistic(stream, "descriptorSetAllocations", &RenderStatistics::DescriptorSetAllocations, false);
+		WriteStatistic(stream, "descriptorWrites", &RenderStatistics::DescriptorWrites, false);
+		WriteStatistic(stream, "uploads", &RenderStatistics::Uploads, false);
+		WriteStatistic(stream, "uploadedBytes", &RenderStatistics::UploadedBytes, true);
+		stream << "  },\n";
+
+		WriteGPUTimings(stream);
+		WriteSortTimings(stream);
+
+		stream << "  \"memory\": {\n";
+		stream << "    \"residentBytes\": " << GetCurrentResidentBytes() << ",\n";
+		stream << "    \"peakResidentBytes\": " << GetPeakResidentBytes() << ",\n";
+		stream << "    \"transientBytesMax\": " << transientMax << "\n";
+		stream << "  }\n";
+		stream << "}\n";
+	}
+
+	bool BenchReport::SaveJSON(const BenchRun& run, const std::string& path) const
+	{
+		std::ofstream file(path, std::ios::trunc);
+		if (!file)
+		{
+			BLD_ERROR("Failed to open {} for writing", path);
+			return false;
+		}
+
+		WriteJSON(run, file);
+
+		return file.good();
+	}
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Graphics/RenderStatistics.hpp"
+#include "Graphics/GPUTimings.hpp"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace BladeEngine {
+
+	// How a benchmark run was set up, written at the top of the report so runs can be matched before diffing
+	struct BenchRun
+	{
+		std::string Scene;
+		uint32_t Count = 0;
+		uint32_t WarmupFrames = 0;
+		std::string SpriteRenderMode;
+		bool Headless = false;
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+	};
+
+	// Collects the CPU frame times and render statistics of the measured frames and writes them out as JSON.
+	// Keys and units stay fixed between releases, so two reports of the same run can be diffed field by field
+	class BenchReport
+	{
+	public:
+		void AddFrame(double frameMilliseconds, const Graphics::RenderStatistics& statistics, const Graphics::GPUTimings& gpuTimings);
+		// RenderQueue::Sort timings of the sortkeys scene, reported only when there are any
+		void AddSort(double sortMilliseconds, uint32_t passCount);
+
+		size_t GetFrameCount() const { return m_FrameMilliseconds.size(); }
+
+		void WriteJSON(const BenchRun& run, std::ostream& stream) const;
+		bool SaveJSON(const BenchRun& run, const std::string& path) const;
+
+	private:
+		// Nearest rank over the sorted frame times, percentile in [0..100]
+		static double Percentile(const std::vector<double>& sorted, double percentile);
+
+		template<typename T>
+		void WriteStatistic(std::ostream& stream, const char* name, T Graphics::RenderStatistics::* member, bool last) const;
+
+		void WriteGPUTimings(std::ostream& stream) const;
+		void WriteSortTimings(std::ostream& stream) const;
+
+	private:
+		std::vector<double> m_FrameMilliseconds;
+		std::vector<Graphics::RenderStatistics> m_Statistics;
+		// Trail the frame they were sampled on by the frames in flight, which evens out over a run
+		std::vector<Graphics::GPUTimings> m_GPUTimings;
+
+		std::vector<double> m_SortMilliseconds;
+		uint32_t m_SortPassCount = 0;
+	};
+
+}
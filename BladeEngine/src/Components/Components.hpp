@@ -3,6 +3,7 @@
 #include "../Core/Vec.hpp"
 #include "../Physics/Physics2D.hpp"
 
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <string>
@@ -38,6 +39,8 @@ namespace BladeEngine
     struct DepthSorting
     {
         float ZPos = 0.0f;
+        // Sprites of a lower layer are drawn first, ZPos only orders sprites within a layer
+        uint8_t Layer = 0;
     };
 
     struct LocalToWorld
@@ -45,6 +48,14 @@ namespace BladeEngine
         float Matrix[16];
     };
 
+    // Position and Rotation as of the fixed step before the last one. Entities moved by fixed systems
+    // are drawn between the two, so they move smoothly when frames and fixed steps do not line up
+    struct TransformInterpolation
+    {
+        Vec2 PreviousPosition;
+        float PreviousAngle = 0.0f;
+    };
+
     struct SpriteRenderer
     {
         Graphics::Texture2D* Texture = nullptr;
@@ -75,6 +86,8 @@ namespace BladeEngine
     {
         Graphics::Font* Font;
         std::string Text;
+        // Draws a dark outline around the glyphs
+        bool Outline = false;
     };
 
     struct Rigidbody2D
@@ -87,6 +100,11 @@ namespace BladeEngine
         class BaseBodyContactListener* ContactListener = nullptr;
 
         b2Body* RuntimeBody = nullptr;
+
+        // Position and Rotation as of the last sync with the body. The physics systems only push
+        // components that no longer match into Box2D, and only pull bodies Box2D moved
+        Vec2 SyncedPosition = Vec2(0.0f, 0.0f);
+        float SyncedAngle = 0.0f;
     };
 
     enum PhysicsLayer : uint16_t
@@ -42,6 +42,7 @@ public:
     float Aspect();
     float GetWidth();
     float GetHeight();
+    CameraType GetType() const { return type; }
     glm::mat4 GetProjectionMatrix();
     glm::mat4 GetViewMatrix();
 
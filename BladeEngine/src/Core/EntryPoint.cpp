@@ -3,10 +3,13 @@
 #include "Game.hpp"
 #include "Log.hpp"
 
-int main ()
+int main (int argc, char** argv)
 {
     BladeEngine::Log::Init();
 
+    // Read by the Game constructor, which runs inside CreateGameInstance
+    BladeEngine::Game::SetCommandLine(argc, argv);
+
     BladeEngine::Game* game = BladeEngine::CreateGameInstance();
 
     game->Run();
@@ -1,12 +1,15 @@
 #include "Game.hpp"
 
 #include "Time.hpp"
+#include "JobSystem.hpp"
+#include "Profiler.hpp"
 #include "../ECS/World.hpp"
 #include "../Components/Components.hpp"
 #include "Log.hpp"
 #include "../Graphics/GraphicsManager.hpp"
 #include "../Physics/Physics2D.hpp"
 #include "../Graphics/Mesh.hpp"
+#include "../Graphics/TextureLoader.hpp"
 
 #include "../Audio/BladeAudio.hpp"
 
@@ -14,11 +17,17 @@
 
 #include <glm/gtc/type_ptr.hpp>
 
+#include <cstdlib>
+#include <cstdio>
+#include <vector>
+
 namespace BladeEngine
 {
     Game* Game::s_Instance;
+    std::vector<std::string> Game::s_CommandLine;
 
-    Game::Game()
+    Game::Game(const GameSpecification& specification)
+        : m_Specification(specification)
     {
         if (s_Instance)
         {
@@ -29,16 +38,25 @@ namespace BladeEngine
 
         s_Instance = this;
 
-        m_Window = new Window(1920, 1080, "Blade Game");
+        BLD_PROFILE_THREAD("Main");
+
+        ApplyCommandLine(m_Specification);
+
+        m_Window = new Window(m_Specification.Width, m_Specification.Height, m_Specification.Title, m_Specification.Headless);
+
+        JobSystem::Init();
 
         Graphics::GraphicsManager::Instance()->Init(m_Window);
+        Graphics::TextureLoader::Init();
         AudioManager::Init();
     }
 
     Game::~Game()
     {
+        Graphics::TextureLoader::Shutdown();
         Graphics::GraphicsManager::Instance()->Shutdown();
         AudioManager::Shutdown();
+        JobSystem::Shutdown();
         delete m_Window;
     }
     
@@ -47,8 +65,69 @@ namespace BladeEngine
         s_Instance->m_ShouldExit = true;
     }
 
+    void Game::SetCommandLine(int argc, char** argv)
+    {
+        s_CommandLine.assign(argv + 1, argv + argc);
+    }
+
+    void Game::ApplyCommandLine(GameSpecification& specification)
+    {
+        for (size_t i = 0; i < s_CommandLine.size(); i++)
+        {
+            const std::string& argument = s_CommandLine[i];
+            const bool hasValue = i + 1 < s_CommandLine.size();
+
+            if (argument == "--headless")
+            {
+                specification.Headless = true;
+            }
+            else if (argument == "--frames" && hasValue)
+            {
+                specification.FrameLimit = (uint32_t)strtoul(s_CommandLine[++i].c_str(), nullptr, 10);
+            }
+            else if (argument == "--capture" && hasValue)
+            {
+                specification.CapturePath = s_CommandLine[++i];
+            }
+            else if (argument == "--trace" && hasValue)
+            {
+                specification.TracePath = s_CommandLine[++i];
+            }
+            else if (argument == "--size" && hasValue)
+            {
+                uint32_t width, height;
+                if (sscanf(s_CommandLine[++i].c_str(), "%ux%u", &width, &height) == 2 && width > 0 && height > 0)
+                {
+                    specification.Width = width;
+                    specification.Height = height;
+                }
+                else
+                {
+                    BLD_CORE_WARN("Ignoring --size {}, expected <width>x<height>", s_CommandLine[i]);
+                }
+            }
+            // Anything else belongs to the game, see GetCommandLine
+        }
+
+        if (!specification.CapturePath.empty() && (!specification.Headless || specification.FrameLimit == 0))
+        {
+            BLD_CORE_WARN("Frame capture needs a headless run with a frame limit, {} will not be written",
+                specification.CapturePath);
+        }
+
+#ifndef BLADE_PROFILE
+        if (!specification.TracePath.empty())
+        {
+            BLD_CORE_WARN("The engine was built without BLADE_PROFILE, the trace {} will be empty",
+                specification.TracePath);
+        }
+#endif
+    }
+
     void Game::LoadResources()
     {
+        BLD_PROFILE_FUNCTION();
+
         LoadCoreResources();
         LoadGameResources();
     }
@@ -69,76 +148,44 @@ namespace BladeEngine
         Graphics::Mesh::UnloadDefaultMeshes();
     }
 
-    // TODO(Pedro): Probably not the best for this, should change later
-    void PopulatePhysicsWorld(flecs::entity e, const Position& pos, Rigidbody2D& rb)
+    void StorePreviousTransform(const Position& pos, const Rotation& rot, TransformInterpolation& interpolation)
     {
-        b2World* physicsWorld = (b2World*)Physics2D::GetPhysicsWorldHandle();
-
-        b2BodyDef bodyDef;
-        bodyDef.type = (b2BodyType)rb.Type;
-        bodyDef.position.Set(pos.Value.X, pos.Value.Y);
-        bodyDef.fixedRotation = rb.LockRotation;
-
-        rb.RuntimeBody = physicsWorld->CreateBody(&bodyDef);
-
-        if (rb.ContactListener)
-        {
-            rb.ContactListener->SetEntity(e);
-            rb.RuntimeBody->GetUserData().pointer = (uintptr_t)rb.ContactListener;
-        }
-
-        if (e.has<BoxCollider2D>())
-        {
-            BoxCollider2D* collider = e.get_mut<BoxCollider2D>();
-
-            b2PolygonShape shape;
-            shape.SetAsBox(collider->HalfExtents.X, collider->HalfExtents.Y);
-
-            b2FixtureDef fixtureDef;
-            fixtureDef.shape = &shape;
-            fixtureDef.density = collider->Material.Density;
-            fixtureDef.friction = collider->Material.Friction;
-            fixtureDef.restitution = collider->Material.Restitution;
-            fixtureDef.restitutionThreshold = collider->Material.RestitutionThreshold;
-
-            fixtureDef.filter.categoryBits = collider->CollisionLayers;
-            fixtureDef.filter.maskBits = collider->CollisionMask;
-            fixtureDef.filter.groupIndex = collider->GroupId;
-
-            fixtureDef.isSensor = collider->IsSensor;
-
-            rb.RuntimeBody->CreateFixture(&fixtureDef);
-        }
+        interpolation.PreviousPosition = pos.Value;
+        interpolation.PreviousAngle = rot.Angle;
+    }
 
-        if (e.has<CircleCollider2D>())
+    void PrePhysicsStep(flecs::iter& it, const Position* pos, const Rotation* rot, Rigidbody2D* rb)
+    {
+        for (auto i : it)
         {
-            CircleCollider2D* collider = e.get_mut<CircleCollider2D>();
+            // Spawned since the last Sync Physics Bodies
+            if (!rb[i].RuntimeBody)
+            {
+                continue;
+            }
 
-            b2CircleShape shape;
-            shape.m_radius = collider->Radius;
+            const float angle = rot ? rot[i].Angle : rb[i].SyncedAngle;
 
-            b2FixtureDef fixtureDef;
-            fixtureDef.shape = &shape;
-            fixtureDef.density = collider->Material.Density;
-            fixtureDef.friction = collider->Material.Friction;
-            fixtureDef.restitution = collider->Material.Restitution;
-            fixtureDef.restitutionThreshold = collider->Material.RestitutionThreshold;
+            // SetTransform touches the broadphase, so only bodies a system moved since the last sync pay for it
+            if (pos[i].Value.X == rb[i].SyncedPosition.X && pos[i].Value.Y == rb[i].SyncedPosition.Y &&
+                angle == rb[i].SyncedAngle)
+            {
+                continue;
+            }
 
-            fixtureDef.filter.categoryBits = collider->CollisionLayers;
-            fixtureDef.filter.maskBits = collider->CollisionMask;
-            fixtureDef.filter.groupIndex = collider->GroupId;
+            rb[i].RuntimeBody->SetTransform({ pos[i].Value.X, pos[i].Value.Y }, angle);
 
-            fixtureDef.isSensor = collider->IsSensor;
+            if (rb[i].Type == Rigidbody2D::BodyType::Dynamic)
+            {
+                // A sleeping body moved somewhere else has to fall again
+                rb[i].RuntimeBody->SetAwake(true);
+            }
 
-            rb.RuntimeBody->CreateFixture(&fixtureDef);
+            rb[i].SyncedPosition = pos[i].Value;
+            rb[i].SyncedAngle = angle;
         }
     }
 
-    void PrePhysicsStep(const Position& pos, Rigidbody2D& rb)
-    {
-        rb.RuntimeBody->SetTransform({ pos.Value.X, pos.Value.Y }, 0.0f);
-    }
-
     void PhysicsStep(flecs::iter it)
     {
         b2World* physicsWorld = (b2World*)Physics2D::GetPhysicsWorldHandle();
@@ -146,24 +193,73 @@ namespace BladeEngine
         physicsWorld->Step(it.delta_time(), Physics2D::GetVelocityIterations(), Physics2D::GetPositionIterations());
     }
 
-    void PostPhysicsStep(Position& pos, const Rigidbody2D& rb)
+    void PostPhysicsStep(flecs::iter& it, Position* pos, Rotation* rot, Rigidbody2D* rb)
     {
-        pos.Value.X = rb.RuntimeBody->GetPosition().x;
-        pos.Value.Y = rb.RuntimeBody->GetPosition().y;
+        bool pulled = false;
+
+        for (auto i : it)
+        {
+            const b2Body* body = rb[i].RuntimeBody;
+            if (!body)
+            {
+                continue;
+            }
+
+            // Static and sleeping bodies did not move, kinematic ones only when something gave them a velocity
+            const bool moved = body->GetType() == b2_dynamicBody ? body->IsAwake() :
+                body->GetType() == b2_kinematicBody &&
+                (body->GetLinearVelocity().LengthSquared() > 0.0f || body->GetAngularVelocity() != 0.0f);
+
+            if (!moved)
+            {
+                continue;
+            }
+
+            pos[i].Value.X = body->GetPosition().x;
+            pos[i].Value.Y = body->GetPosition().y;
+            rb[i].SyncedPosition = pos[i].Value;
+            // Kept without a Rotation too, Pre Physics Step pushes it back when only the position changed
+            rb[i].SyncedAngle = body->GetAngle();
+
+            if (rot)
+            {
+                rot[i].Angle = rb[i].SyncedAngle;
+            }
+
+            pulled = true;
+        }
+
+        // Leaves the table's components unchanged for change detection when no body in it moved
+        if (!pulled)
+        {
+            it.skip();
+        }
     }
 
     void TransformStep(flecs::iter& it, 
         const Position* localPos, const Rotation* localRot, const Scale* localScale,
-        LocalToWorld* transform, const LocalToWorld* parentTransform, const DepthSorting* depth)
+        LocalToWorld* transform, const LocalToWorld* parentTransform, const DepthSorting* depth,
+        const TransformInterpolation* interpolation)
     {
         auto parentMat = parentTransform ? glm::make_mat4(parentTransform->Matrix) : glm::mat4(1);
 
+        const float alpha = Time::InterpolationAlpha();
+
         for (auto i : it)
         {
+            Vec2 position = localPos[i].Value;
+            float angle = localRot[i].Angle;
+
+            if (interpolation)
+            {
+                position = interpolation[i].PreviousPosition + (position - interpolation[i].PreviousPosition) * alpha;
+                angle = interpolation[i].PreviousAngle + (angle - interpolation[i].PreviousAngle) * alpha;
+            }
+
             auto mat = glm::scale(
                 glm::rotate(
-                    glm::translate(glm::mat4(1), glm::vec3(localPos[i].Value.X, localPos[i].Value.Y, depth ? depth->ZPos : 0.0f)),
-                    localRot[i].Angle,
+                    glm::translate(glm::mat4(1), glm::vec3(position.X, position.Y, depth ? depth->ZPos : 0.0f)),
+                    angle,
                     glm::vec3(0, 0, 1)),
                 glm::vec3(localScale[i].Value.X, localScale[i].Value.Y, 1));
 
@@ -201,7 +297,7 @@ namespace BladeEngine
 
     void EndDrawing(flecs::iter it) { Graphics::GraphicsManager::Instance()->EndDrawing(); }
 
-    void DrawSprite(const SpriteRenderer& sprite, const LocalToWorld& transform)
+    void DrawSprite(const SpriteRenderer& sprite, const LocalToWorld& transform, const DepthSorting* depth)
     {
         Graphics::GraphicsManager::Instance()->DrawSprite(
             sprite.Texture,
@@ -211,65 +307,118 @@ namespace BladeEngine
                 sprite.FlipY ? sprite.UVDimensions.Y + sprite.UVStartPos.Y : sprite.UVStartPos.Y,
                 sprite.FlipX ? -sprite.UVDimensions.X : sprite.UVDimensions.X, 
                 sprite.FlipY ? -sprite.UVDimensions.Y : sprite.UVDimensions.Y
-            )
+            ),
+            depth ? depth->Layer : 0
         );
     }
 
+    void DrawSprites(flecs::iter& it, const SpriteRenderer* sprites, const LocalToWorld* transforms, const DepthSorting* depths)
+    {
+        static std::vector<uint8_t> visibility;
+        visibility.resize(it.count());
+
+        // LocalToWorld is a plain float[16], so the table's column is one contiguous run of matrices
+        Graphics::GraphicsManager::Instance()->GetVisibilityCuller().CullBatch(
+            transforms[0].Matrix, it.count(), sizeof(LocalToWorld) / sizeof(float),
+            Graphics::VisibilityCuller::QuadBounds, visibility.data());
+
+        for (auto i : it)
+        {
+            if (visibility[i])
+            {
+                DrawSprite(sprites[i], transforms[i], depths ? &depths[i] : nullptr);
+            }
+        }
+    }
+
     void DrawString(const TextRenderer& text, const LocalToWorld& transform)
     {
-        Graphics::GraphicsManager::Instance()->DrawString(
-            text.Text, text.Font, glm::make_mat4(transform.Matrix));
+        auto graphicsManager = Graphics::GraphicsManager::Instance();
+        glm::mat4 matrix = glm::make_mat4(transform.Matrix);
+
+        if (!graphicsManager->GetVisibilityCuller().IsVisible(matrix, text.Font->GetConservativeBounds(text.Text)))
+            return;
+
+        graphicsManager->DrawString(text.Text, text.Font, matrix, text.Outline);
     }
 
     void Game::Run()
     {
+        const bool trace = !m_Specification.TracePath.empty();
+        if (trace)
+        {
+            Profiler::BeginSession();
+        }
+
         BLD_CORE_DEBUG("Loading resources...");
 
         LoadResources();
 
         BLD_CORE_DEBUG("Game started Running!!");
 
-        Time::Init();
+        Time::Init(m_Specification.FixedUpdateRate, m_Specification.MaxFixedSteps);
+        World::Init();
+        // Bodies are created, rebuilt and destroyed by observers on the physics components from here on
         Physics2D::Init();
 
-        // Physics World Setup
-        World::GetECSWorldHandle()->system<const Position, Rigidbody2D>("Populate Physics World")
-            .kind(flecs::OnStart)
-            .each(PopulatePhysicsWorld);
-        //World::BindSystem<const Position, Rigidbody2D>(flecs::OnStart, "Populate physics world", PopulatePhysicsWorld);
-
+        // Fixed Step
+        World::BindFixedSystem<const Position, const Rotation, TransformInterpolation>(
+            flecs::OnLoad, "Store Previous Transform", StorePreviousTransform);
 
         // Physics World Update
-        World::GetECSWorldHandle()->system<const Position, Rigidbody2D>("Pre Physics Step")
+        World::GetECSWorldHandle()->system<const Position, const Rotation, Rigidbody2D>("Pre Physics Step")
+            .term_at(2).optional()
             .kind(flecs::PostUpdate)
-            .each(PrePhysicsStep);
+            .run(World::RunSystem)
+            .iter(PrePhysicsStep)
+            .add(World::GetFixedStepTag());
         //World::BindSystem<const Position, Rigidbody2D>(flecs::PostUpdate, "Pre Physics Step", PrePhysicsStep);
-        World::BindSystemNoQuery(flecs::PostUpdate, "Physics Step", PhysicsStep);
-        World::GetECSWorldHandle()->system<Position, const Rigidbody2D>("Post Physics Step")
+        World::GetECSWorldHandle()->system("Physics Step")
+            .kind(flecs::PostUpdate)
+            .run(World::RunSystem)
+            .iter(PhysicsStep)
+            .add(World::GetFixedStepTag());
+        World::GetECSWorldHandle()->system<Position, Rotation, Rigidbody2D>("Post Physics Step")
+            .term_at(2).optional()
             .kind(flecs::PostUpdate)
-            .each(PostPhysicsStep);
+            .run(World::RunSystem)
+            .iter(PostPhysicsStep)
+            .add(World::GetFixedStepTag());
         //World::BindSystem<Position, const Rigidbody2D>(flecs::PostUpdate, "Post Physics Step", PostPhysicsStep);
 
         World::GetECSWorldHandle()->system<
             const Position, const Rotation, const Scale,
-            LocalToWorld, const LocalToWorld, const DepthSorting>("Transform Step")
+            LocalToWorld, const LocalToWorld, const DepthSorting, const TransformInterpolation>("Transform Step")
             .term_at(5).parent().cascade().optional()
             .term_at(6).optional()
+            .term_at(7).optional()
             .kind(flecs::PostUpdate)
+            .run(World::RunSystem)
             .iter(TransformStep);
 
         World::BindSystem<SpriteAnimator, SpriteRenderer>(flecs::PostUpdate, "Animate Sprite", AnimateSprite);
 
         // Render
         World::BindSystemNoQuery(flecs::PreStore, "Start Drawing", BeginDrawing);
-        World::BindSystem<const SpriteRenderer, const LocalToWorld>(flecs::PreStore, "Draw Sprite", DrawSprite);
+        World::GetECSWorldHandle()->system<const SpriteRenderer, const LocalToWorld, const DepthSorting>("Draw Sprite")
+            .term_at(3).optional()
+            .kind(flecs::PreStore)
+            .run(World::RunSystem)
+            .iter(DrawSprites);
         World::BindSystem<const TextRenderer, const LocalToWorld>(flecs::PreStore, "Draw Text", DrawString);
         World::BindSystemNoQuery(flecs::PreStore, "End Drawing", EndDrawing);
 
         SetupWorld();
 
+        const bool capture = m_Specification.Headless && m_Specification.FrameLimit > 0 &&
+            !m_Specification.CapturePath.empty();
+
+        uint32_t frameCount = 0;
+
         while (!m_ShouldExit)
         {
+            BLD_PROFILE_FRAME();
+
             if (m_Window->SwapchainNeedsResize())
             {
                 Graphics::GraphicsManager::Instance()->RecreateSwapchain(m_Window->GetWidth(), m_Window->GetHeight());
@@ -277,15 +426,58 @@ namespace BladeEngine
                 m_Window->GotResized();
             }
 
-            m_Window->InputTick();
-            
+            {
+                BLD_PROFILE_SCOPE("Input");
+                m_Window->InputTick();
+            }
+
             Time::Update();
 
+            {
+                BLD_PROFILE_SCOPE("Fixed Update");
+                while (Time::ConsumeFixedStep())
+                {
+                    World::FixedStep(Time::FixedDeltaTime());
+                }
+            }
+
+            const bool lastFrame = m_Specification.FrameLimit > 0 && frameCount + 1 >= m_Specification.FrameLimit;
+            if (lastFrame && capture)
+            {
+                Graphics::GraphicsManager::Instance()->RequestFrameCapture();
+            }
+
             World::Step(Time::DeltaTime());
+
+            frameCount++;
+
+            if (lastFrame)
+            {
+                m_ShouldExit = true;
+            }
+        }
+
+        if (capture)
+        {
+            Graphics::FrameCapture frame;
+            if (Graphics::GraphicsManager::Instance()->ReadCapturedFrame(frame) && frame.SaveAsPPM(m_Specification.CapturePath))
+            {
+                BLD_CORE_INFO("Wrote frame {} to {}", frameCount, m_Specification.CapturePath);
+            }
+            else
+            {
+                BLD_CORE_ERROR("Failed to capture frame {} to {}", frameCount, m_Specification.CapturePath);
+            }
         }
 
         Graphics::GraphicsManager::Instance()->WaitDeviceIdle();
 
+        if (trace)
+        {
+            Profiler::EndSession();
+            Profiler::WriteChromeTrace(m_Specification.TracePath);
+        }
+
         CleanUp();
     }
 
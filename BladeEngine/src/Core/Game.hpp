@@ -2,16 +2,49 @@
 
 #include "Window.hpp"
 
-extern int main();
+#include <string>
+#include <vector>
+
+extern int main(int argc, char** argv);
 
 namespace BladeEngine 
 {
 	class World;
 
+	/**
+	 * @brief Startup settings of a game, the command line can override them.
+	 * 
+	 * --headless           Headless = true
+	 * --frames <count>     FrameLimit = count
+	 * --capture <path>     CapturePath = path
+	 * --size <w>x<h>       Width = w, Height = h
+	 * --trace <path>       TracePath = path
+	 */
+	struct GameSpecification
+	{
+		std::string Title = "Blade Game";
+		uint32_t Width = 1920;
+		uint32_t Height = 1080;
+
+		// Renders into offscreen images without a window or swapchain, for machines with no display
+		bool Headless = false;
+		// The game exits on its own after this many frames, 0 runs until Exit is called
+		uint32_t FrameLimit = 0;
+		// The last frame of a FrameLimit run is read back and written here as a PPM, headless only
+		std::string CapturePath;
+		// The whole run is recorded by the CPU profiler and written here as a Chrome trace on exit
+		std::string TracePath;
+
+		// Fixed systems, physics included, simulate this many steps per second whatever the frame rate
+		uint32_t FixedUpdateRate = 60;
+		// Most fixed steps a single frame runs, frames slower than that slow the simulation down instead
+		uint32_t MaxFixedSteps = 8;
+	};
+
 	class Game 
 	{
 	public:
-  		Game();
+  		Game(const GameSpecification& specification = GameSpecification());
   		~Game();
 
 		/**
@@ -20,6 +53,18 @@ namespace BladeEngine
 		 */
   		static void Exit();
 
+		/**
+		 * @brief Arguments the game was started with, without the executable path.
+		 * 
+		 * The engine only consumes the ones listed on GameSpecification, the rest are left to the game.
+		 */
+		static const std::vector<std::string>& GetCommandLine() { return s_CommandLine; }
+
+		/**
+		 * @brief Settings the game is running with, after the command line was applied.
+		 */
+		const GameSpecification& GetSpecification() const { return m_Specification; }
+
 	private:
 		void LoadResources();
 		void UnloadResources();
@@ -35,14 +80,21 @@ namespace BladeEngine
   		void Run();
   		void CleanUp();
 
+		static void SetCommandLine(int argc, char** argv);
+		static void ApplyCommandLine(GameSpecification& specification);
+
 	private:
   		bool m_ShouldExit = false;
 
+		GameSpecification m_Specification;
+
   		Window *m_Window;
 
   		static Game *s_Instance;
 
-  		friend int ::main();
+		static std::vector<std::string> s_CommandLine;
+
+  		friend int ::main(int argc, char** argv);
 	};
 
 	extern Game *CreateGameInstance();
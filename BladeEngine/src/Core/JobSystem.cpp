@@ -0,0 +1,148 @@
+#include "JobSystem.hpp"
+
+#include "Base.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace BladeEngine
+{
+    uint32_t JobSystem::s_ThreadCount;
+
+    namespace
+    {
+        std::vector<std::thread> s_Workers;
+        std::deque<std::function<void()>> s_Jobs;
+
+        std::mutex s_Mutex;
+        std::condition_variable s_JobAvailable;
+        std::condition_variable s_JobsFinished;
+
+        // Queued plus running jobs
+        uint32_t s_PendingJobs = 0;
+        bool s_Stopping = false;
+    }
+
+    void JobSystem::Init(uint32_t threadCount)
+    {
+        if (threadCount == 0)
+        {
+            uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        s_ThreadCount = threadCount;
+        s_Stopping = false;
+
+        s_Workers.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; i++)
+        {
+            s_Workers.emplace_back(&JobSystem::WorkerLoop);
+        }
+
+        BLD_CORE_INFO("Job system started with {} worker threads", threadCount);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        Wait();
+
+        {
+            std::lock_guard<std::mutex> lock(s_Mutex);
+            s_Stopping = true;
+        }
+        s_JobAvailable.notify_all();
+
+        for (std::thread& worker : s_Workers)
+        {
+            worker.join();
+        }
+
+        s_Workers.clear();
+        s_ThreadCount = 0;
+    }
+
+    void JobSystem::Execute(std::function<void()> job)
+    {
+        BLD_CORE_ASSERT(!s_Workers.empty(), "Job system is not initialized");
+
+        {
+            std::lock_guard<std::mutex> lock(s_Mutex);
+            s_Jobs.push_back(std::move(job));
+            s_PendingJobs++;
+        }
+        s_JobAvailable.notify_one();
+    }
+
+    void JobSystem::Dispatch(uint32_t count, uint32_t groupSize, const std::function<void(uint32_t, uint32_t)>& job)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        groupSize = std::max(groupSize, 1u);
+
+        for (uint32_t begin = 0; begin < count; begin += groupSize)
+        {
+            uint32_t end = std::min(begin + groupSize, count);
+            Execute([job, begin, end]() { job(begin, end); });
+        }
+    }
+
+    void JobSystem::Wait()
+    {
+        std::unique_lock<std::mutex> lock(s_Mutex);
+        s_JobsFinished.wait(lock, []() { return s_PendingJobs == 0; });
+    }
+
+    bool JobSystem::IsBusy()
+    {
+        std::lock_guard<std::mutex> lock(s_Mutex);
+        return s_PendingJobs > 0;
+    }
+
+    void JobSystem::WorkerLoop()
+    {
+        BLD_PROFILE_THREAD("Worker");
+
+        while (true)
+        {
+            std::function<void()> job;
+
+            {
+                std::unique_lock<std::mutex> lock(s_Mutex);
+                s_JobAvailable.wait(lock, []() { return s_Stopping || !s_Jobs.empty(); });
+
+                if (s_Jobs.empty())
+                {
+                    return;
+                }
+
+                job = std::move(s_Jobs.front());
+                s_Jobs.pop_front();
+            }
+
+            {
+                BLD_PROFILE_SCOPE("Job");
+                job();
+            }
+
+            bool finished;
+            {
+                std::lock_guard<std::mutex> lock(s_Mutex);
+                finished = --s_PendingJobs == 0;
+            }
+
+            if (finished)
+            {
+                s_JobsFinished.notify_all();
+            }
+        }
+    }
+}
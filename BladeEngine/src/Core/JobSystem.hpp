@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace BladeEngine
+{
+    /**
+     * @brief Fixed pool of worker threads running fire and forget jobs.
+     * 
+     * Jobs must not touch the graphics API or the ECS world, hand their results back
+     * to the main thread and apply them there.
+     */
+    class JobSystem
+    {
+    public:
+        /**
+         * @brief Queues a job on the worker pool.
+         * 
+         * @param job function run on a worker thread.
+         */
+        static void Execute(std::function<void()> job);
+
+        /**
+         * @brief Splits [0, count) into groups of groupSize and runs each group as a job.
+         * 
+         * @param count number of items.
+         * @param groupSize items handled by one job.
+         * @param job called with the item range [begin, end) of its group.
+         */
+        static void Dispatch(uint32_t count, uint32_t groupSize, const std::function<void(uint32_t, uint32_t)>& job);
+
+        /**
+         * @brief Blocks until every queued job has finished.
+         * 
+         */
+        static void Wait();
+
+        /**
+         * @brief True while some queued job has not finished yet.
+         * 
+         */
+        static bool IsBusy();
+
+        inline static uint32_t GetThreadCount() { return s_ThreadCount; }
+
+    private:
+        /**
+         * @brief Starts the worker threads.
+         * 
+         * @param threadCount number of workers, 0 uses one less than the hardware threads.
+         */
+        static void Init(uint32_t threadCount = 0);
+        static void Shutdown();
+
+        static void WorkerLoop();
+
+    private:
+        static uint32_t s_ThreadCount;
+
+        friend class Game;
+    };
+}
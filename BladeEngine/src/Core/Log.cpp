@@ -8,9 +8,11 @@ namespace BladeEngine
 	std::shared_ptr<spdlog::logger> Log::s_CoreLogger;
 	std::shared_ptr<spdlog::logger> Log::s_ClientLogger;
 
+	static const char* s_LogPattern = "%^[%T] %n: %v%$";
+
 	void Log::Init()
 	{
-		spdlog::set_pattern("%^[%T] %n: %v%$");
+		spdlog::set_pattern(s_LogPattern);
 
 		s_CoreLogger = spdlog::stdout_color_mt("BladeEngine");
 		s_CoreLogger->set_level(spdlog::level::trace);
@@ -18,4 +20,16 @@ namespace BladeEngine
 		s_ClientLogger = spdlog::stdout_color_mt("Game");
 		s_ClientLogger->set_level(spdlog::level::trace);
 	}
+
+	void Log::RedirectToStderr()
+	{
+		auto sink = std::make_shared<spdlog::sinks::stderr_color_sink_mt>();
+		sink->set_pattern(s_LogPattern);
+
+		for (auto& logger : { s_CoreLogger, s_ClientLogger })
+		{
+			logger->sinks().clear();
+			logger->sinks().push_back(sink);
+		}
+	}
 }
\ No newline at end of file
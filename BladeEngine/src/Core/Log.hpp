@@ -11,6 +11,8 @@ namespace BladeEngine
 	{
 	public:
 		static void Init();
+		// Moves both loggers to stderr, for tools whose stdout carries their output
+		static void RedirectToStderr();
 
 		inline static const std::shared_ptr<spdlog::logger>& GetCoreLogger() { return s_CoreLogger; }
 		inline static const std::shared_ptr<spdlog::logger>& GetClientLogger() { return s_ClientLogger; }
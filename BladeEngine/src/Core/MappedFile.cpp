@@ -0,0 +1,136 @@
+#include "MappedFile.hpp"
+
+#include "Platform.hpp"
+
+#if defined(BLD_PLATFORM_WINDOWS)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace BladeEngine
+{
+
+#if defined(BLD_PLATFORM_WINDOWS)
+
+    MappedFile::MappedFile(const char* path)
+    {
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            return;
+        }
+
+        m_Data = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+        if (!m_Data)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return;
+        }
+
+        m_File = file;
+        m_Mapping = mapping;
+        m_Size = (uint64_t)size.QuadPart;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_Data)
+        {
+            UnmapViewOfFile(m_Data);
+            CloseHandle(m_Mapping);
+            CloseHandle(m_File);
+        }
+    }
+
+    void MappedFile::Prefetch(uint64_t offset, uint64_t size) const
+    {
+        if (!m_Data || offset >= m_Size)
+        {
+            return;
+        }
+
+        WIN32_MEMORY_RANGE_ENTRY range;
+        range.VirtualAddress = m_Data + offset;
+        range.NumberOfBytes = (SIZE_T)(size < m_Size - offset ? size : m_Size - offset);
+
+        PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+    }
+
+#else
+
+    MappedFile::MappedFile(const char* path)
+    {
+        int file = open(path, O_RDONLY);
+        if (file < 0)
+        {
+            return;
+        }
+
+        struct stat status;
+        if (fstat(file, &status) != 0 || status.st_size == 0)
+        {
+            close(file);
+            return;
+        }
+
+        void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file, 0);
+
+        // The mapping keeps its own reference to the file
+        close(file);
+
+        if (data == MAP_FAILED)
+        {
+            return;
+        }
+
+        m_Data = (uint8_t*)data;
+        m_Size = (uint64_t)status.st_size;
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_Data)
+        {
+            munmap(m_Data, (size_t)m_Size);
+        }
+    }
+
+    void MappedFile::Prefetch(uint64_t offset, uint64_t size) const
+    {
+        if (!m_Data || offset >= m_Size)
+        {
+            return;
+        }
+
+        // madvise wants a page aligned start
+        uint64_t pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+        uint64_t start = offset & ~(pageSize - 1);
+        uint64_t end = size < m_Size - offset ? offset + size : m_Size;
+
+        madvise(m_Data + start, (size_t)(end - start), MADV_WILLNEED);
+    }
+
+#endif
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BladeEngine
+{
+    /**
+     * @brief Whole file mapped into memory through the OS page cache.
+     * 
+     * Pages are mapped copy-on-write, writing through GetData never reaches the file.
+     */
+    class MappedFile
+    {
+    public:
+        /**
+         * @brief Maps the file, check IsValid afterwards.
+         * 
+         * @param path file to map.
+         */
+        MappedFile(const char* path);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief False when the file could not be opened or is empty.
+         * 
+         */
+        inline bool IsValid() const { return m_Data != nullptr; }
+
+        inline uint8_t* GetData() const { return m_Data; }
+        inline uint64_t GetSize() const { return m_Size; }
+
+        /**
+         * @brief Asks the OS to start reading a range in ahead of its first access.
+         * 
+         * @param offset first byte of the range.
+         * @param size bytes in the range, clamped to the end of the file.
+         */
+        void Prefetch(uint64_t offset, uint64_t size) const;
+
+    private:
+        uint8_t* m_Data = nullptr;
+        uint64_t m_Size = 0;
+
+        // File and mapping handles, only used on Windows
+        void* m_File = nullptr;
+        void* m_Mapping = nullptr;
+    };
+}
@@ -0,0 +1,256 @@
+#include "Profiler.hpp"
+
+#include "Log.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace BladeEngine
+{
+    std::atomic<bool> Profiler::s_Recording;
+
+    namespace
+    {
+        enum class ProfilerEventType : uint8_t { Zone, Frame };
+
+        struct ProfilerEvent
+        {
+            const char* Name;
+            uint64_t Start;
+            // Zone duration in nanoseconds, or the frame index of a frame marker
+            uint64_t Value;
+            ProfilerEventType Type;
+        };
+
+        // Filled by its own thread only. Blocks are linked and never moved, so the exporter can walk
+        // every event published before the count it read while the owner keeps appending
+        struct ProfilerEventBlock
+        {
+            static const size_t Capacity = 4096;
+
+            ProfilerEvent Events[Capacity];
+            ProfilerEventBlock* Next = nullptr;
+        };
+
+        struct ProfilerThreadBuffer
+        {
+            uint32_t ThreadID = 0;
+            std::string Name;
+
+            ProfilerEventBlock* Head = nullptr;
+            // Owner side
+            ProfilerEventBlock* Tail = nullptr;
+            size_t TailCount = 0;
+
+            // Events written so far, released after the event itself
+            std::atomic<uint64_t> Published{ 0 };
+
+            // Range of Published recorded by the last session
+            uint64_t SessionBegin = 0;
+            uint64_t SessionEnd = 0;
+
+            ~ProfilerThreadBuffer()
+            {
+                while (Head)
+                {
+                    ProfilerEventBlock* next = Head->Next;
+                    delete Head;
+                    Head = next;
+                }
+            }
+
+            void Push(const ProfilerEvent& event)
+            {
+                if (TailCount == ProfilerEventBlock::Capacity)
+                {
+                    ProfilerEventBlock* block = new ProfilerEventBlock();
+                    Tail->Next = block;
+                    Tail = block;
+                    TailCount = 0;
+                }
+
+                Tail->Events[TailCount++] = event;
+                Published.store(Published.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+            }
+        };
+
+        // Buffers outlive their threads so a trace can still be written after a worker exited
+        std::mutex s_BuffersMutex;
+        std::vector<std::unique_ptr<ProfilerThreadBuffer>> s_Buffers;
+
+        uint64_t s_SessionStart = 0;
+        // Frames are marked from the main thread only
+        uint64_t s_FrameIndex = 0;
+
+        thread_local ProfilerThreadBuffer* t_Buffer = nullptr;
+
+        ProfilerThreadBuffer* GetThreadBuffer()
+        {
+            if (!t_Buffer)
+            {
+                std::unique_ptr<ProfilerThreadBuffer> buffer = std::make_unique<ProfilerThreadBuffer>();
+                buffer->Head = buffer->Tail = new ProfilerEventBlock();
+
+                std::lock_guard<std::mutex> lock(s_BuffersMutex);
+                buffer->ThreadID = (uint32_t)s_Buffers.size() + 1;
+                buffer->Name = "Thread " + std::to_string(buffer->ThreadID);
+
+                // A buffer created during a session records from its first event on
+                buffer->SessionBegin = 0;
+                buffer->SessionEnd = UINT64_MAX;
+
+                t_Buffer = buffer.get();
+                s_Buffers.push_back(std::move(buffer));
+            }
+
+            return t_Buffer;
+        }
+
+        void WriteEscaped(FILE* file, const char* text)
+        {
+            for (; *text; text++)
+            {
+                if (*text == '"' || *text == '\\') fputc('\\', file);
+                if ((unsigned char)*text >= 0x20) fputc(*text, file);
+            }
+        }
+    }
+
+    uint64_t Profiler::Now()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void Profiler::BeginSession()
+    {
+        {
+            std::lock_guard<std::mutex> lock(s_BuffersMutex);
+            for (auto& buffer : s_Buffers)
+            {
+                buffer->SessionBegin = buffer->Published.load(std::memory_order_acquire);
+                buffer->SessionEnd = UINT64_MAX;
+            }
+
+            s_SessionStart = Now();
+            s_FrameIndex = 0;
+        }
+
+        s_Recording.store(true, std::memory_order_relaxed);
+    }
+
+    void Profiler::EndSession()
+    {
+        s_Recording.store(false, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(s_BuffersMutex);
+        for (auto& buffer : s_Buffers)
+        {
+            buffer->SessionEnd = buffer->Published.load(std::memory_order_acquire);
+        }
+    }
+
+    void Profiler::SetThreadName(const std::string& name)
+    {
+        ProfilerThreadBuffer* buffer = GetThreadBuffer();
+
+        std::lock_guard<std::mutex> lock(s_BuffersMutex);
+        buffer->Name = name;
+    }
+
+    void Profiler::MarkFrame()
+    {
+        if (!IsRecording())
+        {
+            return;
+        }
+
+        GetThreadBuffer()->Push({ "Frame", Now(), s_FrameIndex++, ProfilerEventType::Frame });
+    }
+
+    void Profiler::RecordZone(const char* name, uint64_t start, uint64_t end)
+    {
+        GetThreadBuffer()->Push({ name, start, end - start, ProfilerEventType::Zone });
+    }
+
+    bool Profiler::WriteChromeTrace(const std::string& path)
+    {
+        FILE* file = fopen(path.c_str(), "w");
+        if (!file)
+        {
+            BLD_CORE_ERROR("Failed to open {} for writing", path);
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock(s_BuffersMutex);
+
+        fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+        bool first = true;
+        size_t eventCount = 0;
+
+        for (auto& buffer : s_Buffers)
+        {
+            fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                first ? "" : ",\n", buffer->ThreadID);
+            WriteEscaped(file, buffer->Name.c_str());
+            fprintf(file, "\"}}");
+            first = false;
+
+            const uint64_t end = std::min(buffer->SessionEnd, buffer->Published.load(std::memory_order_acquire));
+
+            uint64_t index = 0;
+            for (ProfilerEventBlock* block = buffer->Head; block && index < end; block = block->Next)
+            {
+                for (size_t i = 0; i < ProfilerEventBlock::Capacity && index < end; i++, index++)
+                {
+                    if (index < buffer->SessionBegin)
+                    {
+                        continue;
+                    }
+
+                    const ProfilerEvent& event = block->Events[i];
+                    if (event.Start < s_SessionStart)
+                    {
+                        continue;
+                    }
+
+                    // Chrome traces count in microseconds
+                    const double timestamp = (event.Start - s_SessionStart) / 1000.0;
+
+                    fprintf(file, ",\n{\"name\":\"");
+                    WriteEscaped(file, event.Name);
+
+                    if (event.Type == ProfilerEventType::Zone)
+                    {
+                        fprintf(file, "\",\"cat\":\"blade\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                            timestamp, event.Value / 1000.0, buffer->ThreadID);
+                    }
+                    else
+                    {
+                        fprintf(file, "\",\"cat\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"frame\":%llu}}",
+                            timestamp, buffer->ThreadID, (unsigned long long)event.Value);
+                    }
+
+                    eventCount++;
+                }
+            }
+        }
+
+        fprintf(file, "\n]}\n");
+
+        bool written = ferror(file) == 0;
+        fclose(file);
+
+        if (written)
+        {
+            BLD_CORE_INFO("Wrote {} profiler events to {}", eventCount, path);
+        }
+
+        return written;
+    }
+}
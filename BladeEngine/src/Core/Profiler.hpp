@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace BladeEngine
+{
+    /**
+     * @brief CPU profiler recording named zones and frame markers, exported as a Chrome trace.
+     *
+     * Every thread appends to an event buffer of its own, so recording a zone takes no lock.
+     * Events are only recorded between BeginSession and EndSession, outside of a session a zone
+     * costs one relaxed atomic load. Buffers are never shrunk, sessions are meant to cover a
+     * bounded number of frames. The BLD_PROFILE_* macros compile to nothing unless the engine
+     * is built with BLADE_PROFILE.
+     */
+    class Profiler
+    {
+    public:
+        /**
+         * @brief Starts recording on every thread.
+         *
+         */
+        static void BeginSession();
+
+        /**
+         * @brief Stops recording, the session can be written out until the next BeginSession.
+         *
+         */
+        static void EndSession();
+
+        inline static bool IsRecording() { return s_Recording.load(std::memory_order_relaxed); }
+
+        /**
+         * @brief Writes the last session in the Chrome trace event format.
+         *
+         * The file opens in chrome://tracing and in the Perfetto UI.
+         *
+         * @param path file the trace is written to.
+         * @return false if the file could not be written.
+         */
+        static bool WriteChromeTrace(const std::string& path);
+
+        /**
+         * @brief Names the calling thread in exported traces.
+         *
+         * @param name thread name, copied.
+         */
+        static void SetThreadName(const std::string& name);
+
+        /**
+         * @brief Marks the start of a new frame on the timeline.
+         *
+         */
+        static void MarkFrame();
+
+        /**
+         * @brief Records a finished zone on the calling thread.
+         *
+         * @param name zone name, must outlive the session, string literals or entity names.
+         * @param start timestamp from Now when the zone began.
+         * @param end timestamp from Now when the zone ended.
+         */
+        static void RecordZone(const char* name, uint64_t start, uint64_t end);
+
+        /**
+         * @brief Monotonic timestamp in nanoseconds.
+         *
+         */
+        static uint64_t Now();
+
+    private:
+        static std::atomic<bool> s_Recording;
+    };
+
+    /**
+     * @brief Records the time between its construction and destruction as a zone.
+     *
+     */
+    class ProfileZone
+    {
+    public:
+        ProfileZone(const char* name)
+            : m_Name(name), m_Start(Profiler::IsRecording() ? Profiler::Now() : 0) { }
+
+        ~ProfileZone()
+        {
+            if (m_Start && Profiler::IsRecording())
+            {
+                Profiler::RecordZone(m_Name, m_Start, Profiler::Now());
+            }
+        }
+
+        ProfileZone(const ProfileZone&) = delete;
+        ProfileZone& operator=(const ProfileZone&) = delete;
+
+    private:
+        const char* m_Name;
+        uint64_t m_Start;
+    };
+}
+
+#ifdef BLADE_PROFILE
+
+#define BLD_PROFILE_CONCAT_INNER(a, b)   a##b
+#define BLD_PROFILE_CONCAT(a, b)         BLD_PROFILE_CONCAT_INNER(a, b)
+
+#define BLD_PROFILE_SCOPE(name)          ::BladeEngine::ProfileZone BLD_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define BLD_PROFILE_FUNCTION()           BLD_PROFILE_SCOPE(__func__)
+#define BLD_PROFILE_FRAME()              ::BladeEngine::Profiler::MarkFrame()
+#define BLD_PROFILE_THREAD(name)         ::BladeEngine::Profiler::SetThreadName(name)
+
+#else
+
+#define BLD_PROFILE_SCOPE(name)
+#define BLD_PROFILE_FUNCTION()
+#define BLD_PROFILE_FRAME()
+#define BLD_PROFILE_THREAD(name)
+
+#endif // BLADE_PROFILE
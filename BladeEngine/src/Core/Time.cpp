@@ -1,27 +1,55 @@
 #include "Time.hpp"
 
+#include <algorithm>
+
 namespace BladeEngine
 {
-    float Time::s_CurrentWorldTime;
-    float Time::s_DeltaTime;
+    int64_t Time::s_CurrentWorldTime;
+    int64_t Time::s_DeltaTime;
+
+    int64_t Time::s_FixedDeltaTime = 1000000000 / 60;
+    int64_t Time::s_FixedWorldTime;
+    int64_t Time::s_Accumulator;
+    uint32_t Time::s_MaxFixedSteps = 8;
 
-    std::chrono::time_point<std::chrono::high_resolution_clock> Time::s_Start;
+    std::chrono::steady_clock::time_point Time::s_Start;
 
-    void Time::Init()
+    void Time::Init(uint32_t fixedUpdateRate, uint32_t maxFixedSteps)
     {
-        s_Start = std::chrono::high_resolution_clock::now();
-        s_CurrentWorldTime = 0.0f;
+        s_Start = std::chrono::steady_clock::now();
+        s_CurrentWorldTime = 0;
+        s_DeltaTime = 0;
+
+        s_FixedDeltaTime = 1000000000 / std::max(fixedUpdateRate, 1u);
+        s_FixedWorldTime = 0;
+        s_Accumulator = 0;
+        s_MaxFixedSteps = std::max(maxFixedSteps, 1u);
     }
 
     void Time::Update()
     {
-        float lastFrameTime = s_CurrentWorldTime;
+        int64_t lastFrameTime = s_CurrentWorldTime;
         s_CurrentWorldTime = 
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::high_resolution_clock::now() - s_Start).count() * 0.001f;
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - s_Start).count();
 
         s_DeltaTime = s_CurrentWorldTime - lastFrameTime;
+
+        // A frame slower than MaxFixedSteps steps only simulates that many, the rest is dropped.
+        // Otherwise each slow frame would owe more steps than the next one has time for
+        s_Accumulator += std::min(s_DeltaTime, s_FixedDeltaTime * s_MaxFixedSteps);
     }
 
-    
-}
\ No newline at end of file
+    bool Time::ConsumeFixedStep()
+    {
+        if (s_Accumulator < s_FixedDeltaTime)
+        {
+            return false;
+        }
+
+        s_Accumulator -= s_FixedDeltaTime;
+        s_FixedWorldTime += s_FixedDeltaTime;
+
+        return true;
+    }
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 
 namespace BladeEngine
 {
@@ -12,25 +13,75 @@ namespace BladeEngine
          * 
          * @return time in seconds since the beginning of the world.
          */
-        inline static float CurrentWorldTime() { return s_CurrentWorldTime; }
+        inline static float CurrentWorldTime() { return s_CurrentWorldTime * 0.000000001f; }
 
         /**
          * @brief Elapsed time in seconds since last frame.
          * 
          * @return time in seconds since last frame.
          */
-        inline static float DeltaTime() { return s_DeltaTime; }
+        inline static float DeltaTime() { return s_DeltaTime * 0.000000001f; }
+
+        /**
+         * @brief World time in nanoseconds, without the rounding of CurrentWorldTime.
+         * 
+         * @return time in nanoseconds since the beginning of the world.
+         */
+        inline static int64_t CurrentWorldTimeNanoseconds() { return s_CurrentWorldTime; }
+
+        /**
+         * @brief Elapsed time in nanoseconds since last frame.
+         * 
+         * @return time in nanoseconds since last frame.
+         */
+        inline static int64_t DeltaTimeNanoseconds() { return s_DeltaTime; }
+
+        /**
+         * @brief Time simulated by a single fixed step, the delta time fixed systems should use.
+         * 
+         * @return fixed step length in seconds.
+         */
+        inline static float FixedDeltaTime() { return s_FixedDeltaTime * 0.000000001f; }
+
+        /**
+         * @brief Simulated world time, advanced by every fixed step.
+         * 
+         * Inside a fixed system it is the time the step simulates up to, unlike CurrentWorldTime
+         * which stays the same for every step of a frame.
+         * 
+         * @return simulated time in seconds since the beginning of the world.
+         */
+        inline static float FixedWorldTime() { return s_FixedWorldTime * 0.000000001f; }
+
+        /**
+         * @brief How far the frame is between the last two fixed steps.
+         * 
+         * @return 0 at the last fixed step, approaching 1 right before the next one.
+         */
+        inline static float InterpolationAlpha() { return (float)s_Accumulator / (float)s_FixedDeltaTime; }
 
     private:
-        static void Init();
+        static void Init(uint32_t fixedUpdateRate, uint32_t maxFixedSteps);
         static void Update();
 
+        /**
+         * @brief Takes one fixed step worth of time out of the accumulated frame time.
+         * 
+         * @return false once less than a fixed step is left for this frame.
+         */
+        static bool ConsumeFixedStep();
+
     private:
-        static float s_CurrentWorldTime;
-        static float s_DeltaTime;
+        static int64_t s_CurrentWorldTime;
+        static int64_t s_DeltaTime;
+
+        static int64_t s_FixedDeltaTime;
+        static int64_t s_FixedWorldTime;
+        static int64_t s_Accumulator;
+        static uint32_t s_MaxFixedSteps;
 
-        static std::chrono::time_point<std::chrono::high_resolution_clock> s_Start;
+        static std::chrono::steady_clock::time_point s_Start;
 
         friend class Game;
     };
-}
\ No newline at end of file
+}
@@ -12,7 +12,8 @@ namespace BladeEngine
 {
     float Window::s_ViewportAspectRatio;
 
-    Window::Window(uint32_t width, uint32_t height, const std::string& title)
+    Window::Window(uint32_t width, uint32_t height, const std::string& title, bool headless)
+        : m_Headless(headless)
     {
         s_ViewportAspectRatio = (float)width / height;
 
@@ -21,6 +22,11 @@ namespace BladeEngine
 
         m_Title = title;
 
+        if (m_Headless)
+        {
+            return;
+        }
+
         if (!glfwInit())
         {
             return;
@@ -44,6 +50,11 @@ namespace BladeEngine
     
     Window::~Window()
     {
+        if (m_Headless)
+        {
+            return;
+        }
+
         glfwDestroyWindow(m_WindowHandle);
 
         glfwTerminate();
@@ -51,6 +62,11 @@ namespace BladeEngine
 
     void Window::PollEvents()
     {
+        if (m_Headless)
+        {
+            return;
+        }
+
         glfwPollEvents();
     }
 
@@ -63,6 +79,11 @@ namespace BladeEngine
 #if BLADE_VULKAN_API
     VkSurfaceKHR Window::CreateWindowSurface(VkInstance vulkanInstance) const
     {
+        if (m_Headless)
+        {
+            return VK_NULL_HANDLE;
+        }
+
         VkSurfaceKHR surface;
         if (glfwCreateWindowSurface(vulkanInstance, m_WindowHandle, nullptr, &surface) != VK_SUCCESS)
 		{
@@ -75,6 +96,12 @@ namespace BladeEngine
 
     std::vector<const char*> Window::GetRequiredExtensions() const
 	{
+		// Offscreen rendering needs no surface extensions
+		if (m_Headless)
+		{
+			return {};
+		}
+
 		uint32_t glfwExtensionCount = 0;
 		const char** glfwExtensions;
 		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
@@ -17,7 +17,13 @@ namespace BladeEngine
     class Window
     {
     public:
-        Window(uint32_t width, uint32_t height, const std::string& title);
+        /**
+         * @brief Creates the application window.
+         * 
+         * @param headless No window is created and GLFW is never initialized, the size is only used
+         * for the offscreen images the renderer draws into.
+         */
+        Window(uint32_t width, uint32_t height, const std::string& title, bool headless = false);
         ~Window();
 
         /**
@@ -33,6 +39,13 @@ namespace BladeEngine
          */
 		inline uint32_t GetHeight() const { return m_WindowData.Height; }
 
+        /**
+         * @brief Whether the application runs without a window.
+         * 
+         * @return true when rendering goes to offscreen images instead of a swapchain.
+         */
+        inline bool IsHeadless() const { return m_Headless; }
+
         bool SwapchainNeedsResize() const { return m_WindowData.SwapchainNeedsResize; }
 
         void GotResized() { m_WindowData.SwapchainNeedsResize = false; }
@@ -59,8 +72,9 @@ namespace BladeEngine
         static void SetCursorPos(float x, float y);
 
     private:
-        GLFWwindow* m_WindowHandle;
+        GLFWwindow* m_WindowHandle = nullptr;
         std::string m_Title;
+        bool m_Headless;
 
         struct WindowData
         {
@@ -1,13 +1,108 @@
 #include "World.hpp"
 
+#include "../Core/Profiler.hpp"
+
 namespace BladeEngine
 {
     flecs::world World::s_FlecsWorld;
 
+    flecs::entity_t World::s_FixedStepTag;
+    flecs::entity_t World::s_FixedPipeline;
+
+    namespace
+    {
+        // Systems run in the order they were created, as in the builtin pipeline
+        int CompareSystems(ecs_entity_t e1, const void* ptr1, ecs_entity_t e2, const void* ptr2)
+        {
+            return (e1 > e2) - (e1 < e2);
+        }
+
+        ecs_entity_t CreatePipeline(ecs_world_t* world, const char* name, ecs_entity_t fixedStepTag, bool fixedStep)
+        {
+            ecs_entity_desc_t entityDesc{};
+            entityDesc.name = name;
+
+            // Same query as the builtin pipeline, split on whether systems carry the fixed step tag
+            ecs_pipeline_desc_t desc{};
+            desc.entity = ecs_entity_init(world, &entityDesc);
+
+            ecs_term_t* terms = desc.query.filter.terms;
+
+            terms[0].id = EcsSystem;
+
+            terms[1].id = EcsPhase;
+            terms[1].src.flags = EcsCascade;
+            terms[1].src.trav = EcsDependsOn;
+
+            terms[2].id = ecs_dependson(EcsOnStart);
+            terms[2].src.trav = EcsDependsOn;
+            terms[2].oper = EcsNot;
+
+            terms[3].id = EcsDisabled;
+            terms[3].src.flags = EcsUp;
+            terms[3].src.trav = EcsDependsOn;
+            terms[3].oper = EcsNot;
+
+            terms[4].id = EcsDisabled;
+            terms[4].src.flags = EcsUp;
+            terms[4].src.trav = EcsChildOf;
+            terms[4].oper = EcsNot;
+
+            terms[5].id = fixedStepTag;
+            terms[5].oper = fixedStep ? EcsAnd : EcsNot;
+
+            desc.query.order_by = CompareSystems;
+
+            return ecs_pipeline_init(world, &desc);
+        }
+    }
+
+    void World::Init()
+    {
+        s_FixedStepTag = s_FlecsWorld.entity("FixedStep");
+
+        s_FixedPipeline = CreatePipeline(s_FlecsWorld, "FixedPipeline", s_FixedStepTag, true);
+        ecs_set_pipeline(s_FlecsWorld, CreatePipeline(s_FlecsWorld, "FramePipeline", s_FixedStepTag, false));
+    }
+
     void World::Step(float deltaTime)
     {
+        BLD_PROFILE_FUNCTION();
+
         s_FlecsWorld.progress(deltaTime);
     }
 
+    void World::FixedStep(float fixedDeltaTime)
+    {
+        // OnStart systems only run with the first progress, fixed systems may rely on what they set up
+        if (ecs_get_world_info(s_FlecsWorld)->frame_count_total == 0)
+        {
+            return;
+        }
+
+        BLD_PROFILE_FUNCTION();
+
+        s_FlecsWorld.run_pipeline(s_FixedPipeline, fixedDeltaTime);
+    }
+
+    void World::RunSystem(ecs_iter_t* it)
+    {
+        // Entity names live as long as the system, so they outlast the session
+        BLD_PROFILE_SCOPE(ecs_get_name(it->world, it->system));
+
+        // A system without terms is called once, like the default flecs runner does
+        if (it->field_count == 0)
+        {
+            it->callback(it);
+            ecs_iter_fini(it);
+            return;
+        }
+
+        while (ecs_iter_next(it))
+        {
+            it->callback(it);
+        }
+    }
+
 
 }
\ No newline at end of file
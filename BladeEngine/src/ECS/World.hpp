@@ -59,7 +59,7 @@ namespace BladeEngine
         template<typename Func>
         static void BindSystemNoQuery(flecs::entity_t phase, const char* name, Func f)
         {
-            s_FlecsWorld.system(name).kind(phase).iter(f);
+            s_FlecsWorld.system(name).kind(phase).run(RunSystem).iter(f);
         }
 
         /**
@@ -75,7 +75,7 @@ namespace BladeEngine
         template<typename ... Comps, typename Func>
         static void BindSystem(flecs::entity_t phase, const char* name, Func f)
         {
-            s_FlecsWorld.system<Comps...>(name).kind(phase).each(f);
+            s_FlecsWorld.system<Comps...>(name).kind(phase).run(RunSystem).each(f);
         }
 
         /**
@@ -91,7 +91,26 @@ namespace BladeEngine
         template<typename ... Comps, typename Func>
         static void BindSystemIter(flecs::entity_t phase, const char* name, Func f)
         {
-            s_FlecsWorld.system<Comps...>(name).kind(phase).iter(f);
+            s_FlecsWorld.system<Comps...>(name).kind(phase).run(RunSystem).iter(f);
+        }
+
+        /**
+         * @brief Creates and binds a system that runs once per fixed step instead of once per frame.
+         * 
+         * Fixed systems run before the frame's systems, zero or more times a frame, with the
+         * fixed delta time. Use them for anything driving physics or that has to stay frame rate independent.
+         * 
+         * @tparam Comps component types that will be part of the query.
+         * @tparam Func type of f
+         * 
+         * @param phase pipeline phase that orders the system among the other fixed systems.
+         * @param name name of the system.
+         * @param f function to be executed when running the system.
+         */
+        template<typename ... Comps, typename Func>
+        static void BindFixedSystem(flecs::entity_t phase, const char* name, Func f)
+        {
+            s_FlecsWorld.system<Comps...>(name).kind(phase).run(RunSystem).each(f).add(s_FixedStepTag);
         }
 
         /**
@@ -107,17 +126,40 @@ namespace BladeEngine
         template<typename ... Comps, typename Func>
         static void BindSystem(float timer, const char* name, Func f)
         {
-            s_FlecsWorld.system<Comps...>(name).interval(timer).each(f);
+            s_FlecsWorld.system<Comps...>(name).interval(timer).run(RunSystem).each(f);
         }
 
         static flecs::world* GetECSWorldHandle() { return &s_FlecsWorld; }
 
+        /**
+         * @brief Tag that moves a system from the frame to the fixed step, see BindFixedSystem.
+         * 
+         * @return tag to add to systems created from the ECS world handle.
+         */
+        static flecs::entity_t GetFixedStepTag() { return s_FixedStepTag; }
+
+        /**
+         * @brief Runs a system the way flecs would, inside a profiler zone named after the system.
+         * 
+         * Systems bound through the World use it already, pass it to run() on systems created
+         * from the ECS world handle to profile them as well.
+         * 
+         * @param it iterator flecs prepared for the system, its callback is the system function.
+         */
+        static void RunSystem(ecs_iter_t* it);
+
     private:
+        static void Init();
+
         static void Step(float deltaTime);
+        static void FixedStep(float fixedDeltaTime);
 
     private:
         static flecs::world s_FlecsWorld;
 
+        static flecs::entity_t s_FixedStepTag;
+        static flecs::entity_t s_FixedPipeline;
+
         friend class Game;
 
     };
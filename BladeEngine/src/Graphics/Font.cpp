@@ -1,9 +1,12 @@
 #include "Font.hpp"
 
 #include "../Core/Base.hpp"
+#include "../Core/Profiler.hpp"
 
 #include "MSDFData.hpp"
 
+#include <algorithm>
+
 
 namespace BladeEngine::Graphics {
 
@@ -49,6 +52,8 @@ namespace BladeEngine::Graphics {
 	Font::Font(const char* filepath)
 		: m_Data(new MSDFData())
 	{
+		BLD_PROFILE_SCOPE("Load Font");
+
 		msdfgen::FreetypeHandle* ft = msdfgen::initializeFreetype();
 		BLD_CORE_ASSERT(ft, "Failed to initialize FreetypeHandle");
 
@@ -81,6 +86,20 @@ namespace BladeEngine::Graphics {
 		int glyphsLoaded = m_Data->FontGeometry.loadCharset(font, fontScale, charset);
 		BLD_CORE_INFO("Loaded {} glyphs from font (out of {})", glyphsLoaded, charset.size());
 
+		const auto& metrics = m_Data->FontGeometry.getMetrics();
+		double fsScale = 1.0 / (metrics.ascenderY - metrics.descenderY);
+
+		double maxGlyphWidth = 0.0;
+		for (const auto& glyph : m_Data->Glyphs)
+		{
+			double pl, pb, pr, pt;
+			glyph.getQuadPlaneBounds(pl, pb, pr, pt);
+			maxGlyphWidth = std::max({ maxGlyphWidth, glyph.getAdvance(), pr - pl });
+		}
+
+		m_MaxGlyphWidth = (float)(fsScale * maxGlyphWidth);
+		m_LineHeight = (float)(fsScale * metrics.lineHeight);
+
 
 		double emSize = 80.0;
 
@@ -115,6 +134,32 @@ namespace BladeEngine::Graphics {
 
 	}
 
+	glm::vec4 Font::GetConservativeBounds(const std::string& string) const
+	{
+		uint32_t lineCount = 1;
+		uint32_t lineLength = 0, longestLine = 0;
+
+		for (char character : string)
+		{
+			if (character == '\n')
+			{
+				lineCount++;
+				lineLength = 0;
+				continue;
+			}
+
+			lineLength += character == '\t' ? 4 : 1;
+			longestLine = std::max(longestLine, lineLength);
+		}
+
+		// Glyphs can overhang their advance and reach one em above and below the baseline
+		return glm::vec4(
+			-m_MaxGlyphWidth,
+			-(float)(lineCount - 1) * m_LineHeight - 1.0f,
+			(float)(longestLine + 1) * m_MaxGlyphWidth,
+			1.0f);
+	}
+
 	Font::~Font()
 	{
 		delete m_Data;
@@ -2,6 +2,10 @@
 
 #include "Texture2D.hpp"
 
+#include <glm/glm.hpp>
+
+#include <string>
+
 namespace BladeEngine::Graphics {
 
 	struct MSDFData;
@@ -15,9 +19,17 @@ namespace BladeEngine::Graphics {
 		Texture2D* GetAtlasTexture() const { return m_AtlasTexture; }
 		const MSDFData* GetMSDFData() const { return m_Data; }
 
+		// Rectangle (min x, min y, max x, max y) in text space that contains the laid out string,
+		// sized from line and character counts so it never needs the glyph layout itself
+		glm::vec4 GetConservativeBounds(const std::string& string) const;
+
 	private:
 		MSDFData* m_Data;
 		Texture2D* m_AtlasTexture = nullptr;
+
+		// In the same units DrawString lays glyphs out in, one em from descender to ascender
+		float m_MaxGlyphWidth = 1.0f;
+		float m_LineHeight = 1.0f;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "FrameCapture.hpp"
+
+#include "../Core/Log.hpp"
+
+#include <cstdio>
+
+namespace BladeEngine::Graphics {
+
+	bool FrameCapture::SaveAsPPM(const std::string& path) const
+	{
+		if (Pixels.size() < (size_t)Width * Height * 4)
+		{
+			BLD_CORE_ERROR("Frame capture holds no {}x{} frame, nothing written to {}", Width, Height, path);
+			return false;
+		}
+
+		FILE* file = fopen(path.c_str(), "wb");
+		if (!file)
+		{
+			BLD_CORE_ERROR("Failed to open {} for writing", path);
+			return false;
+		}
+
+		fprintf(file, "P6\n%u %u\n255\n", Width, Height);
+
+		std::vector<uint8_t> row((size_t)Width * 3);
+		for (uint32_t y = 0; y < Height; y++)
+		{
+			const uint8_t* source = &Pixels[(size_t)y * Width * 4];
+			for (uint32_t x = 0; x < Width; x++)
+			{
+				row[x * 3 + 0] = source[x * 4 + 0];
+				row[x * 3 + 1] = source[x * 4 + 1];
+				row[x * 3 + 2] = source[x * 4 + 2];
+			}
+
+			fwrite(row.data(), 1, row.size(), file);
+		}
+
+		bool written = ferror(file) == 0;
+		fclose(file);
+
+		return written;
+	}
+
+}
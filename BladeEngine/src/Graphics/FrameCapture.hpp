@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace BladeEngine::Graphics {
+
+	// A rendered frame copied back to host memory, see GraphicsManager::RequestFrameCapture
+	struct FrameCapture
+	{
+		uint32_t Width = 0;
+		uint32_t Height = 0;
+		// RGBA8 in the sRGB encoding the window would show, rows top to bottom
+		std::vector<uint8_t> Pixels;
+
+		// Binary PPM (P6), alpha is dropped. Readable by most image tools, so golden images can be diffed directly
+		bool SaveAsPPM(const std::string& path) const;
+	};
+
+}
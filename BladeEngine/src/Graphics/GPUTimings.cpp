@@ -0,0 +1,20 @@
+#include "GPUTimings.hpp"
+
+#include <cstring>
+
+namespace BladeEngine::Graphics {
+
+	float GPUTimings::GetScopeMilliseconds(const char* name) const
+	{
+		for (const GPUScopeTiming& scope : Scopes)
+		{
+			if (strcmp(scope.Name, name) == 0)
+			{
+				return scope.Milliseconds;
+			}
+		}
+
+		return 0.0f;
+	}
+
+}
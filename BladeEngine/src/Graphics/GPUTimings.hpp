@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace BladeEngine::Graphics {
+
+	struct GPUScopeTiming
+	{
+		// Static string given when the scope was recorded, "Clear", "Sprites" or "Text" for the renderer's passes
+		const char* Name;
+		float Milliseconds;
+	};
+
+	// GPU side of the most recently completed frame. Results are read once the frame's fence signaled,
+	// so they trail the frame being built by the number of frames in flight
+	struct GPUTimings
+	{
+		// False when the graphics queue can not write timestamps, everything below stays zero
+		bool Available = false;
+
+		// First scope begin to last scope end
+		float FrameMilliseconds = 0.0f;
+		std::vector<GPUScopeTiming> Scopes;
+
+		// Counted over the whole render pass, only when the device supports pipeline statistics queries
+		bool PipelineStatisticsAvailable = false;
+		uint64_t InputAssemblyVertices = 0;
+		uint64_t InputAssemblyPrimitives = 0;
+		uint64_t VertexShaderInvocations = 0;
+		uint64_t ClippingPrimitives = 0;
+		uint64_t FragmentShaderInvocations = 0;
+
+		// 0 when no scope of that name was recorded
+		float GetScopeMilliseconds(const char* name) const;
+	};
+
+}
@@ -1,5 +1,6 @@
 #include "GraphicsManager.hpp"
 #include "Mesh.hpp"
+#include "TextureLoader.hpp"
 
 #if BLADE_VULKAN_API
     #include "Platform/Vulkan/BladeVulkanRenderer.hpp"
@@ -17,7 +18,8 @@ GraphicsManager::GraphicsManager(Window* window)
 
 GraphicsManager::~GraphicsManager()
 {
-
+    // The renderer is never torn down, write the pipelines compiled during this run out now
+    vkRenderer->SavePipelineCache();
 }
 
 void GraphicsManager::Init(Window* window)
@@ -62,7 +64,11 @@ void GraphicsManager::Clear(Color color)
 
 void GraphicsManager::BeginDrawing()
 {
+    m_VisibilityCuller.BeginFrame(mainCamera);
     vkRenderer->BeginDrawing();
+
+    // After the renderer polled the upload fences, so textures whose upload landed are marked ready this frame
+    TextureLoader::Update();
 }
 
 void GraphicsManager::BeginDrawing(
@@ -75,21 +81,30 @@ void GraphicsManager::BeginDrawing(
 void GraphicsManager::DrawSprite(
     Texture2D *texture, 
     const glm::mat4& transform, 
-    const glm::vec4& uvTransform)
+    const glm::vec4& uvTransform,
+    uint8_t layer)
 {
-    vkRenderer->DrawSprite(texture, transform, uvTransform);
+    // Streamed textures have no GPU texture until they are decoded
+    if (!texture->GetGPUTexture())
+    {
+        texture = TextureLoader::GetPlaceholder();
+    }
+
+    vkRenderer->DrawSprite(texture, transform, uvTransform, layer);
 }
 
 void GraphicsManager::DrawString(
     const std::string& string, 
     Font* font, 
-    const glm::mat4& transform)
+    const glm::mat4& transform,
+    bool outline)
 {
-    vkRenderer->DrawString(string, font, transform);
+    vkRenderer->DrawString(string, font, transform, outline);
 }
 
 void GraphicsManager::EndDrawing()
 {
+    vkRenderer->SetCullingStatistics(m_VisibilityCuller.GetStatistics());
     vkRenderer->EndDrawing();
 }
 
@@ -103,6 +118,16 @@ void GraphicsManager::ReleaseGPUTexture(void* gpuTexture)
     vkRenderer->ReleaseGPUTexture((Vulkan::VulkanTexture*)gpuTexture);
 }
 
+bool GraphicsManager::IsGPUTextureReady(void* gpuTexture) const
+{
+    return vkRenderer->IsGPUTextureReady((Vulkan::VulkanTexture*)gpuTexture);
+}
+
+bool GraphicsManager::IsTextureFormatSupported(TextureFormat format) const
+{
+    return vkRenderer->IsTextureFormatSupported(format);
+}
+
 void* GraphicsManager::UploadMeshToGPU(Buffer vertices, Buffer indices)
 {
     return vkRenderer->UploadMeshToGPU(vertices, indices);
@@ -118,7 +143,42 @@ void GraphicsManager::WaitDeviceIdle()
     vkRenderer->WaitDeviceIdle();
 }
 
+const RenderStatistics& GraphicsManager::GetRenderStatistics() const
+{
+    return vkRenderer->GetRenderStatistics();
+}
+
+const GPUTimings& GraphicsManager::GetGPUTimings() const
+{
+    return vkRenderer->GetGPUTimings();
+}
+
+void GraphicsManager::SetSpriteRenderMode(SpriteRenderMode mode)
+{
+    vkRenderer->SetSpriteRenderMode(mode);
+}
+
+SpriteRenderMode GraphicsManager::GetSpriteRenderMode() const
+{
+    return vkRenderer->GetSpriteRenderMode();
+}
+
 void GraphicsManager::RecreateSwapchain(uint32_t width, uint32_t height)
 {
     vkRenderer->RecreateSwapchain(width, height);
-}
\ No newline at end of file
+}
+
+bool GraphicsManager::IsHeadless() const
+{
+    return vkRenderer->IsHeadless();
+}
+
+bool GraphicsManager::RequestFrameCapture()
+{
+    return vkRenderer->RequestFrameCapture();
+}
+
+bool GraphicsManager::ReadCapturedFrame(FrameCapture& capture)
+{
+    return vkRenderer->ReadCapturedFrame(capture);
+}
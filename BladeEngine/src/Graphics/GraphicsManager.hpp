@@ -6,6 +6,11 @@
 #include "Shader.hpp"
 #include "Vertex.hpp"
 #include "Color.hpp"
+#include "RenderStatistics.hpp"
+#include "GPUTimings.hpp"
+#include "FrameCapture.hpp"
+#include "RenderSettings.hpp"
+#include "VisibilityCulling.hpp"
 #include "../Core/Buffer.hpp"
 #include "../Core/Window.hpp"
 
@@ -35,25 +40,48 @@ namespace BladeEngine::Graphics {
 		/*Begins Drawing commands with custom shader*/
 		void BeginDrawing(Shader* vertexShader, Shader* fragmentShader);
 		/*Draws a Quad with the selected texture and the current active shader program*/
-		void DrawSprite(Texture2D* texture, const glm::mat4& transform, const glm::vec4& uvTransform);
-		void DrawString(const std::string& string, Font* font, const glm::mat4& transform);
+		void DrawSprite(Texture2D* texture, const glm::mat4& transform, const glm::vec4& uvTransform, uint8_t layer = 0);
+		void DrawString(const std::string& string, Font* font, const glm::mat4& transform, bool outline = false);
 		/*Stops the rendering*/
 		void EndDrawing();
 
 		void* UploadTextureToGPU(Texture2D* texture);
 		void ReleaseGPUTexture(void* gpuTexture);
+		bool IsGPUTextureReady(void* gpuTexture) const;
+		/*False for the block compression family the device lacks, BC on most mobile GPUs and ETC2 on most desktop ones*/
+		bool IsTextureFormatSupported(TextureFormat format) const;
 
 		void* UploadMeshToGPU(Buffer vertices, Buffer indices);
 		void ReleaseGPUMesh(void* gpuMesh);
 
 		void WaitDeviceIdle();
 
+		/*Draw call and batch counters of the last submitted frame*/
+		const RenderStatistics& GetRenderStatistics() const;
+		/*GPU milliseconds per pass of the last frame the GPU finished, a few frames behind the statistics*/
+		const GPUTimings& GetGPUTimings() const;
+
+		/*Selects between CPU transformed vertex batches and instanced quads, applied from the next frame*/
+		void SetSpriteRenderMode(SpriteRenderMode mode);
+		SpriteRenderMode GetSpriteRenderMode() const;
+
 		void RecreateSwapchain(uint32_t width, uint32_t height);
 
+		/*True when drawing into offscreen images because the window is headless*/
+		bool IsHeadless() const;
+		/*Reads the next submitted frame back to host memory, headless only*/
+		bool RequestFrameCapture();
+		/*Blocks until the requested frame is rendered, false when none was requested*/
+		bool ReadCapturedFrame(FrameCapture& capture);
+
+		/*View rectangle of the main camera for the frame being drawn, valid between BeginDrawing and EndDrawing*/
+		VisibilityCuller& GetVisibilityCuller() { return m_VisibilityCuller; }
+
 		inline static GraphicsManager* Instance() { return s_Instance; }
 
 	private:
 		BladeEngine::Camera* mainCamera;
+		VisibilityCuller m_VisibilityCuller;
 		void InitRenderer(Window* window);
 		void Dispose();
 
@@ -5,6 +5,7 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <ostream>
 #include <set>
@@ -17,6 +18,13 @@ namespace BladeEngine::Graphics::Vulkan {
 		std::vector<const char*> extensions) 
 	{
 		PickPhysicalDevice(instance, surface, extensions);
+		QueryDescriptorIndexingSupport();
+
+		if (descriptorIndexingSupported)
+		{
+			extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+		}
+
 		CreateLogicalDevice(surface, extensions);
 	}
 
@@ -92,8 +100,9 @@ namespace BladeEngine::Graphics::Vulkan {
 		VkPhysicalDeviceFeatures supportedFeatures;
 		vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
 
-		bool swapChainAdequate = false;
-		if (extensionsSupported) {
+		// Offscreen rendering has no surface to present to
+		bool swapChainAdequate = surface == VK_NULL_HANDLE;
+		if (extensionsSupported && !swapChainAdequate) {
 			SwapChainSupportDetails swapChainSupport =
 				QuerySwapChainSupport(physicalDevice, surface);
 			swapChainAdequate = !swapChainSupport.formats.empty() &&
@@ -125,13 +134,73 @@ namespace BladeEngine::Graphics::Vulkan {
 		BLD_CORE_ASSERT(physicalDevice != VK_NULL_HANDLE, "Failed to find a suitable GPU!");
 	}
 
+	void VulkanDevice::QueryDescriptorIndexingSupport()
+	{
+		if (!CheckDeviceExtensionSupport(physicalDevice, { VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME }))
+		{
+			BLD_CORE_INFO("{} not available, bindless textures disabled", VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+			return;
+		}
+
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+		indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+
+		VkPhysicalDeviceFeatures2 features{};
+		features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		features.pNext = &indexingFeatures;
+
+		vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+		descriptorIndexingSupported = indexingFeatures.runtimeDescriptorArray &&
+			indexingFeatures.shaderSampledImageArrayNonUniformIndexing &&
+			indexingFeatures.descriptorBindingPartiallyBound &&
+			indexingFeatures.descriptorBindingSampledImageUpdateAfterBind &&
+			indexingFeatures.descriptorBindingUpdateUnusedWhilePending;
+
+		if (!descriptorIndexingSupported)
+		{
+			BLD_CORE_INFO("Descriptor indexing features missing, bindless textures disabled");
+			return;
+		}
+
+		VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties{};
+		indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+
+		VkPhysicalDeviceProperties2 properties{};
+		properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+		properties.pNext = &indexingProperties;
+
+		vkGetPhysicalDeviceProperties2(physicalDevice, &properties);
+
+		maxBindlessTextures = std::min(
+			indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+			indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages);
+	}
+
 	void VulkanDevice::CreateLogicalDevice(VkSurfaceKHR surface,
 		std::vector<const char*> extensions) {
 		GraphicsFamily indices = GetGraphicsFamily(physicalDevice, surface);
+		TransferFamily transferFamily = GetTransferFamily(physicalDevice);
+
+		graphicsQueueFamily = indices.graphicsFlagIndex.value();
+		dedicatedTransferQueue = transferFamily.dedicated;
+		transferQueueFamily = dedicatedTransferQueue ? transferFamily.transferFlagIndex.value() : graphicsQueueFamily;
+
+		VkPhysicalDeviceProperties deviceProperties;
+		vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+		timestampPeriod = deviceProperties.limits.timestampPeriod;
+		timestampValidBits = queueFamilies[graphicsQueueFamily].timestampValidBits;
 
 		std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
 		std::set<uint32_t> uniqueQueueFamilies = { indices.graphicsFlagIndex.value(),
-												  indices.presentFlagIndex.value() };
+												  indices.presentFlagIndex.value(),
+												  transferQueueFamily };
 
 		float queuePriority = 1.0f;
 		for (uint32_t queueFamily : uniqueQueueFamilies) 
@@ -144,17 +213,39 @@ namespace BladeEngine::Graphics::Vulkan {
 			queueCreateInfos.push_back(queueCreateInfo);
 		}
 
-		VkPhysicalDeviceFeatures deviceFeatures{};
-		deviceFeatures.samplerAnisotropy = VK_TRUE;
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+		indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+		indexingFeatures.runtimeDescriptorArray = VK_TRUE;
+		indexingFeatures.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+		indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+		indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		indexingFeatures.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+
+		VkPhysicalDeviceFeatures supportedFeatures;
+		vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+
+		textureCompressionBC = supportedFeatures.textureCompressionBC;
+		textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+		pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+
+		// Core features go through VkPhysicalDeviceFeatures2 so descriptor indexing can be chained after them
+		VkPhysicalDeviceFeatures2 deviceFeatures{};
+		deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		deviceFeatures.features.samplerAnisotropy = VK_TRUE;
+		deviceFeatures.features.textureCompressionBC = supportedFeatures.textureCompressionBC;
+		deviceFeatures.features.textureCompressionETC2 = supportedFeatures.textureCompressionETC2;
+		deviceFeatures.features.pipelineStatisticsQuery = supportedFeatures.pipelineStatisticsQuery;
+		deviceFeatures.pNext = descriptorIndexingSupported ? &indexingFeatures : nullptr;
 
 		VkDeviceCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		createInfo.pNext = &deviceFeatures;
 
 		createInfo.queueCreateInfoCount =
 			static_cast<uint32_t>(queueCreateInfos.size());
 		createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
-		createInfo.pEnabledFeatures = &deviceFeatures;
+		createInfo.pEnabledFeatures = nullptr;
 
 		createInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
 		createInfo.ppEnabledExtensionNames = extensions.data();
@@ -180,6 +271,8 @@ namespace BladeEngine::Graphics::Vulkan {
 			&graphicsQueue);
 		vkGetDeviceQueue(logicalDevice, indices.presentFlagIndex.value(), 0,
 			&presentQueue);
+		vkGetDeviceQueue(logicalDevice, transferQueueFamily, 0,
+			&transferQueue);
 	}
 
 }
@@ -22,6 +22,8 @@ SwapChainSupportDetails QuerySwapChainSupport(VkPhysicalDevice device,
 
 class VulkanDevice {
 public:
+  // A VK_NULL_HANDLE surface picks a device for offscreen rendering, any with a
+  // graphics queue, software implementations included
   VulkanDevice(VkInstance instance, VkSurfaceKHR surface,
                std::vector<const char *> extensions);
   ~VulkanDevice();
@@ -32,6 +34,32 @@ public:
   VkQueue graphicsQueue;
   VkQueue presentQueue;
 
+  // Uploads go through transferQueue, it is the graphics queue itself unless
+  // the device exposes a transfer only family (dedicatedTransferQueue)
+  VkQueue transferQueue;
+  uint32_t graphicsQueueFamily = 0;
+  uint32_t transferQueueFamily = 0;
+  bool dedicatedTransferQueue = false;
+
+  // VK_EXT_descriptor_indexing with everything the bindless texture table needs,
+  // enabled on the logical device when available
+  bool descriptorIndexingSupported = false;
+  // Largest update-after-bind sampled image array a single stage can see
+  uint32_t maxBindlessTextures = 0;
+
+  // Block compressed texture families, enabled on the logical device when
+  // available. Desktop GPUs usually only have BC, mobile ones only ETC2
+  bool textureCompressionBC = false;
+  bool textureCompressionETC2 = false;
+
+  // Nanoseconds per timestamp tick, and the bits a timestamp written on the
+  // graphics queue holds. No valid bits means the queue can not write them
+  float timestampPeriod = 0.0f;
+  uint32_t timestampValidBits = 0;
+  // VK_QUERY_TYPE_PIPELINE_STATISTICS queries, enabled on the logical device
+  // when available
+  bool pipelineStatisticsQuery = false;
+
 private:
   // Helper Functions
   bool CheckDeviceExtensionSupport(VkPhysicalDevice physicalDevice,
@@ -42,6 +70,7 @@ private:
 
   void PickPhysicalDevice(VkInstance instance, VkSurfaceKHR surface,
                           std::vector<const char *> extensions);
+  void QueryDescriptorIndexingSupport();
   void CreateLogicalDevice(VkSurfaceKHR surface,
                            std::vector<const char *> extensions);
 };
@@ -7,152 +7,315 @@
 
 using namespace BladeEngine::Graphics::Vulkan;
 
+GraphicsPipelineDescription GraphicsPipelineDescription::Default()
+{
+	GraphicsPipelineDescription description;
+
+	VkDescriptorSetLayoutBinding cameraLayoutBinding{};
+	cameraLayoutBinding.binding = 0;
+	cameraLayoutBinding.descriptorCount = 1;
+	cameraLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+	cameraLayoutBinding.pImmutableSamplers = nullptr;
+	cameraLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+	VkDescriptorSetLayoutBinding samplerLayoutBinding{};
+	samplerLayoutBinding.binding = 0;
+	samplerLayoutBinding.descriptorCount = 1;
+	samplerLayoutBinding.descriptorType =
+		VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	samplerLayoutBinding.pImmutableSamplers = nullptr;
+	samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	description.FrameBindings = { cameraLayoutBinding };
+	description.TextureBindings = { samplerLayoutBinding };
+	description.PushConstantSize = sizeof(PushConstantData);
+
+	return description;
+}
+
 VulkanGraphicsPipeline::VulkanGraphicsPipeline(
 	VkDevice device,
 	VkRenderPass renderPass,
-	VulkanShader* shader) 
-	: m_RenderPass(renderPass)
+	VulkanShader* shader,
+	VkPipelineCache pipelineCache) 
+	: VulkanGraphicsPipeline(device, renderPass, shader, GraphicsPipelineDescription::Default(), pipelineCache)
 {
-	CreateDescriptorSetLayout(device);
-	CreateGraphicsPipeline(device, shader);
 }
 
-VulkanGraphicsPipeline::~VulkanGraphicsPipeline() {}
+VulkanGraphicsPipeline::VulkanGraphicsPipeline(
+	VkDevice device,
+	VkRenderPass renderPass,
+	VulkanShader* shader,
+	const GraphicsPipelineDescription& description,
+	VkPipelineCache pipelineCache) 
+	: m_RenderPass(renderPass), m_Description(description), m_PipelineCache(pipelineCache),
+	m_VertexModule(shader->vertexModule), m_FragmentModule(shader->fragmentModule)
+{
+	CreateDescriptorSetLayouts(device);
+	CreatePipelineLayout(device);
+	CreateDescriptorPool(device);
 
-void VulkanGraphicsPipeline::CreateDescriptorPools(VkDevice device, uint32_t descriptorCount) {
-	//TODO: abstract pool creation to custom shaders
+	graphicsPipeline = GetVariant(device, 0);
+}
 
-	std::array<VkDescriptorPoolSize, 2> poolSizes{};
-	poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	poolSizes[0].descriptorCount = descriptorCount;
-	poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	poolSizes[1].descriptorCount = descriptorCount;
+VulkanGraphicsPipeline::~VulkanGraphicsPipeline() {}
 
-	VkDescriptorPoolCreateInfo poolInfo{};
-	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
-	poolInfo.pPoolSizes = poolSizes.data();
-	poolInfo.maxSets = descriptorCount;
-	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+VkDescriptorSet VulkanGraphicsPipeline::GetFrameDescriptorSet(
+	VkDevice device,
+	VkBuffer uniformBuffer, VkDeviceSize uniformRange,
+	VkBuffer storageBuffer, VkDeviceSize storageRange)
+{
+	DescriptorKey key{ (uint64_t)uniformBuffer, (uint64_t)storageBuffer };
 
-	for (size_t i = 0; i < FRAMES_IN_FLIGHT; i++)
+	auto it = m_FrameSets.find(key);
+	if (it != m_FrameSets.end())
 	{
-		if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPools[i]) !=
-			VK_SUCCESS) {
-			throw std::runtime_error("failed to create descriptor pool!");
-		}
+		m_CacheStatistics.Hits++;
+		return it->second;
 	}
 
-}
+	m_CacheStatistics.Misses++;
 
-void VulkanGraphicsPipeline::CreateDescriptorSets(VkDevice device, uint32_t count, uint32_t frameIndex) {
-	std::vector<VkDescriptorSetLayout> layouts(count, descriptorSetLayout);
-	VkDescriptorSetAllocateInfo allocInfo{};
-	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-	allocInfo.descriptorPool = descriptorPools[frameIndex];
-	allocInfo.descriptorSetCount = count;
-	allocInfo.pSetLayouts = layouts.data();
+	VkDescriptorPool pool;
+	VkDescriptorSet descriptorSet = AllocateDescriptorSet(device, frameDescriptorSetLayout, pool);
 
-	descriptorSets[frameIndex].resize(count);
-	if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets[frameIndex].data()) !=
-		VK_SUCCESS) {
-		throw std::runtime_error("failed to allocate descriptor sets!");
+	std::vector<VkDescriptorBufferInfo> bufferInfos(m_Description.FrameBindings.size());
+	std::vector<VkWriteDescriptorSet> descriptorWrites(m_Description.FrameBindings.size());
+
+	for (size_t i = 0; i < m_Description.FrameBindings.size(); i++)
+	{
+		const auto& binding = m_Description.FrameBindings[i];
+		const bool isStorage = binding.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+
+		bufferInfos[i].buffer = isStorage ? storageBuffer : uniformBuffer;
+		bufferInfos[i].offset = 0;
+		bufferInfos[i].range = isStorage ? storageRange : uniformRange;
+
+		descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrites[i].dstSet = descriptorSet;
+		descriptorWrites[i].dstBinding = binding.binding;
+		descriptorWrites[i].dstArrayElement = 0;
+		descriptorWrites[i].descriptorType = binding.descriptorType;
+		descriptorWrites[i].descriptorCount = 1;
+		descriptorWrites[i].pBufferInfo = &bufferInfos[i];
 	}
+
+	vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+	m_CacheStatistics.Writes += descriptorWrites.size();
+
+	m_FrameSets[key] = descriptorSet;
+	return descriptorSet;
 }
 
-void VulkanGraphicsPipeline::FreeDescriptorSets(VkDevice device, uint32_t frameIndex)
+VkDescriptorSet VulkanGraphicsPipeline::GetTextureDescriptorSet(VkDevice device, VkImageView imageView, VkSampler sampler)
 {
-	if (vkFreeDescriptorSets(device, descriptorPools[frameIndex], descriptorSets[frameIndex].size(), descriptorSets[frameIndex].data()) != VK_SUCCESS)
+	DescriptorKey key{ (uint64_t)imageView, (uint64_t)sampler };
+
+	auto it = m_TextureSets.find(key);
+	if (it != m_TextureSets.end())
 	{
-		throw std::runtime_error("failed to free descriptor sets!");
+		m_CacheStatistics.Hits++;
+		return it->second.first;
 	}
-	descriptorSets[frameIndex].clear();
-}
 
-void VulkanGraphicsPipeline::UpdateDescriptorSet(
-	VkDevice device, VkImageView imageView, 
-	VkSampler sampler, VulkanBuffer& uniformBuffer, 
-	uint32_t frameIndex, int descriptorSetIndex)
-{
-	//TODO: abstract set update to custom shaders
-	//for (size_t i = firstDescriptorSet; i < endDescriptorSet; i++) {
-	VkDescriptorBufferInfo bufferInfo{};
-	bufferInfo.buffer = uniformBuffer.GetBuffer();
-	bufferInfo.offset = 0;
-	bufferInfo.range = sizeof(MVP);
+	m_CacheStatistics.Misses++;
+
+	VkDescriptorPool pool;
+	VkDescriptorSet descriptorSet = AllocateDescriptorSet(device, textureDescriptorSetLayout, pool);
 
 	VkDescriptorImageInfo imageInfo{};
 	imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 	imageInfo.imageView = imageView;
 	imageInfo.sampler = sampler;
 
-	std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
+	VkWriteDescriptorSet descriptorWrite{};
+	descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+	descriptorWrite.dstSet = descriptorSet;
+	descriptorWrite.dstBinding = m_Description.TextureBindings[0].binding;
+	descriptorWrite.dstArrayElement = 0;
+	descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	descriptorWrite.descriptorCount = 1;
+	descriptorWrite.pImageInfo = &imageInfo;
 
-	descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-	descriptorWrites[0].dstSet = descriptorSets[frameIndex][descriptorSetIndex];
-	descriptorWrites[0].dstBinding = 0;
-	descriptorWrites[0].dstArrayElement = 0;
-	descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	descriptorWrites[0].descriptorCount = 1;
-	descriptorWrites[0].pBufferInfo = &bufferInfo;
+	vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+	m_CacheStatistics.Writes++;
 
-	descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-	descriptorWrites[1].dstSet = descriptorSets[frameIndex][descriptorSetIndex];
-	descriptorWrites[1].dstBinding = 1;
-	descriptorWrites[1].dstArrayElement = 0;
-	descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	descriptorWrites[1].descriptorCount = 1;
-	descriptorWrites[1].pImageInfo = &imageInfo;
+	m_TextureSets[key] = { descriptorSet, pool };
+	return descriptorSet;
+}
 
-	vkUpdateDescriptorSets(device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
-	//}
+void VulkanGraphicsPipeline::EvictTexture(VkImageView imageView, uint32_t frameIndex)
+{
+	for (auto it = m_TextureSets.begin(); it != m_TextureSets.end();)
+	{
+		if (it->first.First == (uint64_t)imageView)
+		{
+			// Command buffers of the frames still in flight may have bound the set
+			m_RetiredTextureSets[frameIndex].push_back(it->second);
+			m_CacheStatistics.Evictions++;
+
+			it = m_TextureSets.erase(it);
+		}
+		else
+		{
+			++it;
+		}
+	}
 }
 
-void VulkanGraphicsPipeline::CreateDescriptorSetLayout(VkDevice device) {
-	VkDescriptorSetLayoutBinding uboLayoutBinding{};
-	uboLayoutBinding.binding = 0;
-	uboLayoutBinding.descriptorCount = 1;
-	uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	uboLayoutBinding.pImmutableSamplers = nullptr;
-	uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+void VulkanGraphicsPipeline::FreeRetiredSets(VkDevice device, uint32_t frameIndex)
+{
+	auto& retired = m_RetiredTextureSets[frameIndex];
+	for (auto& [descriptorSet, pool] : retired)
+	{
+		vkFreeDescriptorSets(device, pool, 1, &descriptorSet);
+	}
+	retired.clear();
+}
 
-	VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-	samplerLayoutBinding.binding = 1;
-	samplerLayoutBinding.descriptorCount = 1;
-	samplerLayoutBinding.descriptorType =
-		VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	samplerLayoutBinding.pImmutableSamplers = nullptr;
-	samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+VkDescriptorSet VulkanGraphicsPipeline::AllocateDescriptorSet(VkDevice device, VkDescriptorSetLayout layout, VkDescriptorPool& sourcePool)
+{
+	VkDescriptorSetAllocateInfo allocInfo{};
+	allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	allocInfo.descriptorPool = m_DescriptorPools.back();
+	allocInfo.descriptorSetCount = 1;
+	allocInfo.pSetLayouts = &layout;
+
+	VkDescriptorSet descriptorSet;
+	VkResult result = vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet);
+
+	if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL)
+	{
+		m_DescriptorPoolSize *= 2;
+		CreateDescriptorPool(device);
+
+		allocInfo.descriptorPool = m_DescriptorPools.back();
+		result = vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet);
+	}
+
+	if (result != VK_SUCCESS) {
+		throw std::runtime_error("failed to allocate descriptor set!");
+	}
+
+	m_CacheStatistics.Allocations++;
+
+	sourcePool = allocInfo.descriptorPool;
+	return descriptorSet;
+}
+
+void VulkanGraphicsPipeline::CreateDescriptorPool(VkDevice device) {
+	std::vector<VkDescriptorPoolSize> poolSizes;
+	for (const auto* bindings : { &m_Description.FrameBindings, &m_Description.TextureBindings })
+	{
+		for (const auto& binding : *bindings)
+		{
+			VkDescriptorPoolSize poolSize{};
+			poolSize.type = binding.descriptorType;
+			poolSize.descriptorCount = binding.descriptorCount * m_DescriptorPoolSize;
+			poolSizes.push_back(poolSize);
+		}
+	}
+
+	VkDescriptorPoolCreateInfo poolInfo{};
+	poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+	poolInfo.pPoolSizes = poolSizes.data();
+	poolInfo.maxSets = m_DescriptorPoolSize * 2;
+	// Texture sets are freed individually when their texture is released
+	poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
 
-	std::array<VkDescriptorSetLayoutBinding, 2> bindings = { uboLayoutBinding,
-															samplerLayoutBinding };
+	VkDescriptorPool pool;
+	if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &pool) !=
+		VK_SUCCESS) {
+		throw std::runtime_error("failed to create descriptor pool!");
+	}
+
+	m_DescriptorPools.push_back(pool);
+}
+
+void VulkanGraphicsPipeline::CreateDescriptorSetLayouts(VkDevice device) {
 	VkDescriptorSetLayoutCreateInfo layoutInfo{};
 	layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
-	layoutInfo.pBindings = bindings.data();
+	layoutInfo.bindingCount = static_cast<uint32_t>(m_Description.FrameBindings.size());
+	layoutInfo.pBindings = m_Description.FrameBindings.data();
 
 	if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr,
-		&descriptorSetLayout) != VK_SUCCESS) {
+		&frameDescriptorSetLayout) != VK_SUCCESS) {
 		throw std::runtime_error("failed to create descriptor set layout!");
 	}
+
+	if (m_Description.ExternalTextureSetLayout != VK_NULL_HANDLE) {
+		textureDescriptorSetLayout = m_Description.ExternalTextureSetLayout;
+		return;
+	}
+
+	layoutInfo.bindingCount = static_cast<uint32_t>(m_Description.TextureBindings.size());
+	layoutInfo.pBindings = m_Description.TextureBindings.data();
+
+	if (vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr,
+		&textureDescriptorSetLayout) != VK_SUCCESS) {
+		throw std::runtime_error("failed to create descriptor set layout!");
+	}
+}
+
+VkPipeline VulkanGraphicsPipeline::GetVariant(VkDevice device, ShaderVariantKey key)
+{
+	auto it = m_Variants.find(key);
+	if (it != m_Variants.end())
+	{
+		return it->second;
+	}
+
+	VkPipeline pipeline = CreateVariant(device, key);
+	m_Variants[key] = pipeline;
+
+	return pipeline;
 }
 
-void VulkanGraphicsPipeline::CreateGraphicsPipeline(VkDevice device,
-	VulkanShader* shader) {
+void VulkanGraphicsPipeline::CreatePipelineLayout(VkDevice device)
+{
+	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+
+	VkPushConstantRange pushConstant{};
+	pushConstant.offset = 0;
+	pushConstant.size = m_Description.PushConstantSize;
+	pushConstant.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+	std::array<VkDescriptorSetLayout, 2> setLayouts = { frameDescriptorSetLayout, textureDescriptorSetLayout };
+
+	pipelineLayoutInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+	pipelineLayoutInfo.pSetLayouts = setLayouts.data();
+	pipelineLayoutInfo.pushConstantRangeCount = m_Description.PushConstantSize > 0 ? 1 : 0;
+	pipelineLayoutInfo.pPushConstantRanges = &pushConstant;
+
+	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr,
+		&pipelineLayout) != VK_SUCCESS) {
+		throw std::runtime_error("failed to create pipeline layout!");
+	}
+}
+
+VkPipeline VulkanGraphicsPipeline::CreateVariant(VkDevice device, ShaderVariantKey key)
+{
+	ShaderSpecialization specialization;
+	VulkanShader::GetSpecialization(key, specialization);
+
 	// Setup shader stages of pipeline
 	VkPipelineShaderStageCreateInfo vertShaderStageInfo{};
 	vertShaderStageInfo.sType =
 		VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	vertShaderStageInfo.stage = VK_SHADER_STAGE_VERTEX_BIT;
-	vertShaderStageInfo.module = shader->vertexModule;
+	vertShaderStageInfo.module = m_VertexModule;
 	vertShaderStageInfo.pName = "main";
+	vertShaderStageInfo.pSpecializationInfo = &specialization.Info;
 
 	VkPipelineShaderStageCreateInfo fragShaderStageInfo{};
 	fragShaderStageInfo.sType =
 		VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 	fragShaderStageInfo.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
-	fragShaderStageInfo.module = shader->fragmentModule;
+	fragShaderStageInfo.module = m_FragmentModule;
 	fragShaderStageInfo.pName = "main";
+	fragShaderStageInfo.pSpecializationInfo = &specialization.Info;
 
 	VkPipelineShaderStageCreateInfo shaderStages[] = { vertShaderStageInfo,
 													  fragShaderStageInfo };
@@ -217,7 +380,8 @@ void VulkanGraphicsPipeline::CreateGraphicsPipeline(VkDevice device,
 	colorBlendAttachment.colorWriteMask =
 		VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
 		VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-	colorBlendAttachment.blendEnable = VK_TRUE;
+	// Alpha tested variants only write fully opaque texels, blending them would be wasted bandwidth
+	colorBlendAttachment.blendEnable = (key & ShaderFeatureAlphaTest) ? VK_FALSE : VK_TRUE;
 	colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
 	colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
 	colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
@@ -244,24 +408,6 @@ void VulkanGraphicsPipeline::CreateGraphicsPipeline(VkDevice device,
 	dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
 	dynamicState.pDynamicStates = dynamicStates.data();
 
-	VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
-	pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-
-	VkPushConstantRange pushConstant{};
-	pushConstant.offset = 0;
-	pushConstant.size = sizeof(PushConstantData);
-	pushConstant.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-
-	pipelineLayoutInfo.setLayoutCount = 1;
-	pipelineLayoutInfo.pSetLayouts = &descriptorSetLayout;
-	pipelineLayoutInfo.pushConstantRangeCount = 1;
-	pipelineLayoutInfo.pPushConstantRanges = &pushConstant;
-
-	if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr,
-		&pipelineLayout) != VK_SUCCESS) {
-		throw std::runtime_error("failed to create pipeline layout!");
-	}
-
 	VkGraphicsPipelineCreateInfo pipelineInfo{};
 	pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 	pipelineInfo.stageCount = 2;
@@ -279,17 +425,46 @@ void VulkanGraphicsPipeline::CreateGraphicsPipeline(VkDevice device,
 	pipelineInfo.subpass = 0;
 	pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
-	if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo,
-		nullptr, &graphicsPipeline) != VK_SUCCESS) {
+	VkPipeline pipeline;
+	if (vkCreateGraphicsPipelines(device, m_PipelineCache, 1, &pipelineInfo,
+		nullptr, &pipeline) != VK_SUCCESS) {
 		throw std::runtime_error("failed to create graphics pipeline!");
 	}
 	// end Create pipeline stage
+
+	return pipeline;
 }
 
 void VulkanGraphicsPipeline::Dispose(VkDevice device)
 {
-	vkDestroyPipeline(device, graphicsPipeline, nullptr);
+	for (auto& [key, pipeline] : m_Variants)
+	{
+		vkDestroyPipeline(device, pipeline, nullptr);
+	}
+	m_Variants.clear();
+	graphicsPipeline = VK_NULL_HANDLE;
+
+	vkDestroyShaderModule(device, m_VertexModule, nullptr);
+	vkDestroyShaderModule(device, m_FragmentModule, nullptr);
+
 	vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
-	vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+	vkDestroyDescriptorSetLayout(device, frameDescriptorSetLayout, nullptr);
+	if (m_Description.ExternalTextureSetLayout == VK_NULL_HANDLE)
+		vkDestroyDescriptorSetLayout(device, textureDescriptorSetLayout, nullptr);
+
+	for (auto pool : m_DescriptorPools)
+	{
+		vkDestroyDescriptorPool(device, pool, nullptr);
+	}
+
+	m_DescriptorPools.clear();
+	m_FrameSets.clear();
+	m_TextureSets.clear();
+
+	// Freed along with their pools
+	for (auto& retired : m_RetiredTextureSets)
+	{
+		retired.clear();
+	}
 }
 
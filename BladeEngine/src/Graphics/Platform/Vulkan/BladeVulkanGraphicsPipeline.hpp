@@ -7,39 +7,125 @@
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 
+#include <unordered_map>
+#include <vector>
+
 #define FRAMES_IN_FLIGHT 3  // TODO: Change this define to separate header that all Graphics code can have access to
 
 namespace BladeEngine {
 namespace Graphics {
 namespace Vulkan {
-    
-class VulkanGraphicsPipeline 
+
+// Set 0 holds per-frame buffers bound with dynamic offsets, set 1 holds the texture
+#define FRAME_DESCRIPTOR_SET 0
+#define TEXTURE_DESCRIPTOR_SET 1
+
+struct GraphicsPipelineDescription
+{
+  // Bindings of set 0, only UNIFORM_BUFFER_DYNAMIC and STORAGE_BUFFER_DYNAMIC are supported
+  std::vector<VkDescriptorSetLayoutBinding> FrameBindings;
+  // Bindings of set 1
+  std::vector<VkDescriptorSetLayoutBinding> TextureBindings;
+  // Layout of set 1 owned by someone else (the bindless texture table), replaces TextureBindings when set
+  VkDescriptorSetLayout ExternalTextureSetLayout = VK_NULL_HANDLE;
+  // Size of the vertex stage push constant range, 0 for none
+  uint32_t PushConstantSize = 0;
+
+  // Camera uniform in set 0, texture sampler in set 1 and the model/uv transform push constant
+  static GraphicsPipelineDescription Default();
+};
+
+// Cumulative counters of the pipeline's descriptor cache
+struct DescriptorCacheStatistics
+{
+  uint64_t Hits = 0;
+  uint64_t Misses = 0;
+  uint64_t Allocations = 0;
+  uint64_t Writes = 0;
+  uint64_t Evictions = 0;
+};
+
+// Layout and descriptor caches shared by every variant of one shader. Variants are VkPipelines
+// specialized by a ShaderVariantKey, compiled the first time they are asked for and kept
+class VulkanGraphicsPipeline
 {
 public:
-  VulkanGraphicsPipeline(VkDevice device, VkRenderPass renderPass, VulkanShader* shader);
+  // The pipeline takes over the shader's modules to compile variants later, they are destroyed by Dispose.
+  // pipelineCache may be VK_NULL_HANDLE, variants are then compiled from scratch
+  VulkanGraphicsPipeline(VkDevice device, VkRenderPass renderPass, VulkanShader* shader,
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+  VulkanGraphicsPipeline(VkDevice device, VkRenderPass renderPass, VulkanShader* shader, const GraphicsPipelineDescription& description,
+    VkPipelineCache pipelineCache = VK_NULL_HANDLE);
   ~VulkanGraphicsPipeline();
 
   void Dispose(VkDevice device);
-  
+
   //Init
   VkRenderPass m_RenderPass;
-  VkDescriptorSetLayout descriptorSetLayout;
+  VkDescriptorSetLayout frameDescriptorSetLayout;
+  VkDescriptorSetLayout textureDescriptorSetLayout;
   VkPipelineLayout pipelineLayout;
+  // Variant 0
   VkPipeline graphicsPipeline;
-  
-  //Render Loop
-  std::array<VkDescriptorPool, FRAMES_IN_FLIGHT> descriptorPools;
-  std::array<std::vector<VkDescriptorSet>, FRAMES_IN_FLIGHT> descriptorSets;
-
-  void CreateDescriptorPools(VkDevice device,uint32_t count);
-  void CreateDescriptorSets(VkDevice device,uint32_t count, uint32_t frameIndex);  
-  void FreeDescriptorSets(VkDevice device, uint32_t frameIndex);
-  void UpdateDescriptorSet(VkDevice device,VkImageView imageView, VkSampler sampler, VulkanBuffer& uniformBuffer, uint32_t frameIndex, int descriptorSetIndex);
-  
+
+  // Compiles the variant on first use, every variant shares the layout so bound descriptor sets stay valid
+  VkPipeline GetVariant(VkDevice device, ShaderVariantKey key);
+  uint32_t GetVariantCount() const { return (uint32_t)m_Variants.size(); }
+
+  // Set 0 for the given per-frame buffers, allocated and written the first time the pair is seen.
+  // The arena's buffers live as long as the renderer so the set stays valid, offsets are supplied when binding
+  VkDescriptorSet GetFrameDescriptorSet(VkDevice device, VkBuffer uniformBuffer, VkDeviceSize uniformRange,
+    VkBuffer storageBuffer = VK_NULL_HANDLE, VkDeviceSize storageRange = 0);
+  // Set 1 for the given texture, allocated and written the first time the texture is drawn with this pipeline
+  VkDescriptorSet GetTextureDescriptorSet(VkDevice device, VkImageView imageView, VkSampler sampler);
+  // Drops every cached set referencing the image view and retires them under the frame slot
+  void EvictTexture(VkImageView imageView, uint32_t frameIndex);
+  // Frees the sets retired under the frame slot, the slot's fence must have been waited on
+  void FreeRetiredSets(VkDevice device, uint32_t frameIndex);
+
+  const DescriptorCacheStatistics& GetDescriptorCacheStatistics() const { return m_CacheStatistics; }
+
 private:
-  
-  void CreateDescriptorSetLayout(VkDevice device);
-  void CreateGraphicsPipeline(VkDevice device, VulkanShader *shader);
+  struct DescriptorKey
+  {
+    uint64_t First;
+    uint64_t Second;
+
+    bool operator==(const DescriptorKey& other) const { return First == other.First && Second == other.Second; }
+  };
+
+  struct DescriptorKeyHash
+  {
+    size_t operator()(const DescriptorKey& key) const
+    {
+      return std::hash<uint64_t>()(key.First) ^ (std::hash<uint64_t>()(key.Second) * 0x9E3779B97F4A7C15ull);
+    }
+  };
+
+  GraphicsPipelineDescription m_Description;
+
+  VkPipelineCache m_PipelineCache;
+  VkShaderModule m_VertexModule;
+  VkShaderModule m_FragmentModule;
+
+  std::unordered_map<ShaderVariantKey, VkPipeline> m_Variants;
+
+  // Pools are never reset, a new one twice as large is created when the last one runs out
+  std::vector<VkDescriptorPool> m_DescriptorPools;
+  uint32_t m_DescriptorPoolSize = 64;
+
+  std::unordered_map<DescriptorKey, VkDescriptorSet, DescriptorKeyHash> m_FrameSets;
+  std::unordered_map<DescriptorKey, std::pair<VkDescriptorSet, VkDescriptorPool>, DescriptorKeyHash> m_TextureSets;
+
+  std::vector<std::pair<VkDescriptorSet, VkDescriptorPool>> m_RetiredTextureSets[FRAMES_IN_FLIGHT];
+
+  DescriptorCacheStatistics m_CacheStatistics;
+
+  VkDescriptorSet AllocateDescriptorSet(VkDevice device, VkDescriptorSetLayout layout, VkDescriptorPool& sourcePool);
+  void CreateDescriptorPool(VkDevice device);
+  void CreateDescriptorSetLayouts(VkDevice device);
+  void CreatePipelineLayout(VkDevice device);
+  VkPipeline CreateVariant(VkDevice device, ShaderVariantKey key);
 };
 } // namespace Vulkan
 } // namespace Graphics
@@ -3,6 +3,7 @@
 #include "../../../Core/Base.hpp"
 
 #include <stdexcept>
+#include <string.h>
 
 using namespace BladeEngine::Graphics::Vulkan;
 
@@ -91,6 +92,43 @@ void VulkanInstance::PopulateDebugMessengerCreateInfo(
   createInfo.pfnUserCallback = debugCallback;
 }
 
+// Layers missing on this machine are dropped rather than failing instance
+// creation, build machines usually run without the SDK's validation layers
+static std::vector<const char *>
+GetAvailableLayers(const std::vector<const char *> &requestedLayers)
+{
+  uint32_t layerCount = 0;
+  vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+
+  std::vector<VkLayerProperties> availableLayers(layerCount);
+  vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
+
+  std::vector<const char *> layers;
+  for (const char *layer : requestedLayers)
+  {
+    bool found = false;
+    for (const auto &properties : availableLayers)
+    {
+      if (strcmp(layer, properties.layerName) == 0)
+      {
+        found = true;
+        break;
+      }
+    }
+
+    if (found)
+    {
+      layers.push_back(layer);
+    }
+    else
+    {
+      BLD_CORE_WARN("Vulkan layer {} not available, skipping it", layer);
+    }
+  }
+
+  return layers;
+}
+
 VulkanInstance::VulkanInstance(
     const char *applicationName, const uint32_t applicationVersion,
     const std::vector<const char *> instanceExtensions,
@@ -113,9 +151,11 @@ VulkanInstance::VulkanInstance(
   createInfo.ppEnabledExtensionNames = instanceExtensions.data();
 
   #if defined(BLD_VK_VALIDATION_LAYERS)
+    std::vector<const char *> layers = GetAvailableLayers(validationLayers);
+
     VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo{};
-    createInfo.enabledLayerCount = static_cast<uint32_t>(validationLayers.size());
-    createInfo.ppEnabledLayerNames = validationLayers.data();
+    createInfo.enabledLayerCount = static_cast<uint32_t>(layers.size());
+    createInfo.ppEnabledLayerNames = layers.data();
 
     PopulateDebugMessengerCreateInfo(debugCreateInfo);
     createInfo.pNext = (VkDebugUtilsMessengerCreateInfoEXT *)&debugCreateInfo;
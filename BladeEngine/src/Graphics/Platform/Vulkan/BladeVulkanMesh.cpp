@@ -8,16 +8,30 @@ namespace BladeEngine::Graphics::Vulkan
 {
 	VulkanMesh* LoadMesh(
 		VulkanResourceAllocator& allocator,
-		VkDevice device, 
-		VkQueue graphicsQueue, 
-		VkCommandPool commandPool,
+		VulkanUploadManager& uploadManager,
 		Buffer vertices,
 		Buffer indices)
 	{
 		VulkanMesh* mesh = new VulkanMesh();
 
-		mesh->VertexBuffer = CreateVertexBuffer(allocator, vertices, device, graphicsQueue, commandPool);
-		mesh->IndexBuffer = CreateIndexBuffer(allocator, indices, device, graphicsQueue, commandPool);
+		BufferDescription bufferDescription;
+		bufferDescription.AllocationUsage = BufferAllocationUsage::DeviceLocal;
+		bufferDescription.KeepMapped = false;
+		bufferDescription.Data = nullptr;
+
+		bufferDescription.Usage = BufferUsage::Vertex | BufferUsage::TransferDestination;
+		bufferDescription.Size = vertices.Size;
+		mesh->VertexBuffer = new VulkanBuffer(bufferDescription, allocator);
+
+		bufferDescription.Usage = BufferUsage::Index | BufferUsage::TransferDestination;
+		bufferDescription.Size = indices.Size;
+		mesh->IndexBuffer = new VulkanBuffer(bufferDescription, allocator);
+
+		uploadManager.UploadBuffer(mesh->VertexBuffer->GetBuffer(), vertices.Data, vertices.Size,
+			VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+		mesh->UploadID = uploadManager.UploadBuffer(mesh->IndexBuffer->GetBuffer(), indices.Data, indices.Size,
+			VK_ACCESS_INDEX_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+
 		mesh->IndicesCount = indices.Size / sizeof(uint16_t);
 		
 		return mesh;
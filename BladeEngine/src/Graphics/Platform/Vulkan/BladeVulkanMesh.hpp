@@ -2,6 +2,7 @@
 
 #include "BladeVulkanUtils.hpp"
 #include "VulkanBuffer.hpp"
+#include "VulkanUploadManager.hpp"
 
 #include "../../Vertex.hpp"
 #include "../../../Core/Buffer.hpp"
@@ -20,6 +21,9 @@ namespace BladeEngine::Graphics::Vulkan
 
 		uint32_t IndicesCount;
 
+		// Upload manager submission carrying both buffers
+		uint64_t UploadID = 0;
+
 		void Draw(
 			VkCommandBuffer commandBuffer, VkPipelineLayout& pipelineLayout, 
 			VkDescriptorSet& descriptorSet);
@@ -27,11 +31,10 @@ namespace BladeEngine::Graphics::Vulkan
 		void Dispose(VkDevice device);
 	};
 
+	// Creates the device local buffers and queues their contents on the upload manager
 	VulkanMesh* LoadMesh(
 		VulkanResourceAllocator& allocator,
-		VkDevice device,
-		VkQueue graphicsQueue,
-		VkCommandPool commandPool,
+		VulkanUploadManager& uploadManager,
 		Buffer vertices,
 		Buffer indices);
 
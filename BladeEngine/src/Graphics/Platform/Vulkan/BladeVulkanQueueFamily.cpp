@@ -22,10 +22,28 @@ TransferFamily BladeEngine::Graphics::Vulkan::GetTransferFamily(
   vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount,
                                            queueFamilies.data());
 
+  // Prefer a family made for DMA only, uploads there run alongside rendering
+  // instead of queuing behind it. Graphics and compute queues support
+  // transfers implicitly so the fallback is any family that reports them
   int i = 0;
   for (const auto &queueFamily : queueFamilies) {
 
-    if (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) {
+    if ((queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) &&
+        !(queueFamily.queueFlags &
+          (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+      family.transferFlagIndex = i;
+      family.dedicated = true;
+      return family;
+    }
+
+    i++;
+  }
+
+  i = 0;
+  for (const auto &queueFamily : queueFamilies) {
+
+    if (queueFamily.queueFlags &
+        (VK_QUEUE_TRANSFER_BIT | VK_QUEUE_GRAPHICS_BIT)) {
       family.transferFlagIndex = i;
     }
 
@@ -85,12 +103,20 @@ GraphicsFamily BladeEngine::Graphics::Vulkan::GetGraphicsFamily(
       family.graphicsFlagIndex = i;
     }
 
+    // Without a surface nothing is presented, the graphics family stands in
+    // for the present one
     VkBool32 presentSupport = false;
-    vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface,
-                                         &presentSupport);
+    if (surface != VK_NULL_HANDLE) {
+      vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, surface,
+                                           &presentSupport);
+    } else {
+      presentSupport = family.graphicsFlagIndex.has_value();
+    }
 
     if (presentSupport) {
-      family.presentFlagIndex = i;
+      family.presentFlagIndex = surface != VK_NULL_HANDLE
+                                    ? i
+                                    : family.graphicsFlagIndex.value();
     }
 
     if (family.IsComplete()) {
@@ -20,6 +20,8 @@ struct GraphicsFamily {
   bool IsComplete();
 };
 
+// surface may be VK_NULL_HANDLE for offscreen rendering, the present family is
+// then the graphics one
 GraphicsFamily GetGraphicsFamily(VkPhysicalDevice physicalDevice,
                                  VkSurfaceKHR surface);
 
@@ -34,6 +36,8 @@ ComputeFamily GetComputeFamily(VkPhysicalDevice physicalDevice);
 struct TransferFamily {
   VkQueueFlagBits f;
   std::optional<uint32_t> transferFlagIndex;
+  // True when the family has neither graphics nor compute capabilities
+  bool dedicated = false;
   bool IsComplete();
 };
 
@@ -5,8 +5,11 @@
 #include "VulkanCheck.hpp"
 
 #include "../../Shader.hpp"
-#include "../../MSDFData.hpp"
+#include "../../../Core/Profiler.hpp"
 
+#include <glm/gtc/packing.hpp>
+
+#include <algorithm>
 #include <string.h>
 #include <utility>
 
@@ -21,6 +24,32 @@ namespace BladeEngine::Graphics::Vulkan
 
 	VulkanRenderer::~VulkanRenderer()
 	{
+		WaitDeviceIdle();
+		for (uint32_t frame = 0; frame < FRAMES_IN_FLIGHT; frame++)
+		{
+			DisposeRetiredTextures(frame);
+		}
+
+		delete m_TextLayoutCache;
+		delete m_TextBatcher;
+		delete m_SpriteBatcher;
+		delete m_FrameArena;
+
+		m_UploadManager->Dispose();
+		delete m_UploadManager;
+
+		m_GPUProfiler->Dispose(vkDevice->logicalDevice);
+		delete m_GPUProfiler;
+
+		SavePipelineCache();
+		m_PipelineCache->Dispose(vkDevice->logicalDevice);
+		delete m_PipelineCache;
+
+		if (m_BindlessTextures)
+		{
+			m_BindlessTextures->Dispose(vkDevice->logicalDevice);
+			delete m_BindlessTextures;
+		}
 
 		delete m_ResourceAllocator;
 	}
@@ -36,21 +65,54 @@ namespace BladeEngine::Graphics::Vulkan
 		defaultSpriteVertexShader = new Shader("assets/shaders/default.vert", ShaderType::VERTEX);
 		defaultSpriteFragmentShader = new Shader("assets/shaders/default.frag", ShaderType::FRAGMENT);
 
-		defaultTextVertexShader = new Shader("assets/shaders/defaultText.vert", ShaderType::VERTEX);
 		defaultTextFragmentShader = new Shader("assets/shaders/defaultText.frag", ShaderType::FRAGMENT);
 
+		instancedSpriteVertexShader = new Shader("assets/shaders/spriteInstanced.vert", ShaderType::VERTEX);
+		instancedSpriteFragmentShader = new Shader("assets/shaders/spriteInstanced.frag", ShaderType::FRAGMENT);
+
+		const bool headless = window->IsHeadless();
+
 		std::vector<const char*> extensions = window->GetRequiredExtensions();
 		extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 		vkInstance = new VulkanInstance("Blade GDK Program", VK_MAKE_VERSION(1, 0, 0), extensions, { "VK_LAYER_KHRONOS_validation" });
-		vkSurface = window->CreateWindowSurface(vkInstance->instance);
-		vkDevice = new VulkanDevice(vkInstance->instance, vkSurface,
-			{ VK_KHR_SWAPCHAIN_EXTENSION_NAME });
+
+		std::vector<const char*> deviceExtensions;
+		if (!headless)
+		{
+			vkSurface = window->CreateWindowSurface(vkInstance->instance);
+			deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+		}
+
+		vkDevice = new VulkanDevice(vkInstance->instance, vkSurface, deviceExtensions);
 
 		m_ResourceAllocator = new VulkanResourceAllocator(vkInstance->instance, vkDevice);
 
-		vkSwapchain = new VulkanSwapchain(window->GetWidth(), window->GetHeight(), vkDevice->physicalDevice,
-			vkDevice->logicalDevice, vkSurface);
+		if (headless)
+		{
+			// One image per frame in flight, so an image is only reused once its frame's fence signaled
+			m_OffscreenTarget = new VulkanOffscreenTarget(window->GetWidth(), window->GetHeight(), FRAMES_IN_FLIGHT,
+				vkDevice->physicalDevice, vkDevice->logicalDevice, *m_ResourceAllocator);
+			m_RenderTarget = m_OffscreenTarget;
+
+			VkPhysicalDeviceProperties properties;
+			vkGetPhysicalDeviceProperties(vkDevice->physicalDevice, &properties);
+			BLD_CORE_INFO("Rendering offscreen at {}x{} on {}", window->GetWidth(), window->GetHeight(), properties.deviceName);
+		}
+		else
+		{
+			vkSwapchain = new VulkanSwapchain(window->GetWidth(), window->GetHeight(), vkDevice->physicalDevice,
+				vkDevice->logicalDevice, vkSurface);
+			m_RenderTarget = vkSwapchain;
+		}
+
 
+		// Ring the pending uploads of a frame are staged in, larger uploads get a buffer of their own
+		static const uint64_t uploadStagingSize = 32 * 1024 * 1024;
+		m_UploadManager = new VulkanUploadManager(vkDevice, *m_ResourceAllocator, uploadStagingSize);
+
+		// Relative to the working directory like the assets, written back by SavePipelineCache
+		static const char* pipelineCachePath = "cache/pipelines.bin";
+		m_PipelineCache = new VulkanPipelineCache(vkDevice->physicalDevice, vkDevice->logicalDevice, pipelineCachePath);
 
 		CreateClearRenderPass();
 		CreateClearFramebuffer();
@@ -59,404 +121,554 @@ namespace BladeEngine::Graphics::Vulkan
 		CreateCommandBuffers();
 		CreateSyncObjects();
 
+		// Clear, sprites and text, with room for passes added later
+		static const uint32_t maxGPUProfilerScopes = 8;
+		m_GPUProfiler = new VulkanGPUProfiler(vkDevice, FRAMES_IN_FLIGHT, maxGPUProfilerScopes);
+
 		VulkanRenderPass* renderPass = new VulkanRenderPass(
-			vkDevice, vkSwapchain->imageFormat, 
-			vkSwapchain->FindDepthFormat(vkDevice->physicalDevice));
+			vkDevice, m_RenderTarget->imageFormat, 
+			m_RenderTarget->FindDepthFormat(vkDevice->physicalDevice), m_RenderTarget->finalLayout);
 		m_RenderPasses.push_back(renderPass);
 
-		static const size_t maxQuadCount = 1000;
-		static const size_t maxCharCount = 1000;
+		// Quads per sprite vertex page, a batch never crosses pages
+		static const size_t spriteQuadsPerPage = 4096;
+		static const uint64_t frameArenaChunkSize = 4 * 1024 * 1024;
+		// Upper bound of the bindless table, further limited by the device
+		static const uint32_t bindlessTextureCapacity = 16384;
+		// Strings kept laid out once they stop being drawn, and the longest string one layout can hold
+		static const uint32_t textLayoutCacheCapacity = 512;
+		static const uint32_t maxGlyphsPerString = 16384;
+		static const size_t textGlyphsPerPage = 4096;
 
 		VulkanShader vkDefaultSpriteShader = VulkanShader(vkDevice->logicalDevice, defaultSpriteVertexShader->data, defaultSpriteFragmentShader->data);
 		VulkanGraphicsPipeline* vkSpriteGraphicsPipeline = new VulkanGraphicsPipeline(
-			vkDevice->logicalDevice, renderPass->GetRenderPass(), &vkDefaultSpriteShader);
-		vkSpriteGraphicsPipeline->CreateDescriptorPools(vkDevice->logicalDevice, maxQuadCount); // :))
+			vkDevice->logicalDevice, renderPass->GetRenderPass(), &vkDefaultSpriteShader, m_PipelineCache->GetPipelineCache());
 		m_GraphicsPipelinesMap[renderPass].push_back(vkSpriteGraphicsPipeline);
 
-		VulkanShader vkDefaultTextShader = VulkanShader(vkDevice->logicalDevice, defaultTextVertexShader->data, defaultTextFragmentShader->data);
+		// Camera and the instance page in set 0, both bound with dynamic offsets, texture in set 1
+		GraphicsPipelineDescription instancedSpriteDescription = GraphicsPipelineDescription::Default();
+		instancedSpriteDescription.PushConstantSize = 0;
+
+		VkDescriptorSetLayoutBinding instanceLayoutBinding{};
+		instanceLayoutBinding.binding = 1;
+		instanceLayoutBinding.descriptorCount = 1;
+		instanceLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+		instanceLayoutBinding.pImmutableSamplers = nullptr;
+		instanceLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+		instancedSpriteDescription.FrameBindings.push_back(instanceLayoutBinding);
+
+		// Glyphs are sprite instances too, only the fragment shader differs
+		VulkanShader vkDefaultTextShader = VulkanShader(vkDevice->logicalDevice, instancedSpriteVertexShader->data, defaultTextFragmentShader->data);
 		VulkanGraphicsPipeline* vkTextGraphicsPipeline = new VulkanGraphicsPipeline(
-			vkDevice->logicalDevice, renderPass->GetRenderPass(), &vkDefaultTextShader);
-		vkTextGraphicsPipeline->CreateDescriptorPools(vkDevice->logicalDevice, maxQuadCount); // :))
+			vkDevice->logicalDevice, renderPass->GetRenderPass(), &vkDefaultTextShader, instancedSpriteDescription,
+			m_PipelineCache->GetPipelineCache());
 		m_GraphicsPipelinesMap[renderPass].push_back(vkTextGraphicsPipeline);
 
-		vkSwapchain->CreateFramebuffers(vkDevice->logicalDevice, renderPass->GetRenderPass());
+		VulkanShader vkInstancedSpriteShader = VulkanShader(vkDevice->logicalDevice, instancedSpriteVertexShader->data, instancedSpriteFragmentShader->data);
+		VulkanGraphicsPipeline* vkInstancedSpriteGraphicsPipeline = new VulkanGraphicsPipeline(
+			vkDevice->logicalDevice, renderPass->GetRenderPass(), &vkInstancedSpriteShader, instancedSpriteDescription,
+			m_PipelineCache->GetPipelineCache());
+		m_GraphicsPipelinesMap[renderPass].push_back(vkInstancedSpriteGraphicsPipeline);
 
+		if (vkDevice->descriptorIndexingSupported)
+		{
+			m_BindlessTextures = new VulkanBindlessTextureTable(vkDevice->logicalDevice,
+				std::min(bindlessTextureCapacity, vkDevice->maxBindlessTextures));
+
+			bindlessSpriteVertexShader = new Shader("assets/shaders/spriteBindless.vert", ShaderType::VERTEX);
+			bindlessSpriteFragmentShader = new Shader("assets/shaders/spriteBindless.frag", ShaderType::FRAGMENT);
+
+			// Same frame bindings as the instanced path, set 1 is the texture table itself
+			GraphicsPipelineDescription bindlessSpriteDescription = instancedSpriteDescription;
+			bindlessSpriteDescription.TextureBindings.clear();
+			bindlessSpriteDescription.ExternalTextureSetLayout = m_BindlessTextures->GetDescriptorSetLayout();
+
+			VulkanShader vkBindlessSpriteShader = VulkanShader(vkDevice->logicalDevice, bindlessSpriteVertexShader->data, bindlessSpriteFragmentShader->data);
+			VulkanGraphicsPipeline* vkBindlessSpriteGraphicsPipeline = new VulkanGraphicsPipeline(
+				vkDevice->logicalDevice, renderPass->GetRenderPass(), &vkBindlessSpriteShader, bindlessSpriteDescription,
+				m_PipelineCache->GetPipelineCache());
+			m_GraphicsPipelinesMap[renderPass].push_back(vkBindlessSpriteGraphicsPipeline);
+		}
 
-		m_TextQuadCounts.resize(maxQuadCount);
+		// Variants every frame ends up using are compiled now rather than on their first draw
+		for (VulkanGraphicsPipeline* pipeline : m_GraphicsPipelinesMap[renderPass])
+		{
+			pipeline->GetVariant(vkDevice->logicalDevice, ShaderFeatureAlphaTest);
+			pipeline->GetVariant(vkDevice->logicalDevice, ShaderFeatureTint);
+		}
 
-		BufferDescription textVertexBufferDescription;
-		textVertexBufferDescription.Usage = BufferUsage::Vertex;
-		textVertexBufferDescription.AllocationUsage = BufferAllocationUsage::HostWrite;
-		textVertexBufferDescription.KeepMapped = true;
-		textVertexBufferDescription.Size = maxCharCount * 4 * sizeof(VertexColorTexture);
+		m_RenderTarget->CreateFramebuffers(vkDevice->logicalDevice, renderPass->GetRenderPass());
 
-		BufferDescription textIndexBufferDescription;
-		textIndexBufferDescription.Usage = BufferUsage::Index;
-		textIndexBufferDescription.AllocationUsage = BufferAllocationUsage::HostWrite;
-		textIndexBufferDescription.KeepMapped = true;
-		textIndexBufferDescription.Size = maxCharCount * 6 * sizeof(uint16_t);
+		m_FrameArena = new VulkanFrameArena(*m_ResourceAllocator, vkDevice->physicalDevice, frameArenaChunkSize);
+		m_SpriteBatcher = new VulkanSpriteBatcher(*m_ResourceAllocator, *m_FrameArena, spriteQuadsPerPage);
+		m_TextBatcher = new VulkanSpriteBatcher(*m_ResourceAllocator, *m_FrameArena, textGlyphsPerPage);
+		m_TextLayoutCache = new TextLayoutCache(textLayoutCacheCapacity, maxGlyphsPerString);
+	}
 
-		for (int i = 0; i < FRAMES_IN_FLIGHT; i++)
+	void VulkanRenderer::BeginDrawing()
+	{
+		BLD_PROFILE_FUNCTION();
+
+		// Sprites and strings are written straight into this frame's mapped buffers,
+		// so the GPU has to be done with them before any draw call is recorded
 		{
-			m_UniformBuffers[i].resize(2 * maxQuadCount);
+			BLD_PROFILE_SCOPE("Wait For Frame Fence");
+			vkWaitForFences(vkDevice->logicalDevice, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+		}
 
-			m_TextIndexBuffers[i].resize(maxQuadCount);
-			m_TextVertexBuffers[i].resize(maxQuadCount);
+		// The fence covers the queries the slot wrote last time, reading them does not wait
+		m_GPUProfiler->Resolve(vkDevice->logicalDevice, currentFrame);
 
-			for (int j = 0; j < maxQuadCount; j++)
-			{
-				m_UniformBuffers[i][j * 2 + 0] = CreateUniformBuffer(*m_ResourceAllocator, sizeof(MVP));
-				m_UniformBuffers[i][j * 2 + 1] = CreateUniformBuffer(*m_ResourceAllocator, sizeof(MVP));
+		m_FrameNumber++;
 
-				m_TextVertexBuffers[i][j] = new VulkanBuffer(textVertexBufferDescription, *m_ResourceAllocator);
-				m_TextIndexBuffers[i][j] = new VulkanBuffer(textIndexBufferDescription, *m_ResourceAllocator);
-			}
+		m_FrameArena->Reset(currentFrame);
+		m_UploadManager->Update(m_FrameNumber);
+		m_SpriteBatcher->Begin(m_SpriteRenderMode);
+		m_TextBatcher->Begin(SpriteRenderMode::Instanced);
+
+		m_SpriteQueue.Clear();
+		m_SpriteDraws.clear();
+
+		m_TextLayoutCache->BeginFrame(m_FrameNumber);
+
+		if (m_BindlessTextures)
+		{
+			m_BindlessTextures->BeginFrame(currentFrame);
 		}
-	}
 
-	void VulkanRenderer::BeginDrawing()
-	{
-	
-		m_TextCount = 0;
-		m_UniformBufferCount = 0;
+		DisposeRetiredTextures(currentFrame);
+		m_RetireFrame = currentFrame;
+		m_DeviceIdle = false;
+
+		m_FrameStatistics = RenderStatistics();
+		m_DescriptorStatisticsAtFrameStart = GetDescriptorCacheStatistics();
 	}
 
 	void VulkanRenderer::DrawSprite(
 		Texture2D* texture, 
 		const glm::mat4& transform,
-		const glm::vec4& uvTransform)
+		const glm::vec4& uvTransform,
+		uint8_t layer)
 	{
 		VulkanTexture* vkTexture = (VulkanTexture*)texture->GetGPUTexture();
 
-		VulkanMesh* vkMesh = (VulkanMesh*)Mesh::Quad()->GetGPUMesh();
+		// Textures without partial alpha are drawn alpha tested, with blending off
+		const bool translucent = texture->HasTranslucency();
+		const ShaderVariantKey variant = translucent ? 0 : ShaderFeatureAlphaTest;
 
-		PushConstantData pushConstant{};
-		pushConstant.UVTransform = uvTransform;
+		// Every sprite of a frame shares the mode's pipeline, so the variant stands in for the pipeline id
+		uint64_t sortKey = RenderQueue::MakeSortKey(
+			layer, translucent, transform[3].z, (uint8_t)variant, vkTexture->SortID);
 
-		vkTextures.push_back(vkTexture);
-		vkMeshes.push_back(vkMesh);
-		vkMeshesModelData.push_back(transform);
-		m_PushConstantsData.push_back(pushConstant);
+		m_SpriteQueue.Submit(sortKey, (uint32_t)m_SpriteDraws.size());
+		m_SpriteDraws.push_back({ vkTexture, transform, uvTransform, variant });
 	}
 
-	// TODO: Move this into UniformBuffer wraper class later
-	void UpdateUniformBuffer(VulkanBuffer& uniformBuffer, MVP data)
+	void VulkanRenderer::SubmitSortedSprites()
 	{
-		memcpy(uniformBuffer.Map(), &data, sizeof(data));
-	}
+		BLD_PROFILE_FUNCTION();
 
-	void VulkanRenderer::EndDrawing()
-	{
-		const auto renderPass = m_RenderPasses[0];
-		auto currentPipeline = m_GraphicsPipelinesMap[renderPass][0];
+		m_SpriteQueue.Sort();
 
-		vkWaitForFences(vkDevice->logicalDevice, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
-		
-		if (currentPipeline->descriptorSets[currentFrame].size() > 0)
-			currentPipeline->FreeDescriptorSets(vkDevice->logicalDevice, currentFrame);
-
-		currentPipeline->CreateDescriptorSets(vkDevice->logicalDevice, vkMeshes.size(), currentFrame);
+		VulkanGraphicsPipeline* spritePipeline = GetSpritePipeline(m_SpriteBatcher->GetMode());
 
-		uint32_t i;
-		for (i = 0; i < vkMeshes.size(); i++)
+		for (const auto& command : m_SpriteQueue.GetCommands())
 		{
-			MVP mvp{};
-			auto data = vkMeshesModelData[i];
-
-			mvp.model = data;
-
-			mvp.view = camera->GetViewMatrix();
-			mvp.proj = camera->GetProjectionMatrix();
-
-			UpdateUniformBuffer(*m_UniformBuffers[currentFrame][i], mvp);
-			auto vkTexture = vkTextures[i];
-
-			currentPipeline->UpdateDescriptorSet(
-				vkDevice->logicalDevice,
-				vkTexture->textureImageView,
-				vkTexture->textureSampler,
-				*m_UniformBuffers[currentFrame][i], currentFrame, i);
+			const SpriteDrawData& sprite = m_SpriteDraws[command.Payload];
+			m_SpriteBatcher->Submit(spritePipeline, sprite.Variant, sprite.Texture, sprite.Transform, sprite.UVTransform);
 		}
+	}
 
-		currentPipeline = m_GraphicsPipelinesMap[renderPass][1];
-
-		if (currentPipeline->descriptorSets[currentFrame].size() > 0)
-			currentPipeline->FreeDescriptorSets(vkDevice->logicalDevice, currentFrame);
+	void VulkanRenderer::SubmitText()
+	{
+		BLD_PROFILE_FUNCTION();
 
-		currentPipeline->CreateDescriptorSets(vkDevice->logicalDevice, m_TextCount, currentFrame);
+		// Strings sharing an atlas and variant become one contiguous run of glyphs, and so a single instanced draw
+		std::stable_sort(m_TextDraws.begin(), m_TextDraws.end(),
+			[](const TextDrawData& a, const TextDrawData& b)
+			{
+				return a.Texture->SortID != b.Texture->SortID ? a.Texture->SortID < b.Texture->SortID : a.Variant < b.Variant;
+			});
 
-		// auto debugTexture = (VulkanTexture*)m_UVDebugTexture->GetGPUTexture();
+		VulkanGraphicsPipeline* textPipeline = m_GraphicsPipelinesMap[m_RenderPasses[0]][1];
 
-		for (uint32_t j = 0; j < m_TextCount; j++, i++)
+		for (const auto& textDraw : m_TextDraws)
 		{
-			MVP mvp{};
-			auto data = vkMeshesModelData[i];
+			const glm::mat4& transform = textDraw.Transform;
+			const uint32_t depth = (uint32_t)glm::packHalf1x16(transform[3].z) << 16;
 
-			mvp.model = data;
+			for (const GlyphQuad& glyph : textDraw.Layout->Glyphs)
+			{
+				const glm::vec2 size = glyph.PlaneMax - glyph.PlaneMin;
+				const glm::vec2 center = (glyph.PlaneMin + glyph.PlaneMax) * 0.5f;
+
+				// The unit quad's top left corner samples the uv offset, so the rect starts at the glyph's top edge
+				SpriteInstanceData instance;
+				instance.Basis = glm::vec4(glm::vec2(transform[0]) * size.x, glm::vec2(transform[1]) * size.y);
+				instance.Translation = glm::vec2(transform * glm::vec4(center, 0.0f, 1.0f));
+				instance.Tint = textDraw.Layout->Tint;
+				instance.DepthTexture = depth;
+				instance.UVRect = glm::vec4(glyph.UVMin.x, glyph.UVMax.y,
+					glyph.UVMax.x - glyph.UVMin.x, glyph.UVMin.y - glyph.UVMax.y);
+
+				m_TextBatcher->SubmitInstance(textPipeline, textDraw.Variant, textDraw.Texture, instance);
+			}
+		}
+	}
 
-			mvp.view = camera->GetViewMatrix();
-			mvp.proj = camera->GetProjectionMatrix();
+	VulkanGraphicsPipeline* VulkanRenderer::GetSpritePipeline(SpriteRenderMode mode)
+	{
+		const auto& pipelines = m_GraphicsPipelinesMap[m_RenderPasses[0]];
 
-			UpdateUniformBuffer(*m_UniformBuffers[currentFrame][i], mvp);
-			auto vkTexture = vkTextures[i];
+		switch (mode)
+		{
+		case SpriteRenderMode::Instanced:
+			return pipelines[2];
+		case SpriteRenderMode::Bindless:
+			return pipelines[3];
+		default:
+			return pipelines[0];
+		}
+	}
 
-			currentPipeline->UpdateDescriptorSet(
-				vkDevice->logicalDevice,
-				vkTexture->textureImageView,
-				vkTexture->textureSampler,
-				*m_UniformBuffers[currentFrame][i], currentFrame, j);
+	void VulkanRenderer::SetSpriteRenderMode(SpriteRenderMode mode)
+	{
+		if (mode == SpriteRenderMode::Bindless && !m_BindlessTextures)
+		{
+			BLD_CORE_WARN("Bindless sprites need descriptor indexing, using instanced sprites instead");
+			mode = SpriteRenderMode::Instanced;
 		}
 
-		DrawFrame();
+		m_SpriteRenderMode = mode;
+	}
+
+	DescriptorCacheStatistics VulkanRenderer::GetDescriptorCacheStatistics()
+	{
+		DescriptorCacheStatistics total;
+		for (auto pipeline : m_GraphicsPipelinesMap[m_RenderPasses[0]])
+		{
+			const auto& statistics = pipeline->GetDescriptorCacheStatistics();
+			total.Hits += statistics.Hits;
+			total.Misses += statistics.Misses;
+			total.Allocations += statistics.Allocations;
+			total.Writes += statistics.Writes;
+			total.Evictions += statistics.Evictions;
+		}
 
-		vkTextures.clear();
-		vkMeshes.clear();
-		vkMeshesModelData.clear();
-		m_PushConstantsData.clear();
+		return total;
 	}
 
-	void VulkanRenderer::DrawString(const std::string& string, Font* font, 
-		const glm::mat4& transform)
+	void VulkanRenderer::EndDrawing()
 	{
-		Buffer vertexBuffer;
-		vertexBuffer.Allocate(4 * string.size() * sizeof(VertexColorTexture));
+		BLD_PROFILE_FUNCTION();
 
-		VertexColorTexture* vertexBufferData = vertexBuffer.As<VertexColorTexture>();
+		// Every pipeline reads the camera from the same per-frame uniform through a dynamic offset
+		CameraData cameraData{};
+		cameraData.ViewProjection = camera->GetProjectionMatrix() * camera->GetViewMatrix();
 
-		Buffer indexBuffer;
-		indexBuffer.Allocate(6 * string.size() * sizeof(uint16_t));
+		m_CameraUniformBuffer = m_FrameArena->AllocateUniform(sizeof(CameraData));
+		memcpy(m_CameraUniformBuffer.Data, &cameraData, sizeof(CameraData));
 
-		uint16_t* indexBufferData = indexBuffer.As<uint16_t>();
+		SubmitSortedSprites();
+		SubmitText();
 
-		struct TextParams
-		{
-			glm::vec4 Color{ 1.0f, 0.5f, 1.0f, 1.0f };
-			float Kerning = 0.0f;
-			float LineSpacing = 0.0f;
-		};
+		m_FrameStatistics.SpriteBatches = (uint32_t)m_SpriteBatcher->GetBatches().size();
+		m_FrameStatistics.Sprites = m_SpriteBatcher->GetQuadCount();
+		m_FrameStatistics.Strings = (uint32_t)m_TextDraws.size();
+		m_FrameStatistics.Glyphs = m_TextBatcher->GetQuadCount();
 
-		TextParams textParams;
+		const auto& textLayoutStatistics = m_TextLayoutCache->GetFrameStatistics();
+		m_FrameStatistics.TextLayoutCacheHits = textLayoutStatistics.Hits;
+		m_FrameStatistics.TextLayoutCacheMisses = textLayoutStatistics.Misses;
+		m_FrameStatistics.TextLayoutMilliseconds = textLayoutStatistics.LayoutMilliseconds;
 
-		const auto& fontGeometry = font->GetMSDFData()->FontGeometry;
-		const auto& metrics = fontGeometry.getMetrics();
-		Texture2D* fontAtlas = font->GetAtlasTexture();
+		DrawFrame();
 
-		vkTextures.push_back((VulkanTexture*)fontAtlas->GetGPUTexture());
+		m_FrameStatistics.TransientMemoryUsed = m_FrameArena->GetUsedSize();
 
-		double x = 0.0;
-		double fsScale = 1.0 / (metrics.ascenderY - metrics.descenderY);
-		double y = 0.0;
+		const auto& uploadStatistics = m_UploadManager->GetFrameStatistics();
+		m_FrameStatistics.Uploads = uploadStatistics.Uploads;
+		m_FrameStatistics.UploadSubmissions = uploadStatistics.Submissions;
+		m_FrameStatistics.UploadedBytes = uploadStatistics.Bytes;
+		m_UploadManager->ResetFrameStatistics();
 
-		const float spaceGlyphAdvance = fontGeometry.getGlyph(' ')->getAdvance();
+		DescriptorCacheStatistics descriptorStatistics = GetDescriptorCacheStatistics();
+		m_FrameStatistics.DescriptorCacheHits = (uint32_t)(descriptorStatistics.Hits - m_DescriptorStatisticsAtFrameStart.Hits);
+		m_FrameStatistics.DescriptorCacheMisses = (uint32_t)(descriptorStatistics.Misses - m_DescriptorStatisticsAtFrameStart.Misses);
+		m_FrameStatistics.DescriptorSetAllocations = (uint32_t)(descriptorStatistics.Allocations - m_DescriptorStatisticsAtFrameStart.Allocations);
+		m_FrameStatistics.DescriptorWrites = (uint32_t)(descriptorStatistics.Writes - m_DescriptorStatisticsAtFrameStart.Writes);
 
-		uint32_t quadCount = 0;
+		m_LastFrameStatistics = m_FrameStatistics;
 
-		for (size_t i = 0; i < string.size(); i++)
-		{
-			char character = string[i];
-			if (character == '\r')
-				continue;
+		m_TextDraws.clear();
+	}
 
-			if (character == '\n')
-			{
-				x = 0;
-				y -= fsScale * metrics.lineHeight + textParams.LineSpacing;
-				continue;
-			}
+	void VulkanRenderer::DrawString(const std::string& string, Font* font, 
+		const glm::mat4& transform, bool outline)
+	{
+		if (string.empty())
+			return;
 
-			if (character == ' ')
-			{
-				float advance = spaceGlyphAdvance;
-				if (i < string.size() - 1)
-				{
-					char nextCharacter = string[i + 1];
-					double dAdvance;
-					fontGeometry.getAdvance(dAdvance, character, nextCharacter);
-					advance = (float)dAdvance;
-				}
+		TextLayoutParams textParams;
 
-				x += fsScale * advance + textParams.Kerning;
-				continue;
-			}
+		// Laid out once per distinct string, later frames reuse the cached glyph quads
+		const CachedTextLayout* layout = m_TextLayoutCache->Get(string, font, textParams);
+		if (!layout)
+			return;
 
-			if (character == '\t')
-			{
-				x += 4.0f * (fsScale * spaceGlyphAdvance + textParams.Kerning);
-				continue;
-			}
+		TextDrawData textDraw;
+		textDraw.Texture = (VulkanTexture*)font->GetAtlasTexture()->GetGPUTexture();
+		textDraw.Transform = transform;
+		textDraw.Layout = layout;
+		// White text skips the tint multiply
+		textDraw.Variant = (layout->Tint != 0xFFFFFFFF ? ShaderFeatureTint : 0) | (outline ? ShaderFeatureOutline : 0);
 
-			auto glyph = fontGeometry.getGlyph(character);
-			if (!glyph)
-				glyph = fontGeometry.getGlyph('?');
-			if (!glyph)
-				return;
+		m_TextDraws.push_back(textDraw);
+	}
 
-			float atlasWidth = (float)(fontAtlas->GetWidth()), atlasHeight = (float)(fontAtlas->GetHeight());
+	void VulkanRenderer::SavePipelineCache()
+	{
+		m_PipelineCache->Save(vkDevice->logicalDevice);
+	}
 
-			double al, ab, ar, at;
-			glyph->getQuadAtlasBounds(al, ab, ar, at);
-			glm::vec2 texCoordMin((float)al, atlasHeight - (float)at);
-			glm::vec2 texCoordMax((float)ar, atlasHeight - (float)ab);
+	void VulkanRenderer::WaitDeviceIdle()
+	{
+		vkDeviceWaitIdle(vkDevice->logicalDevice);
+		m_DeviceIdle = true;
+	}
 
-			// switched bottom and top bounds
-			double pl, pb, pr, pt;
-			glyph->getQuadPlaneBounds(pl, pt, pr, pb);
-			glm::vec2 quadMin((float)pl, (float)pb);
-			glm::vec2 quadMax((float)pr, (float)pt);
+	void VulkanRenderer::RecreateSwapchain(uint32_t width, uint32_t height)
+	{
+		WaitDeviceIdle();
 
-			quadMin *= fsScale, quadMax *= fsScale;
-			quadMin += glm::vec2(x, y);
-			quadMax += glm::vec2(x, y);
+		for (auto renderPass : m_RenderPasses)
+		{
+			m_RenderTarget->DestroyFramebuffers(vkDevice->logicalDevice, renderPass->GetRenderPass());
+		}
+		
+		m_RenderTarget->Dispose(vkDevice->logicalDevice);
 
-			float texelWidth = 1.0f / atlasWidth;
-			float texelHeight = 1.0f / atlasHeight;
-			texCoordMin *= glm::vec2(texelWidth, texelHeight);
-			texCoordMax *= glm::vec2(texelWidth, texelHeight);
+		delete m_RenderTarget;
 
+		if (m_OffscreenTarget)
+		{
+			m_OffscreenTarget = new VulkanOffscreenTarget(width, height, FRAMES_IN_FLIGHT,
+				vkDevice->physicalDevice, vkDevice->logicalDevice, *m_ResourceAllocator);
+			m_RenderTarget = m_OffscreenTarget;
 
-			vertexBufferData[quadCount * 4 + 0].position = glm::vec3(quadMin, 0.0f);
-			vertexBufferData[quadCount * 4 + 0].color = textParams.Color;
-			vertexBufferData[quadCount * 4 + 0].textureCoordinate = texCoordMin;
+			// The readback buffers went away with the old images
+			m_CapturedImage = -1;
+		}
+		else
+		{
+			vkSwapchain = new VulkanSwapchain(width, height, vkDevice->physicalDevice, vkDevice->logicalDevice, vkSurface);
+			m_RenderTarget = vkSwapchain;
+		}
 
-			vertexBufferData[quadCount * 4 + 1].position = glm::vec3(quadMin.x, quadMax.y, 0.0f);
-			vertexBufferData[quadCount * 4 + 1].color = textParams.Color;
-			vertexBufferData[quadCount * 4 + 1].textureCoordinate = { texCoordMin.x, texCoordMax.y };
+		for (auto renderPass : m_RenderPasses)
+		{
+			m_RenderTarget->CreateFramebuffers(vkDevice->logicalDevice, renderPass->GetRenderPass());
+		}
+	}
 
-			vertexBufferData[quadCount * 4 + 2].position = glm::vec3(quadMax, 0.0f);
-			vertexBufferData[quadCount * 4 + 2].color = textParams.Color;
-			vertexBufferData[quadCount * 4 + 2].textureCoordinate = texCoordMax;
+	VulkanTexture* VulkanRenderer::UploadTextureToGPU(Texture2D* texture)
+	{
+		if (!IsTextureFormatSupported(texture->GetFormat()))
+		{
+			BLD_CORE_ERROR("Texture format {} can not be sampled on this device", (uint32_t)texture->GetFormat());
+			return nullptr;
+		}
 
-			vertexBufferData[quadCount * 4 + 3].position = glm::vec3(quadMax.x, quadMin.y, 0.0f);
-			vertexBufferData[quadCount * 4 + 3].color = textParams.Color;
-			vertexBufferData[quadCount * 4 + 3].textureCoordinate = { texCoordMax.x, texCoordMin.y };
+		VulkanTexture* vkTexture = new VulkanTexture(vkDevice->physicalDevice, vkDevice->logicalDevice, *m_UploadManager, texture);
+		vkTexture->SortID = m_NextTextureSortID++;
 
-			static const uint16_t indices[6] {
-				0, 1, 2,
-				2, 3, 0
-			};
+		// Every texture gets a slot so switching to bindless mode at runtime needs no re-upload
+		if (m_BindlessTextures)
+		{
+			m_BindlessTextures->Register(vkDevice->logicalDevice, vkTexture);
+		}
 
-			indexBufferData[quadCount * 6 + 0] = indices[0] + quadCount * 4;
-			indexBufferData[quadCount * 6 + 1] = indices[1] + quadCount * 4;
-			indexBufferData[quadCount * 6 + 2] = indices[2] + quadCount * 4;
-			indexBufferData[quadCount * 6 + 3] = indices[3] + quadCount * 4;
-			indexBufferData[quadCount * 6 + 4] = indices[4] + quadCount * 4;
-			indexBufferData[quadCount * 6 + 5] = indices[5] + quadCount * 4;
+		return vkTexture;
+	}
 
-			quadCount++;
+	void VulkanRenderer::ReleaseGPUTexture(VulkanTexture* gpuTexture)
+	{
+		m_UploadManager->WaitFor(gpuTexture->UploadID);
+		m_UploadManager->Forget(gpuTexture->textureImage);
 
-			if (i < string.size() - 1)
+		// Command buffers of the frames in flight may still sample the image through its cached sets
+		for (auto renderPass : m_RenderPasses)
+		{
+			for (auto pipeline : m_GraphicsPipelinesMap[renderPass])
 			{
-				double advance = glyph->getAdvance();
-				char nextCharacter = string[i + 1];
-				fontGeometry.getAdvance(advance, character, nextCharacter);
-
-				x += fsScale * advance + textParams.Kerning;
+				pipeline->EvictTexture(gpuTexture->textureImageView, m_RetireFrame);
 			}
 		}
 
-		memcpy(m_TextVertexBuffers[currentFrame][m_TextCount]->Map(), vertexBufferData,
-			quadCount * 4 * sizeof(VertexColorTexture));
-		memcpy(m_TextIndexBuffers[currentFrame][m_TextCount]->Map(), indexBufferData,
-			quadCount * 6 * sizeof(uint16_t));
-
-		vkMeshesModelData.push_back(transform);
-
-		m_TextQuadCounts[m_TextCount] = quadCount;
-		m_TextCount++;
-
-		vertexBuffer.Release();
-		indexBuffer.Release();
+		if (m_BindlessTextures)
+		{
+			m_BindlessTextures->Unregister(gpuTexture);
+		}
 
-	}
+		m_RetiredTextures[m_RetireFrame].push_back(gpuTexture);
 
-	void VulkanRenderer::WaitDeviceIdle()
-	{
-		vkDeviceWaitIdle(vkDevice->logicalDevice);
+		// Nothing is in flight after WaitDeviceIdle, as during shutdown
+		if (m_DeviceIdle)
+		{
+			DisposeRetiredTextures(m_RetireFrame);
+		}
 	}
 
-	void VulkanRenderer::RecreateSwapchain(uint32_t width, uint32_t height)
+	void VulkanRenderer::DisposeRetiredTextures(uint32_t frameIndex)
 	{
-		WaitDeviceIdle();
-
+		// Sets first, they reference the image views
 		for (auto renderPass : m_RenderPasses)
 		{
-			vkSwapchain->DestroyFramebuffers(vkDevice->logicalDevice, renderPass->GetRenderPass());
+			for (auto pipeline : m_GraphicsPipelinesMap[renderPass])
+			{
+				pipeline->FreeRetiredSets(vkDevice->logicalDevice, frameIndex);
+			}
 		}
-		
-		vkSwapchain->Dispose(vkDevice->logicalDevice);
-
-		delete vkSwapchain;
 
-		vkSwapchain = new VulkanSwapchain(width, height, vkDevice->physicalDevice, vkDevice->logicalDevice, vkSurface);
-
-		for (auto renderPass : m_RenderPasses)
+		for (VulkanTexture* gpuTexture : m_RetiredTextures[frameIndex])
 		{
-			vkSwapchain->CreateFramebuffers(vkDevice->logicalDevice, renderPass->GetRenderPass());
+			gpuTexture->Dispose(vkDevice->logicalDevice);
+			delete gpuTexture;
 		}
+		m_RetiredTextures[frameIndex].clear();
 	}
 
-	VulkanTexture* VulkanRenderer::UploadTextureToGPU(Texture2D* texture)
+	bool VulkanRenderer::IsGPUTextureReady(VulkanTexture* gpuTexture) const
 	{
-		return new VulkanTexture(vkDevice->physicalDevice, vkDevice->logicalDevice, vkDevice->graphicsQueue, vkCommandPool, texture);
+		return m_UploadManager->IsComplete(gpuTexture->UploadID);
 	}
 
-	void VulkanRenderer::ReleaseGPUTexture(VulkanTexture* gpuTexture)
+	bool VulkanRenderer::IsTextureFormatSupported(TextureFormat format) const
 	{
-		gpuTexture->Dispose(vkDevice->logicalDevice);
-		delete gpuTexture;
+		switch (format)
+		{
+		case TextureFormat::BC1:
+		case TextureFormat::BC3:
+		case TextureFormat::BC7:
+			if (!vkDevice->textureCompressionBC)
+			{
+				return false;
+			}
+			break;
+		case TextureFormat::ETC2_RGB8:
+		case TextureFormat::ETC2_RGBA8:
+			if (!vkDevice->textureCompressionETC2)
+			{
+				return false;
+			}
+			break;
+		default:
+			break;
+		}
+
+		VkFormatProperties formatProperties;
+		vkGetPhysicalDeviceFormatProperties(vkDevice->physicalDevice, GetVulkanFormat(format), &formatProperties);
+
+		return (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) != 0;
 	}
 
 	VulkanMesh* VulkanRenderer::UploadMeshToGPU(Buffer vertices, Buffer indices)
 	{
-		return LoadMesh(*m_ResourceAllocator, vkDevice->logicalDevice, vkDevice->graphicsQueue, vkCommandPool, vertices, indices);
+		return LoadMesh(*m_ResourceAllocator, *m_UploadManager, vertices, indices);
 	}
 
 	void VulkanRenderer::ReleaseGPUMesh(VulkanMesh* gpuMesh)
 	{
+		m_UploadManager->WaitFor(gpuMesh->UploadID);
+		m_UploadManager->Forget(gpuMesh->VertexBuffer->GetBuffer());
+		m_UploadManager->Forget(gpuMesh->IndexBuffer->GetBuffer());
+
 		gpuMesh->Dispose(vkDevice->logicalDevice);
 		delete gpuMesh;
 	}
 
 	void VulkanRenderer::DrawFrame()
 	{
+		BLD_PROFILE_FUNCTION();
+
 		/*vkWaitForFences(vkDevice->logicalDevice, 1, &inFlightFences[currentFrame], VK_TRUE,
 			UINT64_MAX);*/
 
-		VkResult result = vkAcquireNextImageKHR(
-			vkDevice->logicalDevice, vkSwapchain->swapchain, UINT64_MAX, imageAvailableSemaphores[currentFrame],
-			VK_NULL_HANDLE, &imageIndex);
+		AcquireNextImage();
 
 		vkResetFences(vkDevice->logicalDevice, 1, &inFlightFences[currentFrame]);
 
 		vkResetCommandBuffer(commandBuffers[currentFrame], 0);
 
+		// Everything queued up to now is submitted so this frame can acquire and draw it
+		m_UploadManager->Flush();
+
+		m_UploadWaitSemaphores.clear();
+		m_UploadWaitStages.clear();
+
 		RecordCommandBuffer();
 
 		VkSubmitInfo submitInfo{};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-		VkSemaphore waitSemaphores[] = { imageAvailableSemaphores[currentFrame] };
-		VkPipelineStageFlags waitStages[] = {
-			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-		submitInfo.waitSemaphoreCount = 1;
-		submitInfo.pWaitSemaphores = waitSemaphores;
-		submitInfo.pWaitDstStageMask = waitStages;
+		std::vector<VkSemaphore> waitSemaphores;
+		std::vector<VkPipelineStageFlags> waitStages;
+		if (vkSwapchain)
+		{
+			waitSemaphores.push_back(imageAvailableSemaphores[currentFrame]);
+			waitStages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+		}
+		waitSemaphores.insert(waitSemaphores.end(), m_UploadWaitSemaphores.begin(), m_UploadWaitSemaphores.end());
+		waitStages.insert(waitStages.end(), m_UploadWaitStages.begin(), m_UploadWaitStages.end());
+
+		submitInfo.waitSemaphoreCount = (uint32_t)waitSemaphores.size();
+		submitInfo.pWaitSemaphores = waitSemaphores.data();
+		submitInfo.pWaitDstStageMask = waitStages.data();
 
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = &commandBuffers[currentFrame];
 
-		VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame] };
-		submitInfo.signalSemaphoreCount = 1;
-		submitInfo.pSignalSemaphores = signalSemaphores;
+		// Nothing waits on the frame but its fence when it is not presented
+		submitInfo.signalSemaphoreCount = vkSwapchain ? 1 : 0;
+		submitInfo.pSignalSemaphores = &renderFinishedSemaphores[currentFrame];
 
 		BLD_VK_CHECK(vkQueueSubmit(vkDevice->graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]),
 			"Failed to submit draw command buffer");
 
+		PresentImage();
+
+		currentFrame = (currentFrame + 1) % FRAMES_IN_FLIGHT;
+	}
+
+	void VulkanRenderer::AcquireNextImage()
+	{
+		BLD_PROFILE_FUNCTION();
+
+		if (!vkSwapchain)
+		{
+			imageIndex = currentFrame;
+			return;
+		}
+
+		vkAcquireNextImageKHR(
+			vkDevice->logicalDevice, vkSwapchain->swapchain, UINT64_MAX, imageAvailableSemaphores[currentFrame],
+			VK_NULL_HANDLE, &imageIndex);
+	}
+
+	void VulkanRenderer::PresentImage()
+	{
+		BLD_PROFILE_FUNCTION();
+
+		if (!vkSwapchain)
+		{
+			return;
+		}
+
 		VkPresentInfoKHR presentInfo{};
 		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
 		presentInfo.waitSemaphoreCount = 1;
-		presentInfo.pWaitSemaphores = signalSemaphores;
+		presentInfo.pWaitSemaphores = &renderFinishedSemaphores[currentFrame];
 
 		VkSwapchainKHR swapChains[] = { vkSwapchain->swapchain };
 		presentInfo.swapchainCount = 1;
@@ -464,26 +676,60 @@ namespace BladeEngine::Graphics::Vulkan
 
 		presentInfo.pImageIndices = &imageIndex;
 
-		result = vkQueuePresentKHR(vkDevice->presentQueue, &presentInfo);
+		vkQueuePresentKHR(vkDevice->presentQueue, &presentInfo);
+	}
+
+	bool VulkanRenderer::RequestFrameCapture()
+	{
+		if (!m_OffscreenTarget)
+		{
+			BLD_CORE_WARN("Frame capture is only available when rendering headless");
+			return false;
+		}
+
+		m_CaptureRequested = true;
+		return true;
+	}
 
-		currentFrame = (currentFrame + 1) % FRAMES_IN_FLIGHT;
+	bool VulkanRenderer::ReadCapturedFrame(FrameCapture& capture)
+	{
+		if (m_CapturedImage < 0)
+		{
+			return false;
+		}
+
+		vkWaitForFences(vkDevice->logicalDevice, 1, &inFlightFences[m_CapturedFrame], VK_TRUE, UINT64_MAX);
+
+		capture.Width = m_OffscreenTarget->extent.width;
+		capture.Height = m_OffscreenTarget->extent.height;
+		m_OffscreenTarget->ReadPixels((uint32_t)m_CapturedImage, capture.Pixels);
+
+		m_CapturedImage = -1;
+		return true;
 	}
 
 
 	void VulkanRenderer::RecordCommandBuffer()
 	{
+		BLD_PROFILE_FUNCTION();
+
 		VkCommandBufferBeginInfo beginInfo{};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 
 		BLD_VK_CHECK(vkBeginCommandBuffer(commandBuffers[currentFrame], &beginInfo),
 			"Failed to begin recording command buffer");
 
+		m_UploadManager->RecordAcquireBarriers(commandBuffers[currentFrame], m_FrameNumber,
+			m_UploadWaitSemaphores, m_UploadWaitStages);
+
+		m_GPUProfiler->BeginFrame(commandBuffers[currentFrame], currentFrame);
+
 		VkRenderPassBeginInfo renderPassInfo{};
 		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 		renderPassInfo.renderPass = m_RenderPasses[0]->GetRenderPass();
-		renderPassInfo.framebuffer = vkSwapchain->m_FramebuffersMap[m_RenderPasses[0]->GetRenderPass()][imageIndex];
+		renderPassInfo.framebuffer = m_RenderTarget->m_FramebuffersMap[m_RenderPasses[0]->GetRenderPass()][imageIndex];
 		renderPassInfo.renderArea.offset = { 0, 0 };
-		renderPassInfo.renderArea.extent = vkSwapchain->extent;
+		renderPassInfo.renderArea.extent = m_RenderTarget->extent;
 
 		std::array<VkClearValue, 2> clearValues{};
 		auto color = backgroundColor.GetValues();
@@ -493,70 +739,142 @@ namespace BladeEngine::Graphics::Vulkan
 		renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
 		renderPassInfo.pClearValues = clearValues.data();
 
+		// The clear is the render pass load op, this scope ends once the attachments are cleared
+		uint32_t clearScope = m_GPUProfiler->BeginScope(commandBuffers[currentFrame], "Clear");
+
 		vkCmdBeginRenderPass(commandBuffers[currentFrame], &renderPassInfo,
 			VK_SUBPASS_CONTENTS_INLINE);
 
-		vkCmdBindPipeline(commandBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-			m_GraphicsPipelinesMap[m_RenderPasses[0]][0]->graphicsPipeline);
+		m_GPUProfiler->EndScope(commandBuffers[currentFrame], clearScope);
 
 		VkViewport viewport{};
 		viewport.x = 0.0f;
 		viewport.y = 0.0f;
-		viewport.width = (float)vkSwapchain->extent.width;
-		viewport.height = (float)vkSwapchain->extent.height;
+		viewport.width = (float)m_RenderTarget->extent.width;
+		viewport.height = (float)m_RenderTarget->extent.height;
 		viewport.minDepth = 0.0f;
 		viewport.maxDepth = 1.0f;
 		vkCmdSetViewport(commandBuffers[currentFrame], 0, 1, &viewport);
 
 		VkRect2D scissor{};
 		scissor.offset = { 0, 0 };
-		scissor.extent = vkSwapchain->extent;
+		scissor.extent = m_RenderTarget->extent;
 		vkCmdSetScissor(commandBuffers[currentFrame], 0, 1, &scissor);
 
-		// Loop meshes draw command
-		int i = 0;
-		for (auto& mesh : vkMeshes)
+		VkCommandBuffer commandBuffer = commandBuffers[currentFrame];
+
+		uint32_t spriteScope = m_GPUProfiler->BeginScope(commandBuffer, "Sprites");
+		RecordBatches(commandBuffer, m_SpriteBatcher);
+		m_GPUProfiler->EndScope(commandBuffer, spriteScope);
+
+		uint32_t textScope = m_GPUProfiler->BeginScope(commandBuffer, "Text");
+		RecordBatches(commandBuffer, m_TextBatcher);
+		m_GPUProfiler->EndScope(commandBuffer, textScope);
+
+		vkCmdEndRenderPass(commandBuffers[currentFrame]);
+
+		m_GPUProfiler->EndFrame(commandBuffer);
+
+		if (m_CaptureRequested)
 		{
-			const auto& renderPass = m_RenderPasses[0];
-			const auto& graphicsPipeline = m_GraphicsPipelinesMap[renderPass][0];
+			m_OffscreenTarget->RecordReadback(commandBuffer, imageIndex);
+
+			m_CaptureRequested = false;
+			m_CapturedImage = (int32_t)imageIndex;
+			m_CapturedFrame = currentFrame;
+		}
+
+		BLD_VK_CHECK(vkEndCommandBuffer(commandBuffers[currentFrame]),
+			"Failed to record command buffer!");
+	}
 
-			vkCmdPushConstants(commandBuffers[currentFrame], m_GraphicsPipelinesMap[m_RenderPasses[0]][0]->pipelineLayout,
-				VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantData), &m_PushConstantsData[i]);
+	void VulkanRenderer::RecordBatches(VkCommandBuffer commandBuffer, VulkanSpriteBatcher* batcher)
+	{
+		const VkDevice device = vkDevice->logicalDevice;
 
-			VkPipelineLayout& pipelineLayout = graphicsPipeline->pipelineLayout;
-			VkDescriptorSet& descriptorSet = graphicsPipeline->descriptorSets[currentFrame][i];
-			mesh->Draw(commandBuffers[currentFrame], pipelineLayout, descriptorSet);
-			i++;
+		// Uvs are baked into the vertices or instance data so the push constant of the batched path stays identity
+		const auto& batches = batcher->GetBatches();
+		if (batches.size() == 0)
+		{
+			return;
 		}
 
-		vkCmdBindPipeline(commandBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-			m_GraphicsPipelinesMap[m_RenderPasses[0]][1]->graphicsPipeline);
+		const bool instanced = batcher->UsesInstanceData();
+		const bool bindless = batcher->GetMode() == SpriteRenderMode::Bindless;
+
+		batcher->BindBuffers(commandBuffer);
 
-		for (uint32_t j = 0; j < m_TextCount; j++, i++)
+		PushConstantData identity{};
+		identity.Model = glm::mat4(1.0f);
+		identity.UVTransform = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+		VulkanGraphicsPipeline* boundPipeline = nullptr;
+		ShaderVariantKey boundVariant = 0;
+		VkDescriptorSet boundFrameSet = VK_NULL_HANDLE;
+		VkDeviceSize boundPageOffset = 0;
+		VulkanTexture* boundTexture = nullptr;
+
+		for (const auto& batch : batches)
 		{
-			VkPipelineLayout& pipelineLayout = m_GraphicsPipelinesMap[m_RenderPasses[0]][1]->pipelineLayout;
-			VkDescriptorSet& descriptorSet = m_GraphicsPipelinesMap[m_RenderPasses[0]][1]->descriptorSets[currentFrame][j];
+			if (batch.Pipeline != boundPipeline || batch.Variant != boundVariant)
+			{
+				uint32_t variantCount = batch.Pipeline->GetVariantCount();
+				vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+					batch.Pipeline->GetVariant(device, batch.Variant));
+				m_FrameStatistics.PipelineVariantsCompiled += batch.Pipeline->GetVariantCount() - variantCount;
 
-			VkBuffer vertexBuffers[] = { m_TextVertexBuffers[currentFrame][j]->GetBuffer() };
-			VkDeviceSize offsets[] = { 0 };
+				// Variants share the pipeline layout, switching between them keeps the push constants and descriptor sets
+				if (batch.Pipeline != boundPipeline)
+				{
+					if (!instanced)
+					{
+						vkCmdPushConstants(commandBuffer, batch.Pipeline->pipelineLayout,
+							VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(PushConstantData), &identity);
+					}
+
+					boundPipeline = batch.Pipeline;
+					boundFrameSet = VK_NULL_HANDLE;
+					boundTexture = nullptr;
+				}
 
-			vkCmdBindVertexBuffers(commandBuffers[currentFrame], 0, 1, vertexBuffers, offsets);
+				boundVariant = batch.Variant;
+				m_FrameStatistics.PipelineBinds++;
+			}
 
-			vkCmdBindIndexBuffer(commandBuffers[currentFrame], 
-				m_TextIndexBuffers[currentFrame][j]->GetBuffer(), 
-				0, VK_INDEX_TYPE_UINT16);
+			// Instance pages are addressed through the storage buffer's dynamic offset
+			VkDescriptorSet frameSet = batch.Pipeline->GetFrameDescriptorSet(device,
+				m_CameraUniformBuffer.Buffer->GetBuffer(), sizeof(CameraData),
+				instanced ? batch.Buffer : VK_NULL_HANDLE, instanced ? batcher->GetPageSize() : 0);
 
-			vkCmdBindDescriptorSets(commandBuffers[currentFrame], VK_PIPELINE_BIND_POINT_GRAPHICS,
-				pipelineLayout, 0, 1, &descriptorSet,
-				0, nullptr);
+			if (frameSet != boundFrameSet || (instanced && batch.BufferOffset != boundPageOffset))
+			{
+				uint32_t dynamicOffsets[] = { (uint32_t)m_CameraUniformBuffer.Offset, (uint32_t)batch.BufferOffset };
 
-			vkCmdDrawIndexed(commandBuffers[currentFrame], m_TextQuadCounts[j] * 6, 1, 0, 0, 0);
-		}
+				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+					batch.Pipeline->pipelineLayout, FRAME_DESCRIPTOR_SET, 1, &frameSet,
+					instanced ? 2 : 1, dynamicOffsets);
 
-		vkCmdEndRenderPass(commandBuffers[currentFrame]);
+				boundFrameSet = frameSet;
+				boundPageOffset = batch.BufferOffset;
+			}
 
-		BLD_VK_CHECK(vkEndCommandBuffer(commandBuffers[currentFrame]),
-			"Failed to record command buffer!");
+			// The bindless table is a single set, bound once per pipeline
+			if (batch.Texture != boundTexture && (!bindless || boundTexture == nullptr))
+			{
+				VkDescriptorSet textureSet = bindless ? m_BindlessTextures->GetDescriptorSet() :
+					batch.Pipeline->GetTextureDescriptorSet(device,
+						batch.Texture->textureImageView, batch.Texture->textureSampler);
+
+				vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+					batch.Pipeline->pipelineLayout, TEXTURE_DESCRIPTOR_SET, 1, &textureSet,
+					0, nullptr);
+
+				boundTexture = batch.Texture;
+			}
+
+			batcher->DrawBatch(commandBuffer, batch);
+			m_FrameStatistics.DrawCalls++;
+		}
 	}
 
 
@@ -566,18 +884,7 @@ namespace BladeEngine::Graphics::Vulkan
 		vkWaitForFences(vkDevice->logicalDevice, 1, &inFlightFences[currentFrame], VK_TRUE,
 			UINT64_MAX);
 
-		if (m_GraphicsPipelinesMap[m_RenderPasses[0]].size() > 0 
-			&& m_GraphicsPipelinesMap[m_RenderPasses[0]][0]->descriptorSets[currentFrame].size() > 0)
-			m_GraphicsPipelinesMap[m_RenderPasses[0]][0]->FreeDescriptorSets(vkDevice->logicalDevice, currentFrame);
-
-		//uint32_t imageIndex;
-		VkResult result = vkAcquireNextImageKHR(
-			vkDevice->logicalDevice,
-			vkSwapchain->swapchain,
-			UINT64_MAX,
-			imageAvailableSemaphores[currentFrame],
-			VK_NULL_HANDLE,
-			&imageIndex);
+		AcquireNextImage();
 
 		vkResetFences(vkDevice->logicalDevice, 1, &inFlightFences[currentFrame]);
 
@@ -597,7 +904,7 @@ namespace BladeEngine::Graphics::Vulkan
 		renderPassInfo.framebuffer = vkClearFramebuffers[imageIndex];
 
 		renderPassInfo.renderArea.offset = { 0, 0 };
-		renderPassInfo.renderArea.extent = vkSwapchain->extent;
+		renderPassInfo.renderArea.extent = m_RenderTarget->extent;
 
 		std::array<VkClearValue, 2> clearValues{};
 		auto clearColor = color.GetValues();
@@ -615,15 +922,15 @@ namespace BladeEngine::Graphics::Vulkan
 		VkViewport viewport{};
 		viewport.x = 0.0f;
 		viewport.y = 0.0f;
-		viewport.width = (float)vkSwapchain->extent.width;
-		viewport.height = (float)vkSwapchain->extent.height;
+		viewport.width = (float)m_RenderTarget->extent.width;
+		viewport.height = (float)m_RenderTarget->extent.height;
 		viewport.minDepth = 0.0f;
 		viewport.maxDepth = 1.0f;
 		vkCmdSetViewport(commandBuffers[currentFrame], 0, 1, &viewport);
 
 		VkRect2D scissor{};
 		scissor.offset = { 0, 0 };
-		scissor.extent = vkSwapchain->extent;
+		scissor.extent = m_RenderTarget->extent;
 		vkCmdSetScissor(commandBuffers[currentFrame], 0, 1, &scissor);
 
 		vkCmdEndRenderPass(commandBuffers[currentFrame]);
@@ -637,7 +944,7 @@ namespace BladeEngine::Graphics::Vulkan
 		VkSemaphore waitSemaphores[] = { imageAvailableSemaphores[currentFrame] };
 		VkPipelineStageFlags waitStages[] = {
 			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
-		submitInfo.waitSemaphoreCount = 1;
+		submitInfo.waitSemaphoreCount = vkSwapchain ? 1 : 0;
 		submitInfo.pWaitSemaphores = waitSemaphores;
 		submitInfo.pWaitDstStageMask = waitStages;
 
@@ -645,25 +952,13 @@ namespace BladeEngine::Graphics::Vulkan
 		submitInfo.pCommandBuffers = &commandBuffers[currentFrame];
 
 		VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame] };
-		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.signalSemaphoreCount = vkSwapchain ? 1 : 0;
 		submitInfo.pSignalSemaphores = signalSemaphores;
 
 		BLD_VK_CHECK(vkQueueSubmit(vkDevice->graphicsQueue, 1, &submitInfo, inFlightFences[currentFrame]),
 			"Failed to submit draw command buffer");
 
-		VkPresentInfoKHR presentInfo{};
-		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
-
-		presentInfo.waitSemaphoreCount = 1;
-		presentInfo.pWaitSemaphores = signalSemaphores;
-
-		VkSwapchainKHR swapChains[] = { vkSwapchain->swapchain };
-		presentInfo.swapchainCount = 1;
-		presentInfo.pSwapchains = swapChains;
-
-		presentInfo.pImageIndices = &imageIndex;
-
-		result = vkQueuePresentKHR(vkDevice->presentQueue, &presentInfo);
+		PresentImage();
 
 		/*if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
 			framebufferResized) {
@@ -679,14 +974,14 @@ namespace BladeEngine::Graphics::Vulkan
 	void VulkanRenderer::CreateClearRenderPass()
 	{
 		VkAttachmentDescription colorAttachment{};
-		colorAttachment.format = vkSwapchain->imageFormat;
+		colorAttachment.format = m_RenderTarget->imageFormat;
 		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
 		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
 		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		colorAttachment.finalLayout = m_RenderTarget->finalLayout;
 
 		VkAttachmentReference colorAttachmentRef{};
 		colorAttachmentRef.attachment = 0;
@@ -727,10 +1022,10 @@ namespace BladeEngine::Graphics::Vulkan
 
 	void VulkanRenderer::CreateClearFramebuffer()
 	{
-		vkClearFramebuffers.resize(vkSwapchain->imageViews.size());
+		vkClearFramebuffers.resize(m_RenderTarget->imageViews.size());
 
-		for (size_t i = 0; i < vkSwapchain->imageViews.size(); i++) {
-			std::array<VkImageView, 1> attachments = { vkSwapchain->imageViews[i] };
+		for (size_t i = 0; i < m_RenderTarget->imageViews.size(); i++) {
+			std::array<VkImageView, 1> attachments = { m_RenderTarget->imageViews[i] };
 
 			VkFramebufferCreateInfo framebufferInfo{};
 			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
@@ -738,8 +1033,8 @@ namespace BladeEngine::Graphics::Vulkan
 			framebufferInfo.attachmentCount =
 				static_cast<uint32_t>(attachments.size());
 			framebufferInfo.pAttachments = attachments.data();
-			framebufferInfo.width = vkSwapchain->extent.width;
-			framebufferInfo.height = vkSwapchain->extent.height;
+			framebufferInfo.width = m_RenderTarget->extent.width;
+			framebufferInfo.height = m_RenderTarget->extent.height;
 			framebufferInfo.layers = 1;
 
 			if (vkCreateFramebuffer(vkDevice->logicalDevice, &framebufferInfo, nullptr,
@@ -751,12 +1046,10 @@ namespace BladeEngine::Graphics::Vulkan
 
 	void VulkanRenderer::CreateCommandPool()
 	{
-		GraphicsFamily graphicsFamily = GetGraphicsFamily(vkDevice->physicalDevice, vkSurface);
-
 		VkCommandPoolCreateInfo poolInfo{};
 		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 		poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
-		poolInfo.queueFamilyIndex = graphicsFamily.graphicsFlagIndex.value();
+		poolInfo.queueFamilyIndex = vkDevice->graphicsQueueFamily;
 
 		if (vkCreateCommandPool(vkDevice->logicalDevice, &poolInfo, nullptr, &vkCommandPool) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create graphics command pool!");
@@ -6,11 +6,18 @@
 #include "BladeVulkanDevice.hpp"
 #include "VulkanResourceAllocator.hpp"
 #include "BladeVulkanSwapchain.hpp"
+#include "VulkanOffscreenTarget.hpp"
 #include "BladeVulkanShader.hpp"
 #include "BladeVulkanGraphicsPipeline.hpp"
 #include "BladeVulkanMesh.hpp"
 #include "BladeVulkanTexture.hpp"
 #include "VulkanRenderPass.hpp"
+#include "VulkanSpriteBatch.hpp"
+#include "VulkanFrameArena.hpp"
+#include "VulkanBindlessTextureTable.hpp"
+#include "VulkanUploadManager.hpp"
+#include "VulkanPipelineCache.hpp"
+#include "VulkanGPUProfiler.hpp"
 
 //#define BLADE_VULKAN_API true
 #include "../../../Core/Window.hpp"
@@ -19,6 +26,13 @@
 #include "../../Shader.hpp"
 #include "../../Mesh.hpp"
 #include "../../Font.hpp"
+#include "../../RenderStatistics.hpp"
+#include "../../GPUTimings.hpp"
+#include "../../FrameCapture.hpp"
+#include "../../RenderSettings.hpp"
+#include "../../RenderQueue.hpp"
+#include "../../VisibilityCulling.hpp"
+#include "../../TextLayoutCache.hpp"
 
 #include <map>
 
@@ -27,6 +41,7 @@ namespace BladeEngine::Graphics::Vulkan {
 	class VulkanRenderer 
 	{
 	public:
+		// A headless window makes the renderer draw into offscreen images, no surface or swapchain is created
 		VulkanRenderer(BladeEngine::Camera* camera, Window* window);
 		~VulkanRenderer();
 
@@ -36,21 +51,54 @@ namespace BladeEngine::Graphics::Vulkan {
 
 		void Clear(BladeEngine::Graphics::Color color);
 
-		// Creates Graphics pipeline for default shaders to be used during draw calls
+		// Waits for the current frame's resources to be free and starts a new sprite batch
 		void BeginDrawing();
-		// Create and store Vulkan Texture, store model data, store quad mesh, create and allocate descriptor pools and sets
-		void DrawSprite(BladeEngine::Graphics::Texture2D* texture, const glm::mat4& transform, const glm::vec4& uvTransform);
-		// Create Descriptor Pool, Descriptor sets, update descriptor sets, uniform buffers, drawindexed
+		// Queues the sprite's draw data under its render queue sort key, nothing is batched until EndDrawing
+		void DrawSprite(BladeEngine::Graphics::Texture2D* texture, const glm::mat4& transform, const glm::vec4& uvTransform, uint8_t layer);
+		// Sorts the sprite queue and feeds it to the batcher in key order, binding each batch's cached descriptor set
+		// or the bindless texture table, then records and submits the frame
 		void EndDrawing();
 
-		void DrawString(const std::string& string, Font* font, const glm::mat4& transform);
+		// Queues the string's cached layout, its glyphs are written into the frame's shared glyph instance stream on EndDrawing
+		void DrawString(const std::string& string, Font* font, const glm::mat4& transform, bool outline = false);
 
 		void WaitDeviceIdle();
 
+		// Writes the pipelines compiled so far to disk for the next run
+		void SavePipelineCache();
+
+		// Statistics of the last submitted frame
+		void SetCullingStatistics(const CullingStatistics& statistics)
+		{
+			m_FrameStatistics.CullingCandidates = statistics.Candidates;
+			m_FrameStatistics.Culled = statistics.Culled;
+		}
+
+		const RenderStatistics& GetRenderStatistics() const { return m_LastFrameStatistics; }
+		// Pass timings of the last frame the GPU finished, FRAMES_IN_FLIGHT frames behind the statistics
+		const GPUTimings& GetGPUTimings() const { return m_GPUProfiler->GetTimings(); }
+
+		// Takes effect on the next BeginDrawing
+		// Bindless falls back to Instanced when the device lacks descriptor indexing
+		void SetSpriteRenderMode(SpriteRenderMode mode);
+		SpriteRenderMode GetSpriteRenderMode() const { return m_SpriteRenderMode; }
+
 		void RecreateSwapchain(uint32_t width, uint32_t height);
 
+		bool IsHeadless() const { return m_OffscreenTarget != nullptr; }
+
+		// Copies the next submitted frame back to host memory, only possible when headless
+		bool RequestFrameCapture();
+		// Waits for the captured frame's fence, false if no capture was recorded since the last read
+		bool ReadCapturedFrame(FrameCapture& capture);
+
+		// Returns as soon as the upload is queued, the texture can be drawn right away.
+		// Null when the device can not sample the texture's format
 		VulkanTexture* UploadTextureToGPU(Texture2D* texture);
 		void ReleaseGPUTexture(VulkanTexture* gpuTexture);
+		// True once the texture's pixels are resident in device memory
+		bool IsGPUTextureReady(VulkanTexture* gpuTexture) const;
+		bool IsTextureFormatSupported(TextureFormat format) const;
 
 		VulkanMesh* UploadMeshToGPU(Buffer vertices, Buffer indices);
 		void ReleaseGPUMesh(VulkanMesh* gpuMesh);
@@ -69,6 +117,25 @@ namespace BladeEngine::Graphics::Vulkan {
 
 		void DrawFrame();
 
+		// Next swapchain image, or the frame's own offscreen image when headless
+		void AcquireNextImage();
+		void PresentImage();
+
+		VulkanGraphicsPipeline* GetSpritePipeline(SpriteRenderMode mode);
+
+		// Sorts the frame's sprite queue and feeds it to the batcher
+		void SubmitSortedSprites();
+		// Expands every queued string into glyph instances, grouped by font atlas
+		void SubmitText();
+
+		// Frees the descriptor sets and destroys the textures retired under the frame slot
+		void DisposeRetiredTextures(uint32_t frameIndex);
+
+		void RecordBatches(VkCommandBuffer commandBuffer, VulkanSpriteBatcher* batcher);
+
+		// Sum of the cache counters of every pipeline
+		DescriptorCacheStatistics GetDescriptorCacheStatistics();
+
 		struct ModelData
 		{
 			glm::vec3 position;
@@ -76,7 +143,31 @@ namespace BladeEngine::Graphics::Vulkan {
 			glm::vec3 scale;
 		};
 
+		struct SpriteDrawData
+		{
+			VulkanTexture* Texture;
+			glm::mat4 Transform;
+			glm::vec4 UVTransform;
+			ShaderVariantKey Variant;
+		};
+
+		struct TextDrawData
+		{
+			VulkanTexture* Texture;
+			glm::mat4 Transform;
+			ShaderVariantKey Variant;
+
+			// Owned by the text layout cache, valid until its next BeginFrame
+			const CachedTextLayout* Layout;
+		};
+
 		uint32_t currentFrame = 0;
+		// Slot of the last begun frame, textures released since are retired under it and destroyed
+		// once its fence signals again, as every frame that may have drawn them is done by then
+		uint32_t m_RetireFrame = 0;
+		std::vector<VulkanTexture*> m_RetiredTextures[FRAMES_IN_FLIGHT];
+		// Set by WaitDeviceIdle until the next frame begins, released textures are destroyed right away
+		bool m_DeviceIdle = false;
 		uint32_t imageIndex = -1;
 
 		//Init
@@ -86,8 +177,17 @@ namespace BladeEngine::Graphics::Vulkan {
 		VulkanDevice* vkDevice;
 		VulkanResourceAllocator* m_ResourceAllocator;
 
-		VkSurfaceKHR vkSurface;
-		VulkanSwapchain* vkSwapchain;
+		VkSurfaceKHR vkSurface = VK_NULL_HANDLE;
+		// Images every frame draws into, the swapchain or the offscreen target
+		VulkanRenderTarget* m_RenderTarget;
+		VulkanSwapchain* vkSwapchain = nullptr;
+		VulkanOffscreenTarget* m_OffscreenTarget = nullptr;
+
+		// Set by RequestFrameCapture, consumed by the next recorded frame
+		bool m_CaptureRequested = false;
+		// Offscreen image and frame slot of the last recorded capture, -1 once it was read
+		int32_t m_CapturedImage = -1;
+		uint32_t m_CapturedFrame = 0;
 
 		//Clear dependencies
 		VulkanSwapchain* vkClearSwapchain;
@@ -97,22 +197,49 @@ namespace BladeEngine::Graphics::Vulkan {
 		Shader* defaultSpriteVertexShader;
 		Shader* defaultSpriteFragmentShader;
 
-		Shader* defaultTextVertexShader;
 		Shader* defaultTextFragmentShader;
 
+		Shader* instancedSpriteVertexShader;
+		Shader* instancedSpriteFragmentShader;
+
+		Shader* bindlessSpriteVertexShader = nullptr;
+		Shader* bindlessSpriteFragmentShader = nullptr;
+
 		//Render Loop
 		std::vector<VulkanRenderPass*> m_RenderPasses;
 		std::unordered_map<VulkanRenderPass*, std::vector<VulkanGraphicsPipeline*>> m_GraphicsPipelinesMap;
 
-		std::vector<VulkanTexture*> vkTextures;
-		std::vector<VulkanMesh*> vkMeshes;
-		std::vector<glm::mat4> vkMeshesModelData;
-		std::vector<PushConstantData> m_PushConstantsData;
+		VulkanFrameArena* m_FrameArena;
+		VulkanSpriteBatcher* m_SpriteBatcher;
+		SpriteRenderMode m_SpriteRenderMode = SpriteRenderMode::Instanced;
+
+		VulkanUploadManager* m_UploadManager;
+
+		VulkanPipelineCache* m_PipelineCache;
+		// Brackets the clear, sprite and text passes of every frame with timestamps
+		VulkanGPUProfiler* m_GPUProfiler;
+		// Semaphores of the uploads acquired by the frame being recorded
+		std::vector<VkSemaphore> m_UploadWaitSemaphores;
+		std::vector<VkPipelineStageFlags> m_UploadWaitStages;
+
+		// Only created when the device supports descriptor indexing
+		VulkanBindlessTextureTable* m_BindlessTextures = nullptr;
+
+		// Sprites are queued while the frame is built and handed to the batcher in sort key order
+		RenderQueue m_SpriteQueue;
+		std::vector<SpriteDrawData> m_SpriteDraws;
+		uint32_t m_NextTextureSortID = 0;
+
+		// Glyphs of every string share one instance stream, drawn with one instanced draw per font atlas
+		std::vector<TextDrawData> m_TextDraws;
+		TextLayoutCache* m_TextLayoutCache;
+		VulkanSpriteBatcher* m_TextBatcher;
+
+		// Frames begun since startup, used to age cached text layouts and upload semaphores
+		uint64_t m_FrameNumber = 0;
 
-		uint32_t m_TextCount = 0;
-		std::vector<uint32_t> m_TextQuadCounts;
-		std::vector<VulkanBuffer*> m_TextIndexBuffers[FRAMES_IN_FLIGHT];
-		std::vector<VulkanBuffer*> m_TextVertexBuffers[FRAMES_IN_FLIGHT];
+		// Camera of the frame being recorded, shared by every pipeline through set 0
+		VulkanArenaAllocation m_CameraUniformBuffer;
 
 		Texture2D* m_UVDebugTexture = nullptr;
 
@@ -124,8 +251,9 @@ namespace BladeEngine::Graphics::Vulkan {
 		std::vector<VkSemaphore> renderFinishedSemaphores;
 		std::vector<VkFence> inFlightFences;
 
-		uint32_t m_UniformBufferCount = 0;
-		std::vector<VulkanBuffer*> m_UniformBuffers[FRAMES_IN_FLIGHT];
+		RenderStatistics m_FrameStatistics;
+		RenderStatistics m_LastFrameStatistics;
+		DescriptorCacheStatistics m_DescriptorStatisticsAtFrameStart;
 	};
 
 }
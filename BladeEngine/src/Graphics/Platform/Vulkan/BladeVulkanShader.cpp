@@ -27,6 +27,21 @@ VkShaderModule VulkanShader::CreateShaderModule(std::vector<char> data,
   return shaderModule;
 }
 
+void VulkanShader::GetSpecialization(ShaderVariantKey key,
+                                     ShaderSpecialization &specialization) {
+  for (uint32_t i = 0; i < ShaderFeatureCount; i++) {
+    specialization.Entries[i].constantID = i;
+    specialization.Entries[i].offset = i * sizeof(VkBool32);
+    specialization.Entries[i].size = sizeof(VkBool32);
+    specialization.Values[i] = (key & (1u << i)) ? VK_TRUE : VK_FALSE;
+  }
+
+  specialization.Info.mapEntryCount = ShaderFeatureCount;
+  specialization.Info.pMapEntries = specialization.Entries;
+  specialization.Info.dataSize = sizeof(specialization.Values);
+  specialization.Info.pData = specialization.Values;
+}
+
 void VulkanShader::Dispose(VkDevice device) {
   DestroyFragmentModule(device);
   DestroyVertexModule(device);
@@ -1,4 +1,6 @@
 #pragma once
+#include "../../ShaderVariant.hpp"
+
 #include <iostream>
 #include <vector>
 #include <vulkan/vulkan.h>
@@ -6,6 +8,14 @@
 namespace BladeEngine {
 namespace Graphics {
 namespace Vulkan {
+// Specialization constants of one variant, shared by both stages. Info points into the struct
+// itself, fill it in place with VulkanShader::GetSpecialization and don't copy it
+struct ShaderSpecialization {
+  VkSpecializationMapEntry Entries[ShaderFeatureCount];
+  VkBool32 Values[ShaderFeatureCount];
+  VkSpecializationInfo Info;
+};
+
 class VulkanShader {
 public:
   VulkanShader(VkDevice device, std::vector<char> vertexShaderData,
@@ -13,6 +23,11 @@ public:
   ~VulkanShader();
 
   void Dispose(VkDevice device);
+
+  // One VkBool32 per ShaderFeature with constant_id = bit index. Modules that don't
+  // declare a constant are unaffected by its entry
+  static void GetSpecialization(ShaderVariantKey key, ShaderSpecialization& specialization);
+
   VkShaderModule vertexModule;
   VkShaderModule fragmentModule;
 
@@ -11,80 +11,6 @@
 
 namespace BladeEngine::Graphics::Vulkan {
 
-	void VulkanSwapchain::CreateFramebuffers(VkDevice device, VkRenderPass renderPass)
-	{
-		std::vector<VkFramebuffer> framebuffers(imageViews.size());
-
-		for (size_t i = 0; i < imageViews.size(); i++) 
-		{
-			std::array<VkImageView, 2> attachments = { imageViews[i], depthImageView };
-
-			VkFramebufferCreateInfo framebufferInfo{};
-			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-			framebufferInfo.renderPass = renderPass;
-			framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
-			framebufferInfo.pAttachments = attachments.data();
-			framebufferInfo.width = extent.width;
-			framebufferInfo.height = extent.height;
-			framebufferInfo.layers = 1;
-
-			BLD_VK_CHECK(vkCreateFramebuffer(device, &framebufferInfo, nullptr, &framebuffers[i]),
-				"Failed to create framebuffer");
-		}
-
-		m_FramebuffersMap[renderPass] = framebuffers;
-	}
-
-	void VulkanSwapchain::DestroyFramebuffers(VkDevice device, VkRenderPass renderPass)
-	{
-		for (auto framebuffer : m_FramebuffersMap[renderPass])
-		{
-			vkDestroyFramebuffer(device, framebuffer, nullptr);
-		}
-	}
-
-
-	VkFormat VulkanSwapchain::FindSupportedFormat(
-		VkPhysicalDevice physicalDevice, const std::vector<VkFormat>& candidates,
-		VkImageTiling tiling, VkFormatFeatureFlags features) {
-		for (VkFormat format : candidates) {
-			VkFormatProperties props;
-			vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
-
-			if (tiling == VK_IMAGE_TILING_LINEAR &&
-				(props.linearTilingFeatures & features) == features) {
-				return format;
-			}
-			else if (tiling == VK_IMAGE_TILING_OPTIMAL &&
-				(props.optimalTilingFeatures & features) == features) {
-				return format;
-			}
-		}
-
-		throw std::runtime_error("failed to find supported format!");
-	}
-
-	VkFormat VulkanSwapchain::FindDepthFormat(VkPhysicalDevice physicalDevice) {
-		return FindSupportedFormat(
-			physicalDevice,
-			{ VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT,
-			 VK_FORMAT_D24_UNORM_S8_UINT },
-			VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
-	}
-
-	void VulkanSwapchain::CreateDepthResources(VkPhysicalDevice physicalDevice,
-		VkDevice device) {
-		VkFormat depthFormat = FindDepthFormat(physicalDevice);
-
-		CreateImage(
-			physicalDevice, device, extent.width, extent.height, depthFormat,
-			VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage, depthImageMemory);
-
-		depthImageView = CreateImageView(device, depthImage, depthFormat,
-			VK_IMAGE_ASPECT_DEPTH_BIT);
-	}
-
 	VkSurfaceFormatKHR VulkanSwapchain::ChooseSwapSurfaceFormat(
 		const std::vector<VkSurfaceFormatKHR>& availableFormats) {
 		for (const auto& availableFormat : availableFormats) {
@@ -203,51 +129,11 @@ namespace BladeEngine::Graphics::Vulkan {
 		vkGetSwapchainImagesKHR(device, swapchain, &imageCount, images.data());
 	}
 
-	VkImageView VulkanSwapchain::CreateImageView(VkDevice device, VkImage image,
-		VkFormat format,
-		VkImageAspectFlags aspectFlags) {
-		VkImageViewCreateInfo viewInfo{};
-		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
-		viewInfo.image = image;
-		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
-		viewInfo.format = format;
-		viewInfo.subresourceRange.aspectMask = aspectFlags;
-		viewInfo.subresourceRange.baseMipLevel = 0;
-		viewInfo.subresourceRange.levelCount = 1;
-		viewInfo.subresourceRange.baseArrayLayer = 0;
-		viewInfo.subresourceRange.layerCount = 1;
-
-		VkImageView imageView;
-		if (vkCreateImageView(device, &viewInfo, nullptr, &imageView) != VK_SUCCESS) {
-			throw std::runtime_error("failed to create texture image view!");
-		}
-
-		return imageView;
-	}
-
-	void VulkanSwapchain::CreateImageViews(VkDevice device) {
-
-		imageViews.resize(images.size());
-
-		for (uint32_t i = 0; i < images.size(); i++) {
-			imageViews[i] = CreateImageView(device, images[i], imageFormat,
-				VK_IMAGE_ASPECT_COLOR_BIT);
-		}
-	}
-
 	void VulkanSwapchain::Dispose(VkDevice device)
 	{
-		vkDestroyImage(device, depthImage, nullptr);
-		vkDestroyImageView(device, depthImageView, nullptr);
-		vkFreeMemory(device, depthImageMemory, nullptr);
-
-		for (auto image : images) {
-			vkDestroyImage(device, image, nullptr);
-		}
+		// The images belong to the swapchain and go away with it
+		VulkanRenderTarget::Dispose(device);
 
-		for (auto imageView : imageViews) {
-			vkDestroyImageView(device, imageView, nullptr);
-		}
 		vkDestroySwapchainKHR(device, swapchain, nullptr);
 	}
 
@@ -1,5 +1,6 @@
 #pragma once
 #include "../../../Core/Window.hpp"
+#include "VulkanRenderTarget.hpp"
 #include <vector>
 #include <vulkan/vulkan.h>
 #include <vulkan/vulkan_core.h>
@@ -10,14 +11,14 @@ namespace BladeEngine {
 namespace Graphics {
 namespace Vulkan {
 
-class VulkanSwapchain {
+class VulkanSwapchain : public VulkanRenderTarget {
 public:
   VulkanSwapchain(uint32_t width, uint32_t height, VkPhysicalDevice physicalDevice,
                   VkDevice device, VkSurfaceKHR surface);
 
   ~VulkanSwapchain() { }
 
-  void Dispose(VkDevice device);
+  void Dispose(VkDevice device) override;
 
   static VkSurfaceFormatKHR ChooseSwapSurfaceFormat(
       const std::vector<VkSurfaceFormatKHR> &availableFormats);
@@ -28,39 +29,11 @@ public:
 
   //init
   VkSwapchainKHR swapchain;
-  std::vector<VkImage> images;
-  std::vector<VkImageView> imageViews;
-  VkFormat imageFormat;
-  VkExtent2D extent;
-
-  VkImage depthImage;
-  VkDeviceMemory depthImageMemory;
-  VkImageView depthImageView;
-
-  //Add new Framebuffer set on Begin Drawing
-  std::unordered_map<VkRenderPass, std::vector<VkFramebuffer>> m_FramebuffersMap;
-
-  
-  VkFormat FindDepthFormat(VkPhysicalDevice physicalDevice);
-  
-  VkImageView CreateImageView(VkDevice device, VkImage image, VkFormat format,
-                              VkImageAspectFlags aspectFlags);
-  
-
-  void CreateFramebuffers(VkDevice device, VkRenderPass renderPass);
-  void DestroyFramebuffers(VkDevice device, VkRenderPass renderPass);
 
 private:
-  VkFormat FindSupportedFormat(VkPhysicalDevice physicalDevice,
-                               const std::vector<VkFormat> &candidates,
-                               VkImageTiling tiling,
-                               VkFormatFeatureFlags features);
-  void CreateDepthResources(VkPhysicalDevice physicalDevice, VkDevice device);
-
   void CreateSwapchain(uint32_t width, uint32_t height,
                        VkPhysicalDevice physicalDevice, VkDevice device,
                        VkSurfaceKHR surface);
-  void CreateImageViews(VkDevice device);
 };
 
 } // namespace Vulkan
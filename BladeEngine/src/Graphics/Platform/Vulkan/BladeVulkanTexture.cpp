@@ -5,6 +5,10 @@
 #include "VulkanCheck.hpp"
 #include "BladeVulkanUtils.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 namespace BladeEngine::Graphics::Vulkan {
 
 	VkFormat GetVulkanFormat(TextureFormat format)
@@ -21,6 +25,16 @@ namespace BladeEngine::Graphics::Vulkan {
 			return VK_FORMAT_R8G8B8A8_SRGB;
 		case TextureFormat::RGBA32F:
 			return VK_FORMAT_R8_SRGB;
+		case TextureFormat::BC1:
+			return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+		case TextureFormat::BC3:
+			return VK_FORMAT_BC3_SRGB_BLOCK;
+		case TextureFormat::BC7:
+			return VK_FORMAT_BC7_SRGB_BLOCK;
+		case TextureFormat::ETC2_RGB8:
+			return VK_FORMAT_ETC2_R8G8B8_SRGB_BLOCK;
+		case TextureFormat::ETC2_RGBA8:
+			return VK_FORMAT_ETC2_R8G8B8A8_SRGB_BLOCK;
 		}
 
 		BLD_CORE_ASSERT(false, "Unknown Texture Format");
@@ -64,10 +78,9 @@ namespace BladeEngine::Graphics::Vulkan {
 
 	VulkanTexture::VulkanTexture(
 		VkPhysicalDevice physicalDevice, VkDevice device,
-		VkQueue graphicsQueue, VkCommandPool commandPool,
-		Texture2D* texture)
+		VulkanUploadManager& uploadManager, Texture2D* texture)
 	{
-		CreateTextureImage(physicalDevice, device, graphicsQueue, commandPool, texture);
+		CreateTextureImage(physicalDevice, device, uploadManager, texture);
 		CreateTextureImageView(device, GetVulkanFormat(texture->GetFormat()));
 		CreateTextureSampler(physicalDevice, device, texture->GetSamplerConfiguration());
 	}
@@ -85,54 +98,138 @@ namespace BladeEngine::Graphics::Vulkan {
 
 	void VulkanTexture::CreateTextureImage(
 		VkPhysicalDevice physicalDevice,
-		VkDevice device, VkQueue graphicsQueue,
-		VkCommandPool commandPool,
+		VkDevice device,
+		VulkanUploadManager& uploadManager,
 		Texture2D* texture)
 	{
-		VkBuffer stagingBuffer;
-		VkDeviceMemory stagingBufferMemory;
-
 		uint32_t textureSize = texture->GetSize();
 		VkFormat textureFormat = GetVulkanFormat(texture->GetFormat());
 
-		CreateBuffer(physicalDevice, device, textureSize,
-			VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
-			VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-			stagingBuffer, stagingBufferMemory);
+		VkImageUsageFlags usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+
+		bool blitMips = false;
+		if (texture->GetMipLevels() > 1)
+		{
+			// Prebuilt chain from a .btex file
+			MipLevels = texture->GetMipLevels();
+		}
+		else if (texture->GetSamplerConfiguration()->GenerateMipmaps && !texture->IsCompressed())
+		{
+			MipLevels = (uint32_t)std::floor(std::log2(std::max(texture->GetWidth(), texture->GetHeight()))) + 1;
+
+			VkFormatProperties formatProperties;
+			vkGetPhysicalDeviceFormatProperties(physicalDevice, textureFormat, &formatProperties);
 
-		void* data;
-		vkMapMemory(device, stagingBufferMemory, 0, textureSize, 0, &data);
-		memcpy(data, texture->GetData(), static_cast<size_t>(textureSize));
-		vkUnmapMemory(device, stagingBufferMemory);
+			const VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT |
+				VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
+			blitMips = (formatProperties.optimalTilingFeatures & blitFeatures) == blitFeatures;
+
+			if (blitMips)
+			{
+				usage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+			}
+		}
 
 		CreateImage(
 			physicalDevice, device, texture->GetWidth(), texture->GetHeight(),
-			textureFormat, VK_IMAGE_TILING_OPTIMAL,
-			VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
-			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
-
-		TransitionImageLayout(
-			device, graphicsQueue, commandPool, textureImage, textureFormat,
-			VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-		CopyBufferToImage(device, graphicsQueue, commandPool,
-			stagingBuffer, textureImage,
-			static_cast<uint32_t>(texture->GetWidth()),
-			static_cast<uint32_t>(texture->GetHeight()));
-
-		TransitionImageLayout(device, graphicsQueue, commandPool,
-			textureImage, textureFormat,
-			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-			VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-
-		vkDestroyBuffer(device, stagingBuffer, nullptr);
-		vkFreeMemory(device, stagingBufferMemory, nullptr);
+			textureFormat, VK_IMAGE_TILING_OPTIMAL, usage,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory, MipLevels);
+
+		if (MipLevels == 1)
+		{
+			UploadID = uploadManager.UploadImage(textureImage, texture->GetData(), textureSize,
+				texture->GetWidth(), texture->GetHeight());
+		}
+		else if (texture->GetMipLevels() > 1)
+		{
+			std::vector<ImageUploadLevel> levels(MipLevels);
+
+			uint64_t offset = 0;
+			for (uint32_t i = 0; i < MipLevels; i++)
+			{
+				levels[i] = { offset, std::max(texture->GetWidth() >> i, 1u), std::max(texture->GetHeight() >> i, 1u) };
+				offset += texture->GetLevelSize(i);
+			}
+
+			UploadID = uploadManager.UploadImage(textureImage, texture->GetData(), textureSize,
+				levels.data(), MipLevels);
+		}
+		else if (blitMips)
+		{
+			UploadID = uploadManager.UploadImageWithMipChain(textureImage, texture->GetData(), textureSize,
+				texture->GetWidth(), texture->GetHeight(), MipLevels);
+		}
+		else
+		{
+			std::vector<ImageUploadLevel> levels;
+			std::vector<uint8_t> mipChain = BuildMipChain(texture, MipLevels, levels);
+
+			UploadID = uploadManager.UploadImage(textureImage, mipChain.data(), mipChain.size(),
+				levels.data(), (uint32_t)levels.size());
+		}
+	}
+
+	std::vector<uint8_t> VulkanTexture::BuildMipChain(Texture2D* texture, uint32_t mipLevels,
+		std::vector<ImageUploadLevel>& levels)
+	{
+		const uint32_t bpp = texture->GetBPP();
+
+		levels.resize(mipLevels);
+
+		uint64_t totalSize = 0;
+		uint32_t width = texture->GetWidth();
+		uint32_t height = texture->GetHeight();
+		for (uint32_t i = 0; i < mipLevels; i++)
+		{
+			levels[i] = { totalSize, width, height };
+			totalSize += (uint64_t)width * height * bpp;
+
+			width = width > 1 ? width / 2 : 1;
+			height = height > 1 ? height / 2 : 1;
+		}
+
+		std::vector<uint8_t> pixels(totalSize);
+		memcpy(pixels.data(), texture->GetData(), texture->GetSize());
+
+		// Plain average of the stored values, close enough to a linear space filter for sprites
+		for (uint32_t i = 1; i < mipLevels; i++)
+		{
+			const ImageUploadLevel& source = levels[i - 1];
+			const ImageUploadLevel& level = levels[i];
+
+			const uint8_t* src = pixels.data() + source.Offset;
+			uint8_t* dst = pixels.data() + level.Offset;
+
+			for (uint32_t y = 0; y < level.Height; y++)
+			{
+				// Odd sizes drop the last row or column instead of weighting in a third texel
+				uint32_t y0 = std::min(y * 2, source.Height - 1);
+				uint32_t y1 = std::min(y * 2 + 1, source.Height - 1);
+
+				for (uint32_t x = 0; x < level.Width; x++)
+				{
+					uint32_t x0 = std::min(x * 2, source.Width - 1);
+					uint32_t x1 = std::min(x * 2 + 1, source.Width - 1);
+
+					for (uint32_t c = 0; c < bpp; c++)
+					{
+						uint32_t sum =
+							src[(y0 * source.Width + x0) * bpp + c] + src[(y0 * source.Width + x1) * bpp + c] +
+							src[(y1 * source.Width + x0) * bpp + c] + src[(y1 * source.Width + x1) * bpp + c];
+
+						dst[(y * level.Width + x) * bpp + c] = (uint8_t)((sum + 2) / 4);
+					}
+				}
+			}
+		}
+
+		return pixels;
 	}
 
 	VkImageView CreateImageView(
 		VkDevice device, VkImage image,
-		VkFormat format, VkImageAspectFlags aspectFlags) 
+		VkFormat format, VkImageAspectFlags aspectFlags,
+		uint32_t mipLevels) 
 	{
 		VkImageViewCreateInfo viewInfo{};
 		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
@@ -141,7 +238,7 @@ namespace BladeEngine::Graphics::Vulkan {
 		viewInfo.format = format;
 		viewInfo.subresourceRange.aspectMask = aspectFlags;
 		viewInfo.subresourceRange.baseMipLevel = 0;
-		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.levelCount = mipLevels;
 		viewInfo.subresourceRange.baseArrayLayer = 0;
 		viewInfo.subresourceRange.layerCount = 1;
 
@@ -155,7 +252,7 @@ namespace BladeEngine::Graphics::Vulkan {
 	void VulkanTexture::CreateTextureImageView(VkDevice device, VkFormat format)
 	{
 		textureImageView = CreateImageView(
-			device, textureImage, format, VK_IMAGE_ASPECT_COLOR_BIT);
+			device, textureImage, format, VK_IMAGE_ASPECT_COLOR_BIT, MipLevels);
 	}
 
 	void VulkanTexture::CreateTextureSampler(
@@ -183,6 +280,9 @@ namespace BladeEngine::Graphics::Vulkan {
 		samplerInfo.compareEnable = VK_FALSE;
 		samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
 		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+		samplerInfo.minLod = 0.0f;
+		samplerInfo.maxLod = (float)MipLevels;
+		samplerInfo.mipLodBias = 0.0f;
 
 		BLD_VK_CHECK(vkCreateSampler(device, &samplerInfo, nullptr, &textureSampler),
 			"Failed to create texture sampler!");
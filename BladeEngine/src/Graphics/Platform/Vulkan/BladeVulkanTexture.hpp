@@ -2,16 +2,22 @@
 
 #include "../../Texture2D.hpp"
 #include "BladeVulkanSwapchain.hpp"
+#include "VulkanUploadManager.hpp"
 #include <vulkan/vulkan.h>
 
+#include <vector>
+
 namespace BladeEngine::Graphics::Vulkan {
 
+	VkFormat GetVulkanFormat(TextureFormat format);
+
 	class VulkanTexture 
 	{
 	public:
+		// The pixels are queued on the upload manager, the image can be bound right away but is only
+		// guaranteed resident once UploadID completes
 		VulkanTexture(VkPhysicalDevice physicalDevice, VkDevice device,
-			VkQueue graphicsQueue, VkCommandPool commandPool,
-			Texture2D* texture);
+			VulkanUploadManager& uploadManager, Texture2D* texture);
 
 		~VulkanTexture();
 
@@ -21,10 +27,26 @@ namespace BladeEngine::Graphics::Vulkan {
 		VkImageView textureImageView;
 		VkSampler textureSampler;
 
+		static const uint32_t InvalidBindlessIndex = ~0u;
+
+		// Slot in the bindless texture table, InvalidBindlessIndex when bindless is unsupported
+		uint32_t BindlessIndex = InvalidBindlessIndex;
+
+		// Small per-texture id used in render queue sort keys
+		uint32_t SortID = 0;
+
+		// Upload manager submission carrying the pixels
+		uint64_t UploadID = 0;
+
+		uint32_t MipLevels = 1;
+
 	private:
 		void CreateTextureImage(VkPhysicalDevice physicalDevice, VkDevice device,
-			VkQueue graphicsQueue, VkCommandPool commandPool, Texture2D* texture);
+			VulkanUploadManager& uploadManager, Texture2D* texture);
 		void CreateTextureImageView(VkDevice device, VkFormat format);
+		// Box filters every level from the previous one, for formats the device can not blit linearly
+		static std::vector<uint8_t> BuildMipChain(Texture2D* texture, uint32_t mipLevels,
+			std::vector<ImageUploadLevel>& levels);
 		void CreateTextureSampler(
 			VkPhysicalDevice physicalDevice, VkDevice device,
 			const Texture2D::SamplerConfiguration* samplerConfig);
@@ -184,7 +184,8 @@ namespace BladeEngine::Graphics::Vulkan {
 		uint32_t width, uint32_t height, 
 		VkFormat format, VkImageTiling tiling, 
 		VkImageUsageFlags usage, VkMemoryPropertyFlags properties, 
-		VkImage& image, VkDeviceMemory& imageMemory)
+		VkImage& image, VkDeviceMemory& imageMemory,
+		uint32_t mipLevels)
 	{
 		VkImageCreateInfo imageInfo{};
 		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
@@ -192,7 +193,7 @@ namespace BladeEngine::Graphics::Vulkan {
 		imageInfo.extent.width = width;
 		imageInfo.extent.height = height;
 		imageInfo.extent.depth = 1;
-		imageInfo.mipLevels = 1;
+		imageInfo.mipLevels = mipLevels;
 		imageInfo.arrayLayers = 1;
 		imageInfo.format = format;
 		imageInfo.tiling = tiling;
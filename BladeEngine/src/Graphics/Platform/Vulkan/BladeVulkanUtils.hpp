@@ -21,9 +21,15 @@ namespace BladeEngine::Graphics::Vulkan
 
 	struct PushConstantData
 	{
+		glm::mat4 Model;
 		glm::vec4 UVTransform;
 	};
 
+	struct CameraData
+	{
+		alignas(16) glm::mat4 ViewProjection;
+	};
+
 	void CreateBuffer(
 		VkPhysicalDevice physicalDevice,
 		VkDevice device,
@@ -84,7 +90,8 @@ namespace BladeEngine::Graphics::Vulkan
 		VkImageUsageFlags usage,
 		VkMemoryPropertyFlags properties,
 		VkImage& image,
-		VkDeviceMemory& imageMemory
+		VkDeviceMemory& imageMemory,
+		uint32_t mipLevels = 1
 	);
 
 
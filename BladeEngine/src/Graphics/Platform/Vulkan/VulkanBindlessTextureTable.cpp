@@ -0,0 +1,133 @@
+#include "VulkanBindlessTextureTable.hpp"
+
+#include "VulkanCheck.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	VulkanBindlessTextureTable::VulkanBindlessTextureTable(VkDevice device, uint32_t capacity)
+		: m_Capacity(std::min(capacity, MaxCapacity))
+	{
+		VkDescriptorSetLayoutBinding textureLayoutBinding{};
+		textureLayoutBinding.binding = 0;
+		textureLayoutBinding.descriptorCount = m_Capacity;
+		textureLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		textureLayoutBinding.pImmutableSamplers = nullptr;
+		textureLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+
+		// Slots are written while earlier frames are still in flight and most of them are never filled
+		VkDescriptorBindingFlagsEXT bindingFlags =
+			VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+			VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+			VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+
+		VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsInfo{};
+		bindingFlagsInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+		bindingFlagsInfo.bindingCount = 1;
+		bindingFlagsInfo.pBindingFlags = &bindingFlags;
+
+		VkDescriptorSetLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+		layoutInfo.pNext = &bindingFlagsInfo;
+		layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+		layoutInfo.bindingCount = 1;
+		layoutInfo.pBindings = &textureLayoutBinding;
+
+		BLD_VK_CHECK(vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &m_DescriptorSetLayout),
+			"Failed to create bindless texture descriptor set layout!");
+
+		VkDescriptorPoolSize poolSize{};
+		poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		poolSize.descriptorCount = m_Capacity;
+
+		VkDescriptorPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+		poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+		poolInfo.maxSets = 1;
+		poolInfo.poolSizeCount = 1;
+		poolInfo.pPoolSizes = &poolSize;
+
+		BLD_VK_CHECK(vkCreateDescriptorPool(device, &poolInfo, nullptr, &m_DescriptorPool),
+			"Failed to create bindless texture descriptor pool!");
+
+		VkDescriptorSetAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		allocInfo.descriptorPool = m_DescriptorPool;
+		allocInfo.descriptorSetCount = 1;
+		allocInfo.pSetLayouts = &m_DescriptorSetLayout;
+
+		BLD_VK_CHECK(vkAllocateDescriptorSets(device, &allocInfo, &m_DescriptorSet),
+			"Failed to allocate bindless texture descriptor set!");
+
+		// Handed out from the back, so the first texture gets slot 0
+		m_FreeIndices.reserve(m_Capacity);
+		for (uint32_t i = m_Capacity; i > 0; i--)
+		{
+			m_FreeIndices.push_back(i - 1);
+		}
+
+		BLD_CORE_INFO("Bindless texture table created with {} slots", m_Capacity);
+	}
+
+	VulkanBindlessTextureTable::~VulkanBindlessTextureTable() { }
+
+	void VulkanBindlessTextureTable::Dispose(VkDevice device)
+	{
+		vkDestroyDescriptorPool(device, m_DescriptorPool, nullptr);
+		vkDestroyDescriptorSetLayout(device, m_DescriptorSetLayout, nullptr);
+	}
+
+	void VulkanBindlessTextureTable::BeginFrame(uint32_t frameIndex)
+	{
+		m_FrameIndex = frameIndex;
+
+		auto& retired = m_RetiredIndices[m_FrameIndex];
+		m_FreeIndices.insert(m_FreeIndices.end(), retired.begin(), retired.end());
+		retired.clear();
+	}
+
+	void VulkanBindlessTextureTable::Register(VkDevice device, VulkanTexture* texture)
+	{
+		if (m_FreeIndices.empty())
+		{
+			throw std::runtime_error("bindless texture table is full!");
+		}
+
+		uint32_t index = m_FreeIndices.back();
+		m_FreeIndices.pop_back();
+
+		VkDescriptorImageInfo imageInfo{};
+		imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		imageInfo.imageView = texture->textureImageView;
+		imageInfo.sampler = texture->textureSampler;
+
+		VkWriteDescriptorSet descriptorWrite{};
+		descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		descriptorWrite.dstSet = m_DescriptorSet;
+		descriptorWrite.dstBinding = 0;
+		descriptorWrite.dstArrayElement = index;
+		descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		descriptorWrite.descriptorCount = 1;
+		descriptorWrite.pImageInfo = &imageInfo;
+
+		vkUpdateDescriptorSets(device, 1, &descriptorWrite, 0, nullptr);
+
+		texture->BindlessIndex = index;
+		m_TextureCount++;
+	}
+
+	void VulkanBindlessTextureTable::Unregister(VulkanTexture* texture)
+	{
+		if (texture->BindlessIndex == VulkanTexture::InvalidBindlessIndex)
+		{
+			return;
+		}
+
+		m_RetiredIndices[m_FrameIndex].push_back(texture->BindlessIndex);
+		texture->BindlessIndex = VulkanTexture::InvalidBindlessIndex;
+		m_TextureCount--;
+	}
+
+}
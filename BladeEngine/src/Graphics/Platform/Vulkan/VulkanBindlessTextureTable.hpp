@@ -0,0 +1,55 @@
+#pragma once
+
+#include "BladeVulkanGraphicsPipeline.hpp"
+#include "BladeVulkanTexture.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	// Single descriptor set holding every registered texture in one sampler array,
+	// shaders pick the texture with the index stored in the sprite's instance data
+	class VulkanBindlessTextureTable
+	{
+	public:
+		// Indices have to fit the 16 bits SpriteInstanceData reserves for them
+		static const uint32_t MaxCapacity = 1 << 16;
+
+		VulkanBindlessTextureTable(VkDevice device, uint32_t capacity);
+		~VulkanBindlessTextureTable();
+
+		VulkanBindlessTextureTable(const VulkanBindlessTextureTable&) = delete;
+		VulkanBindlessTextureTable& operator=(const VulkanBindlessTextureTable&) = delete;
+
+		void Dispose(VkDevice device);
+
+		// Recycles the indices released FRAMES_IN_FLIGHT frames ago, the frame's fence must have been waited on
+		void BeginFrame(uint32_t frameIndex);
+
+		// Writes the texture into a free slot and stores the slot in texture->BindlessIndex
+		void Register(VkDevice device, VulkanTexture* texture);
+		// The slot is only reused once the frames that may still sample it are done
+		void Unregister(VulkanTexture* texture);
+
+		VkDescriptorSetLayout GetDescriptorSetLayout() const { return m_DescriptorSetLayout; }
+		VkDescriptorSet GetDescriptorSet() const { return m_DescriptorSet; }
+
+		uint32_t GetCapacity() const { return m_Capacity; }
+		uint32_t GetTextureCount() const { return m_TextureCount; }
+
+	private:
+		uint32_t m_Capacity;
+		uint32_t m_TextureCount = 0;
+		uint32_t m_FrameIndex = 0;
+
+		VkDescriptorSetLayout m_DescriptorSetLayout;
+		VkDescriptorPool m_DescriptorPool;
+		VkDescriptorSet m_DescriptorSet;
+
+		std::vector<uint32_t> m_FreeIndices;
+		std::vector<uint32_t> m_RetiredIndices[FRAMES_IN_FLIGHT];
+	};
+
+}
@@ -41,6 +41,11 @@ namespace BladeEngine::Graphics::Vulkan {
 		vmaUnmapMemory(m_Allocator, m_Allocation);
 	}
 
+	void VulkanBuffer::Invalidate()
+	{
+		vmaInvalidateAllocation(m_Allocator, m_Allocation, 0, VK_WHOLE_SIZE);
+	}
+
 	void VulkanBuffer::Resize(uint64_t size)
 	{
 		m_Size = size;
@@ -83,17 +88,17 @@ namespace BladeEngine::Graphics::Vulkan {
 		{
 			bufferUsage |= VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
 		}
-		else if (((uint32_t)description.Usage & (uint32_t)BufferUsage::Index) ==
+		if (((uint32_t)description.Usage & (uint32_t)BufferUsage::Index) ==
 			(uint32_t)BufferUsage::Index)
 		{
 			bufferUsage |= VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
 		}
-		else if (((uint32_t)description.Usage & (uint32_t)BufferUsage::Uniform) ==
+		if (((uint32_t)description.Usage & (uint32_t)BufferUsage::Uniform) ==
 			(uint32_t)BufferUsage::Uniform)
 		{
 			bufferUsage |= VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
 		}
-		else if (((uint32_t)description.Usage & (uint32_t)BufferUsage::Storage) ==
+		if (((uint32_t)description.Usage & (uint32_t)BufferUsage::Storage) ==
 			(uint32_t)BufferUsage::Storage) 
 		{
 			bufferUsage |= VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
@@ -84,6 +84,9 @@ namespace BladeEngine::Graphics::Vulkan {
 		void* Map();
 		void Unmap();
 
+		// Makes device writes visible to Map, needed before reading HostRead memory that is not coherent
+		void Invalidate();
+
 		void Resize(uint64_t size);
 
 		VkBuffer GetBuffer() { return m_Buffer; }
@@ -0,0 +1,125 @@
+#include "VulkanFrameArena.hpp"
+
+#include "../../../Core/Log.hpp"
+
+#include <algorithm>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	static uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	VulkanFrameArena::VulkanFrameArena(VulkanResourceAllocator& allocator, VkPhysicalDevice physicalDevice, uint64_t chunkSize)
+		: m_Allocator(allocator), m_ChunkSize(chunkSize)
+	{
+		VkPhysicalDeviceProperties properties{};
+		vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+		m_UniformAlignment = std::max<uint64_t>(properties.limits.minUniformBufferOffsetAlignment, 16);
+		m_StorageAlignment = std::max<uint64_t>(properties.limits.minStorageBufferOffsetAlignment, 16);
+
+		for (uint32_t i = 0; i < FRAMES_IN_FLIGHT; i++)
+		{
+			m_FrameIndex = i;
+			CreateChunk(m_ChunkSize);
+		}
+
+		m_FrameIndex = 0;
+	}
+
+	VulkanFrameArena::~VulkanFrameArena()
+	{
+		for (uint32_t i = 0; i < FRAMES_IN_FLIGHT; i++)
+		{
+			for (auto& chunk : m_Chunks[i])
+			{
+				delete chunk.Buffer;
+			}
+
+			m_Chunks[i].clear();
+		}
+	}
+
+	void VulkanFrameArena::Reset(uint32_t frameIndex)
+	{
+		m_FrameIndex = frameIndex;
+		m_CurrentChunk = 0;
+		m_UsedSize = 0;
+
+		for (auto& chunk : m_Chunks[m_FrameIndex])
+		{
+			chunk.Offset = 0;
+		}
+	}
+
+	VulkanArenaAllocation VulkanFrameArena::Allocate(uint64_t size, uint64_t alignment)
+	{
+		auto& chunks = m_Chunks[m_FrameIndex];
+
+		while (m_CurrentChunk < chunks.size())
+		{
+			Chunk& chunk = chunks[m_CurrentChunk];
+
+			uint64_t offset = AlignUp(chunk.Offset, alignment);
+			if (offset + size <= chunk.Buffer->GetSize())
+			{
+				m_UsedSize += offset + size - chunk.Offset;
+				chunk.Offset = offset + size;
+
+				VulkanArenaAllocation allocation;
+				allocation.Buffer = chunk.Buffer;
+				allocation.Offset = offset;
+				allocation.Size = size;
+				allocation.Data = (uint8_t*)chunk.Buffer->Map() + offset;
+				return allocation;
+			}
+
+			m_CurrentChunk++;
+		}
+
+		Chunk& chunk = CreateChunk(std::max(size, m_ChunkSize));
+		m_CurrentChunk = (uint32_t)chunks.size() - 1;
+
+		BLD_CORE_INFO("Frame arena {} grew to {} chunks", m_FrameIndex, chunks.size());
+
+		m_UsedSize += size;
+		chunk.Offset = size;
+
+		VulkanArenaAllocation allocation;
+		allocation.Buffer = chunk.Buffer;
+		allocation.Offset = 0;
+		allocation.Size = size;
+		allocation.Data = chunk.Buffer->Map();
+		return allocation;
+	}
+
+	uint64_t VulkanFrameArena::GetCapacity() const
+	{
+		uint64_t capacity = 0;
+		for (const auto& chunk : m_Chunks[m_FrameIndex])
+		{
+			capacity += chunk.Buffer->GetSize();
+		}
+
+		return capacity;
+	}
+
+	VulkanFrameArena::Chunk& VulkanFrameArena::CreateChunk(uint64_t size)
+	{
+		BufferDescription description;
+		description.Size = size;
+		description.Usage = BufferUsage::Vertex | BufferUsage::Index | BufferUsage::Uniform | BufferUsage::Storage;
+		description.AllocationUsage = BufferAllocationUsage::HostWrite;
+		description.KeepMapped = true;
+
+		Chunk chunk;
+		chunk.Buffer = new VulkanBuffer(description, m_Allocator);
+		chunk.Offset = 0;
+
+		m_Chunks[m_FrameIndex].push_back(chunk);
+		return m_Chunks[m_FrameIndex].back();
+	}
+
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "BladeVulkanGraphicsPipeline.hpp"
+#include "VulkanBuffer.hpp"
+#include "VulkanResourceAllocator.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	// Sub-range of one of the arena's mapped buffers, only valid until the arena is reset for the same frame again
+	struct VulkanArenaAllocation
+	{
+		VulkanBuffer* Buffer = nullptr;
+		uint64_t Offset = 0;
+		uint64_t Size = 0;
+
+		void* Data = nullptr;
+	};
+
+	// Linear allocator for transient per-frame data (uniforms, vertices, indices, storage).
+	// Each frame in flight owns a list of large persistently mapped chunks, allocations bump an offset
+	// inside the current chunk and a new chunk is created only when all the existing ones are exhausted.
+	class VulkanFrameArena
+	{
+	public:
+		VulkanFrameArena(VulkanResourceAllocator& allocator, VkPhysicalDevice physicalDevice, uint64_t chunkSize);
+		~VulkanFrameArena();
+
+		VulkanFrameArena(const VulkanFrameArena&) = delete;
+		VulkanFrameArena& operator=(const VulkanFrameArena&) = delete;
+
+		// Rewinds all chunks of the frame, the frame's fence must already be signaled
+		void Reset(uint32_t frameIndex);
+
+		VulkanArenaAllocation Allocate(uint64_t size, uint64_t alignment);
+
+		VulkanArenaAllocation AllocateUniform(uint64_t size) { return Allocate(size, m_UniformAlignment); }
+		VulkanArenaAllocation AllocateStorage(uint64_t size) { return Allocate(size, m_StorageAlignment); }
+		VulkanArenaAllocation AllocateVertices(uint64_t size) { return Allocate(size, 16); }
+		VulkanArenaAllocation AllocateIndices(uint64_t size) { return Allocate(size, 4); }
+
+		// Bytes handed out since the last reset, including alignment padding
+		uint64_t GetUsedSize() const { return m_UsedSize; }
+		uint64_t GetCapacity() const;
+
+	private:
+		struct Chunk
+		{
+			VulkanBuffer* Buffer = nullptr;
+			uint64_t Offset = 0;
+		};
+
+		Chunk& CreateChunk(uint64_t size);
+
+	private:
+		VulkanResourceAllocator& m_Allocator;
+
+		uint64_t m_ChunkSize;
+		uint64_t m_UniformAlignment;
+		uint64_t m_StorageAlignment;
+
+		uint32_t m_FrameIndex = 0;
+		uint32_t m_CurrentChunk = 0;
+		uint64_t m_UsedSize = 0;
+
+		std::vector<Chunk> m_Chunks[FRAMES_IN_FLIGHT];
+	};
+
+}
@@ -0,0 +1,201 @@
+#include "VulkanGPUProfiler.hpp"
+
+#include "VulkanCheck.hpp"
+
+#include <algorithm>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	// Read back in bit order, so the list below follows the order of the flags
+	static const VkQueryPipelineStatisticFlags PipelineStatisticFlags =
+		VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+		VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+	static const uint32_t PipelineStatisticCount = 5;
+
+	VulkanGPUProfiler::VulkanGPUProfiler(VulkanDevice* device, uint32_t framesInFlight, uint32_t maxScopes)
+		: m_MaxScopes(maxScopes), m_TimestampPeriod(device->timestampPeriod)
+	{
+		m_FramePending.resize(framesInFlight, false);
+		m_FrameScopes.resize(framesInFlight);
+		m_TimestampResults.resize((size_t)maxScopes * 2);
+
+		const uint32_t validBits = device->timestampValidBits;
+		m_TimestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+		if (validBits == 0)
+		{
+			BLD_CORE_INFO("Graphics queue can not write timestamps, GPU timings disabled");
+			return;
+		}
+
+		// Every scope is a begin and end timestamp
+		VkQueryPoolCreateInfo timestampPoolInfo{};
+		timestampPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		timestampPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		timestampPoolInfo.queryCount = framesInFlight * maxScopes * 2;
+
+		BLD_VK_CHECK(vkCreateQueryPool(device->logicalDevice, &timestampPoolInfo, nullptr, &m_TimestampPool),
+			"Failed to create timestamp query pool");
+
+		m_Timings.Available = true;
+
+		if (device->pipelineStatisticsQuery)
+		{
+			VkQueryPoolCreateInfo statisticsPoolInfo{};
+			statisticsPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			statisticsPoolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+			statisticsPoolInfo.queryCount = framesInFlight;
+			statisticsPoolInfo.pipelineStatistics = PipelineStatisticFlags;
+
+			BLD_VK_CHECK(vkCreateQueryPool(device->logicalDevice, &statisticsPoolInfo, nullptr, &m_StatisticsPool),
+				"Failed to create pipeline statistics query pool");
+
+			m_Timings.PipelineStatisticsAvailable = true;
+		}
+	}
+
+	VulkanGPUProfiler::~VulkanGPUProfiler() { }
+
+	void VulkanGPUProfiler::Dispose(VkDevice device)
+	{
+		if (m_StatisticsPool)
+		{
+			vkDestroyQueryPool(device, m_StatisticsPool, nullptr);
+			m_StatisticsPool = VK_NULL_HANDLE;
+		}
+
+		if (m_TimestampPool)
+		{
+			vkDestroyQueryPool(device, m_TimestampPool, nullptr);
+			m_TimestampPool = VK_NULL_HANDLE;
+		}
+	}
+
+	void VulkanGPUProfiler::Resolve(VkDevice device, uint32_t frame)
+	{
+		if (!IsAvailable() || !m_FramePending[frame])
+		{
+			return;
+		}
+
+		m_FramePending[frame] = false;
+
+		const std::vector<const char*>& scopes = m_FrameScopes[frame];
+		if (scopes.empty())
+		{
+			return;
+		}
+
+		// No wait flag, the fence already covers the queries. NOT_READY keeps the previous results
+		VkResult result = vkGetQueryPoolResults(device, m_TimestampPool,
+			frame * m_MaxScopes * 2, (uint32_t)scopes.size() * 2,
+			scopes.size() * 2 * sizeof(uint64_t), m_TimestampResults.data(), sizeof(uint64_t),
+			VK_QUERY_RESULT_64_BIT);
+
+		if (result != VK_SUCCESS)
+		{
+			return;
+		}
+
+		const double millisecondsPerTick = m_TimestampPeriod / 1000000.0;
+
+		m_Timings.Scopes.resize(scopes.size());
+
+		uint64_t frameBegin = m_TimestampResults[0] & m_TimestampMask;
+		uint64_t frameEnd = frameBegin;
+
+		for (size_t i = 0; i < scopes.size(); i++)
+		{
+			const uint64_t begin = m_TimestampResults[i * 2] & m_TimestampMask;
+			const uint64_t end = m_TimestampResults[i * 2 + 1] & m_TimestampMask;
+
+			// Masked subtraction stays right when the counter wrapped in between
+			m_Timings.Scopes[i].Name = scopes[i];
+			m_Timings.Scopes[i].Milliseconds = (float)(((end - begin) & m_TimestampMask) * millisecondsPerTick);
+
+			frameBegin = std::min(frameBegin, begin);
+			frameEnd = std::max(frameEnd, end);
+		}
+
+		m_Timings.FrameMilliseconds = (float)(((frameEnd - frameBegin) & m_TimestampMask) * millisecondsPerTick);
+
+		if (m_StatisticsPool)
+		{
+			uint64_t statistics[PipelineStatisticCount] = {};
+
+			result = vkGetQueryPoolResults(device, m_StatisticsPool, frame, 1,
+				sizeof(statistics), statistics, sizeof(statistics), VK_QUERY_RESULT_64_BIT);
+
+			if (result == VK_SUCCESS)
+			{
+				m_Timings.InputAssemblyVertices = statistics[0];
+				m_Timings.InputAssemblyPrimitives = statistics[1];
+				m_Timings.VertexShaderInvocations = statistics[2];
+				m_Timings.ClippingPrimitives = statistics[3];
+				m_Timings.FragmentShaderInvocations = statistics[4];
+			}
+		}
+	}
+
+	void VulkanGPUProfiler::BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame)
+	{
+		if (!IsAvailable())
+		{
+			return;
+		}
+
+		m_RecordingFrame = frame;
+		m_FramePending[frame] = true;
+		m_FrameScopes[frame].clear();
+
+		vkCmdResetQueryPool(commandBuffer, m_TimestampPool, frame * m_MaxScopes * 2, m_MaxScopes * 2);
+
+		if (m_StatisticsPool)
+		{
+			vkCmdResetQueryPool(commandBuffer, m_StatisticsPool, frame, 1);
+			vkCmdBeginQuery(commandBuffer, m_StatisticsPool, frame, 0);
+		}
+	}
+
+	void VulkanGPUProfiler::EndFrame(VkCommandBuffer commandBuffer)
+	{
+		if (m_StatisticsPool)
+		{
+			vkCmdEndQuery(commandBuffer, m_StatisticsPool, m_RecordingFrame);
+		}
+	}
+
+	uint32_t VulkanGPUProfiler::BeginScope(VkCommandBuffer commandBuffer, const char* name)
+	{
+		std::vector<const char*>& scopes = m_FrameScopes[m_RecordingFrame];
+		if (!IsAvailable() || scopes.size() >= m_MaxScopes)
+		{
+			return m_MaxScopes;
+		}
+
+		const uint32_t scope = (uint32_t)scopes.size();
+		scopes.push_back(name);
+
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_TimestampPool,
+			(m_RecordingFrame * m_MaxScopes + scope) * 2);
+
+		return scope;
+	}
+
+	void VulkanGPUProfiler::EndScope(VkCommandBuffer commandBuffer, uint32_t scope)
+	{
+		if (scope >= m_MaxScopes)
+		{
+			return;
+		}
+
+		// Written once everything recorded before it finished executing
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_TimestampPool,
+			(m_RecordingFrame * m_MaxScopes + scope) * 2 + 1);
+	}
+
+}
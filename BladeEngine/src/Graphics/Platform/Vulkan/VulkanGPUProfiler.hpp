@@ -0,0 +1,63 @@
+#pragma once
+
+#include "BladeVulkanDevice.hpp"
+
+#include "../../GPUTimings.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	// Timestamp queries around the passes of every frame in flight, plus one pipeline statistics query over
+	// the frame when the device supports them. Each frame slot owns its own range of queries and they are
+	// only read back after the slot's fence was waited on, so resolving never stalls the CPU on the GPU.
+	// Every call is a no-op on queues without timestamp support
+	class VulkanGPUProfiler
+	{
+	public:
+		VulkanGPUProfiler(VulkanDevice* device, uint32_t framesInFlight, uint32_t maxScopes);
+		~VulkanGPUProfiler();
+
+		VulkanGPUProfiler(const VulkanGPUProfiler&) = delete;
+		VulkanGPUProfiler& operator=(const VulkanGPUProfiler&) = delete;
+
+		void Dispose(VkDevice device);
+
+		bool IsAvailable() const { return m_TimestampPool != VK_NULL_HANDLE; }
+
+		// Reads what the slot recorded the last time it was used, its fence must have signaled
+		void Resolve(VkDevice device, uint32_t frame);
+
+		// Resets the slot's queries, recorded outside of any render pass before the first scope
+		void BeginFrame(VkCommandBuffer commandBuffer, uint32_t frame);
+		// Also outside of any render pass, after the last scope
+		void EndFrame(VkCommandBuffer commandBuffer);
+
+		// Scopes past maxScopes are dropped, EndScope ignores the index BeginScope returned for them
+		uint32_t BeginScope(VkCommandBuffer commandBuffer, const char* name);
+		void EndScope(VkCommandBuffer commandBuffer, uint32_t scope);
+
+		const GPUTimings& GetTimings() const { return m_Timings; }
+
+	private:
+		uint32_t m_MaxScopes;
+
+		VkQueryPool m_TimestampPool = VK_NULL_HANDLE;
+		VkQueryPool m_StatisticsPool = VK_NULL_HANDLE;
+
+		// Nanoseconds per tick and the bits of a timestamp that hold a value
+		float m_TimestampPeriod;
+		uint64_t m_TimestampMask;
+
+		// Slot being recorded, which slots hold queries not read yet and the scope names each of them recorded
+		uint32_t m_RecordingFrame = 0;
+		std::vector<bool> m_FramePending;
+		std::vector<std::vector<const char*>> m_FrameScopes;
+
+		std::vector<uint64_t> m_TimestampResults;
+		GPUTimings m_Timings;
+	};
+
+}
@@ -0,0 +1,127 @@
+#include "VulkanOffscreenTarget.hpp"
+
+#include "BladeVulkanUtils.hpp"
+#include "VulkanCheck.hpp"
+
+#include <string.h>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	VulkanOffscreenTarget::VulkanOffscreenTarget(
+		uint32_t width, uint32_t height, uint32_t imageCount,
+		VkPhysicalDevice physicalDevice, VkDevice device, VulkanResourceAllocator& allocator)
+		: m_Allocator(allocator)
+	{
+		imageFormat = VK_FORMAT_R8G8B8A8_SRGB;
+		extent = { width, height };
+		finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+		images.resize(imageCount);
+		m_ImageMemory.resize(imageCount);
+		m_ReadbackBuffers.resize(imageCount, nullptr);
+
+		for (uint32_t i = 0; i < imageCount; i++)
+		{
+			CreateImage(
+				physicalDevice, device, width, height, imageFormat,
+				VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+				VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, images[i], m_ImageMemory[i]);
+		}
+
+		CreateImageViews(device);
+		CreateDepthResources(physicalDevice, device);
+	}
+
+	VulkanOffscreenTarget::~VulkanOffscreenTarget() { }
+
+	void VulkanOffscreenTarget::Dispose(VkDevice device)
+	{
+		VulkanRenderTarget::Dispose(device);
+
+		for (size_t i = 0; i < images.size(); i++)
+		{
+			vkDestroyImage(device, images[i], nullptr);
+			vkFreeMemory(device, m_ImageMemory[i], nullptr);
+
+			delete m_ReadbackBuffers[i];
+		}
+
+		images.clear();
+		m_ImageMemory.clear();
+		m_ReadbackBuffers.clear();
+	}
+
+	void VulkanOffscreenTarget::RecordReadback(VkCommandBuffer commandBuffer, uint32_t imageIndex)
+	{
+		const uint64_t size = (uint64_t)extent.width * extent.height * 4;
+
+		if (!m_ReadbackBuffers[imageIndex])
+		{
+			BufferDescription description;
+			description.Size = size;
+			description.Usage = BufferUsage::TransferDestination;
+			description.AllocationUsage = BufferAllocationUsage::HostRead;
+			description.KeepMapped = true;
+
+			m_ReadbackBuffers[imageIndex] = new VulkanBuffer(description, m_Allocator);
+		}
+
+		// The render pass already left the image in TRANSFER_SRC_OPTIMAL, only its writes have to be waited on
+		VkImageMemoryBarrier imageBarrier{};
+		imageBarrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		imageBarrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		imageBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		imageBarrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		imageBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		imageBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		imageBarrier.image = images[imageIndex];
+		imageBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+		vkCmdPipelineBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &imageBarrier);
+
+		VkBufferImageCopy region{};
+		region.bufferOffset = 0;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { extent.width, extent.height, 1 };
+
+		vkCmdCopyImageToBuffer(commandBuffer, images[imageIndex], VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			m_ReadbackBuffers[imageIndex]->GetBuffer(), 1, &region);
+
+		VkBufferMemoryBarrier bufferBarrier{};
+		bufferBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		bufferBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		bufferBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		bufferBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		bufferBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		bufferBarrier.buffer = m_ReadbackBuffers[imageIndex]->GetBuffer();
+		bufferBarrier.offset = 0;
+		bufferBarrier.size = VK_WHOLE_SIZE;
+
+		vkCmdPipelineBarrier(commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+			0, 0, nullptr, 1, &bufferBarrier, 0, nullptr);
+	}
+
+	void VulkanOffscreenTarget::ReadPixels(uint32_t imageIndex, std::vector<uint8_t>& pixels)
+	{
+		VulkanBuffer* buffer = m_ReadbackBuffers[imageIndex];
+		if (!buffer)
+		{
+			pixels.clear();
+			return;
+		}
+
+		buffer->Invalidate();
+
+		pixels.resize((size_t)extent.width * extent.height * 4);
+		memcpy(pixels.data(), buffer->Map(), pixels.size());
+		buffer->Unmap();
+	}
+
+}
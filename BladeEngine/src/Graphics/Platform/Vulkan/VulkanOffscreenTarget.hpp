@@ -0,0 +1,42 @@
+#pragma once
+
+#include "VulkanRenderTarget.hpp"
+#include "VulkanBuffer.hpp"
+#include "VulkanResourceAllocator.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <vector>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	// Render target for runs without a window. The color images are plain device images the frames cycle
+	// through, left in TRANSFER_SRC_OPTIMAL by the render pass so any of them can be copied back to the CPU.
+	// Needs nothing but a graphics queue, so it also works on software implementations like lavapipe
+	class VulkanOffscreenTarget : public VulkanRenderTarget
+	{
+	public:
+		// Always RGBA8 sRGB, the same encoding a B8G8R8A8_SRGB swapchain would show
+		VulkanOffscreenTarget(uint32_t width, uint32_t height, uint32_t imageCount,
+			VkPhysicalDevice physicalDevice, VkDevice device, VulkanResourceAllocator& allocator);
+		~VulkanOffscreenTarget();
+
+		VulkanOffscreenTarget(const VulkanOffscreenTarget&) = delete;
+		VulkanOffscreenTarget& operator=(const VulkanOffscreenTarget&) = delete;
+
+		void Dispose(VkDevice device) override;
+
+		// Copies the image into its readback buffer, recorded after the render pass that wrote it
+		void RecordReadback(VkCommandBuffer commandBuffer, uint32_t imageIndex);
+		// RGBA8 rows top to bottom, the commands recorded by RecordReadback must have completed
+		void ReadPixels(uint32_t imageIndex, std::vector<uint8_t>& pixels);
+
+	private:
+		VulkanResourceAllocator& m_Allocator;
+
+		std::vector<VkDeviceMemory> m_ImageMemory;
+		// Created on the first readback of each image
+		std::vector<VulkanBuffer*> m_ReadbackBuffers;
+	};
+
+}
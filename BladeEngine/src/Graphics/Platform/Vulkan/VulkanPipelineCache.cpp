@@ -0,0 +1,205 @@
+#include "VulkanPipelineCache.hpp"
+
+#include "VulkanCheck.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	static const uint32_t PipelineCacheMagic = 0x43504C42; // "BLPC" read as little endian
+	static const uint32_t PipelineCacheVersion = 1;
+
+	// Written in front of the driver's data. The driver version is not part of the header Vulkan
+	// writes itself and some drivers accept stale data from an older version of themselves
+	struct PipelineCacheFileHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t VendorID;
+		uint32_t DeviceID;
+		uint32_t DriverVersion;
+		uint8_t PipelineCacheUUID[VK_UUID_SIZE];
+		uint64_t DataSize;
+		uint64_t DataHash;
+	};
+
+	static uint64_t HashBytes(const uint8_t* data, size_t size)
+	{
+		// FNV-1a
+		uint64_t hash = 0xCBF29CE484222325ull;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ data[i]) * 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	VulkanPipelineCache::VulkanPipelineCache(VkPhysicalDevice physicalDevice, VkDevice device, const std::string& path)
+		: m_Path(path)
+	{
+		vkGetPhysicalDeviceProperties(physicalDevice, &m_DeviceProperties);
+
+		std::vector<uint8_t> file;
+		if (FILE* handle = fopen(m_Path.c_str(), "rb"))
+		{
+			fseek(handle, 0, SEEK_END);
+			long size = ftell(handle);
+			fseek(handle, 0, SEEK_SET);
+
+			file.resize(size > 0 ? (size_t)size : 0);
+			if (fread(file.data(), 1, file.size(), handle) != file.size())
+			{
+				file.clear();
+			}
+			fclose(handle);
+		}
+
+		size_t dataOffset = 0;
+		m_Loaded = !file.empty() && Validate(file, dataOffset);
+
+		VkPipelineCacheCreateInfo cacheInfo{};
+		cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		if (m_Loaded)
+		{
+			cacheInfo.initialDataSize = file.size() - dataOffset;
+			cacheInfo.pInitialData = file.data() + dataOffset;
+			m_SavedHash = HashBytes(file.data() + dataOffset, cacheInfo.initialDataSize);
+		}
+
+		BLD_VK_CHECK(vkCreatePipelineCache(device, &cacheInfo, nullptr, &m_PipelineCache),
+			"Failed to create pipeline cache!");
+
+		if (m_Loaded)
+		{
+			BLD_CORE_INFO("Loaded {} KB of pipeline cache from {}", cacheInfo.initialDataSize / 1024, m_Path);
+		}
+	}
+
+	VulkanPipelineCache::~VulkanPipelineCache()
+	{
+	}
+
+	bool VulkanPipelineCache::Validate(const std::vector<uint8_t>& file, size_t& dataOffset) const
+	{
+		PipelineCacheFileHeader header;
+		if (file.size() < sizeof(header))
+		{
+			return false;
+		}
+		memcpy(&header, file.data(), sizeof(header));
+
+		if (header.Magic != PipelineCacheMagic || header.Version != PipelineCacheVersion)
+		{
+			return false;
+		}
+
+		if (header.VendorID != m_DeviceProperties.vendorID || header.DeviceID != m_DeviceProperties.deviceID ||
+			header.DriverVersion != m_DeviceProperties.driverVersion ||
+			memcmp(header.PipelineCacheUUID, m_DeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+		{
+			BLD_CORE_INFO("Pipeline cache {} was written by another GPU or driver, starting empty", m_Path);
+			return false;
+		}
+
+		const uint8_t* data = file.data() + sizeof(header);
+		if (header.DataSize != file.size() - sizeof(header) || header.DataHash != HashBytes(data, header.DataSize))
+		{
+			BLD_CORE_WARN("Pipeline cache {} is corrupted, starting empty", m_Path);
+			return false;
+		}
+
+		// The driver checks its own header too, a bad one would only be ignored but is cheap to catch here
+		VkPipelineCacheHeaderVersionOne driverHeader;
+		if (header.DataSize < sizeof(driverHeader))
+		{
+			return false;
+		}
+		memcpy(&driverHeader, data, sizeof(driverHeader));
+
+		if (driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+			driverHeader.vendorID != m_DeviceProperties.vendorID || driverHeader.deviceID != m_DeviceProperties.deviceID ||
+			memcmp(driverHeader.pipelineCacheUUID, m_DeviceProperties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+		{
+			return false;
+		}
+
+		dataOffset = sizeof(header);
+		return true;
+	}
+
+	void VulkanPipelineCache::Save(VkDevice device)
+	{
+		size_t size = 0;
+		if (vkGetPipelineCacheData(device, m_PipelineCache, &size, nullptr) != VK_SUCCESS || size == 0)
+		{
+			return;
+		}
+
+		std::vector<uint8_t> file(sizeof(PipelineCacheFileHeader) + size);
+		if (vkGetPipelineCacheData(device, m_PipelineCache, &size, file.data() + sizeof(PipelineCacheFileHeader)) != VK_SUCCESS)
+		{
+			return;
+		}
+		file.resize(sizeof(PipelineCacheFileHeader) + size);
+
+		uint64_t hash = HashBytes(file.data() + sizeof(PipelineCacheFileHeader), size);
+		if (hash == m_SavedHash)
+		{
+			return;
+		}
+
+		PipelineCacheFileHeader header;
+		header.Magic = PipelineCacheMagic;
+		header.Version = PipelineCacheVersion;
+		header.VendorID = m_DeviceProperties.vendorID;
+		header.DeviceID = m_DeviceProperties.deviceID;
+		header.DriverVersion = m_DeviceProperties.driverVersion;
+		memcpy(header.PipelineCacheUUID, m_DeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+		header.DataSize = size;
+		header.DataHash = hash;
+		memcpy(file.data(), &header, sizeof(header));
+
+		std::error_code error;
+		std::filesystem::path path(m_Path);
+		if (path.has_parent_path())
+		{
+			std::filesystem::create_directories(path.parent_path(), error);
+		}
+
+		std::string temporaryPath = m_Path + ".tmp";
+		FILE* handle = fopen(temporaryPath.c_str(), "wb");
+		if (!handle)
+		{
+			BLD_CORE_WARN("Failed to write pipeline cache {}", m_Path);
+			return;
+		}
+
+		bool written = fwrite(file.data(), 1, file.size(), handle) == file.size();
+		written = fclose(handle) == 0 && written;
+
+		if (written)
+		{
+			std::filesystem::rename(temporaryPath, path, error);
+		}
+
+		if (!written || error)
+		{
+			BLD_CORE_WARN("Failed to write pipeline cache {}", m_Path);
+			std::filesystem::remove(temporaryPath, error);
+			return;
+		}
+
+		m_SavedHash = hash;
+	}
+
+	void VulkanPipelineCache::Dispose(VkDevice device)
+	{
+		vkDestroyPipelineCache(device, m_PipelineCache, nullptr);
+		m_PipelineCache = VK_NULL_HANDLE;
+	}
+
+}
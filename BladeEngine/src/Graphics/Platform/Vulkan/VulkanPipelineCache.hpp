@@ -0,0 +1,45 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+#include <vector>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	// VkPipelineCache shared by every pipeline of the renderer and kept on disk between runs, so pipelines
+	// the driver compiled once are not compiled again. Data written by another GPU or driver version is
+	// dropped when loading and the cache starts empty
+	class VulkanPipelineCache
+	{
+	public:
+		VulkanPipelineCache(VkPhysicalDevice physicalDevice, VkDevice device, const std::string& path);
+		~VulkanPipelineCache();
+
+		VulkanPipelineCache(const VulkanPipelineCache&) = delete;
+		VulkanPipelineCache& operator=(const VulkanPipelineCache&) = delete;
+
+		// Writes the cache back to its file, through a temporary file so a crash never leaves half of it
+		void Save(VkDevice device);
+		void Dispose(VkDevice device);
+
+		VkPipelineCache GetPipelineCache() const { return m_PipelineCache; }
+
+		// True when the cache was created from the data on disk
+		bool WasLoaded() const { return m_Loaded; }
+
+	private:
+		// Checks the data against our header and the header Vulkan puts at the start of it
+		bool Validate(const std::vector<uint8_t>& file, size_t& dataOffset) const;
+
+	private:
+		std::string m_Path;
+		VkPhysicalDeviceProperties m_DeviceProperties;
+
+		VkPipelineCache m_PipelineCache = VK_NULL_HANDLE;
+		// Hash of the data last loaded or saved, saving is skipped while it does not change
+		uint64_t m_SavedHash = 0;
+		bool m_Loaded = false;
+	};
+
+}
@@ -7,10 +7,11 @@ namespace BladeEngine::Graphics::Vulkan {
 	VulkanRenderPass::VulkanRenderPass(
 		VulkanDevice* device, 
 		VkFormat colorAttachmentFormat, 
-		VkFormat depthAttachementFormat)
+		VkFormat depthAttachementFormat,
+		VkImageLayout finalLayout)
 		: m_Device(device)
 	{
-		CreateRenderPass(colorAttachmentFormat, depthAttachementFormat);
+		CreateRenderPass(colorAttachmentFormat, depthAttachementFormat, finalLayout);
 	}
 
 	VulkanRenderPass::~VulkanRenderPass()
@@ -20,7 +21,8 @@ namespace BladeEngine::Graphics::Vulkan {
 
 	void VulkanRenderPass::CreateRenderPass(
 		VkFormat colorAttachmentFormat,
-		VkFormat depthAttachementFormat)
+		VkFormat depthAttachementFormat,
+		VkImageLayout finalLayout)
 	{
 		VkAttachmentDescription colorAttachment{};
 		colorAttachment.format = colorAttachmentFormat;
@@ -30,7 +32,7 @@ namespace BladeEngine::Graphics::Vulkan {
 		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		colorAttachment.finalLayout = finalLayout;
 
 		VkAttachmentDescription depthAttachment{};
 		depthAttachment.format = depthAttachementFormat;
@@ -10,13 +10,15 @@ namespace BladeEngine::Graphics::Vulkan {
 	class VulkanRenderPass
 	{
 	public:
-		VulkanRenderPass(VulkanDevice* device, VkFormat colorAttachmentFormat, VkFormat depthAttachementFormat);
+		// finalLayout is the layout the color attachment is left in, the render target's finalLayout
+		VulkanRenderPass(VulkanDevice* device, VkFormat colorAttachmentFormat, VkFormat depthAttachementFormat,
+			VkImageLayout finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 		~VulkanRenderPass();
 
 		VkRenderPass GetRenderPass() { return m_RenderPass; }
 
 	private:
-		void CreateRenderPass(VkFormat colorAttachmentFormat, VkFormat depthAttachementFormat);
+		void CreateRenderPass(VkFormat colorAttachmentFormat, VkFormat depthAttachementFormat, VkImageLayout finalLayout);
 
 	private:
 		VulkanDevice* m_Device;
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	// Color images frames are rendered into, the depth buffer they share and their framebuffers per render pass.
+	// VulkanSwapchain presents them to a window surface, VulkanOffscreenTarget keeps them for readback
+	class VulkanRenderTarget
+	{
+	public:
+		virtual ~VulkanRenderTarget() { }
+
+		// Destroys the depth buffer and the color image views, framebuffers are destroyed per render pass
+		virtual void Dispose(VkDevice device);
+
+		VkFormat FindDepthFormat(VkPhysicalDevice physicalDevice);
+
+		VkImageView CreateImageView(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags);
+
+		void CreateFramebuffers(VkDevice device, VkRenderPass renderPass);
+		void DestroyFramebuffers(VkDevice device, VkRenderPass renderPass);
+
+		std::vector<VkImage> images;
+		std::vector<VkImageView> imageViews;
+		VkFormat imageFormat;
+		VkExtent2D extent;
+
+		// Layout render passes leave the color images in
+		VkImageLayout finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+		VkImage depthImage;
+		VkDeviceMemory depthImageMemory;
+		VkImageView depthImageView;
+
+		//Add new Framebuffer set on Begin Drawing
+		std::unordered_map<VkRenderPass, std::vector<VkFramebuffer>> m_FramebuffersMap;
+
+	protected:
+		VkFormat FindSupportedFormat(VkPhysicalDevice physicalDevice, const std::vector<VkFormat>& candidates,
+			VkImageTiling tiling, VkFormatFeatureFlags features);
+
+		void CreateImageViews(VkDevice device);
+		void CreateDepthResources(VkPhysicalDevice physicalDevice, VkDevice device);
+	};
+
+}
@@ -0,0 +1,247 @@
+#include "VulkanSpriteBatch.hpp"
+
+#include "BladeVulkanMesh.hpp"
+
+#include "../../../Core/Base.hpp"
+
+#include "../../Mesh.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include <vector>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	VulkanSpriteBatcher::VulkanSpriteBatcher(VulkanResourceAllocator& allocator, VulkanFrameArena& arena, uint32_t quadsPerPage)
+		: m_Allocator(allocator), m_Arena(arena), m_QuadsPerPage(quadsPerPage)
+	{
+	}
+
+	VulkanSpriteBatcher::~VulkanSpriteBatcher()
+	{
+		delete m_IndexBuffer;
+	}
+
+	void VulkanSpriteBatcher::Begin(SpriteRenderMode mode)
+	{
+		m_Mode = mode;
+
+		// Every quad uses the same index pattern and batches never cross a page,
+		// so a single page sized index buffer can be shared by all frames
+		if (!UsesInstanceData() && !m_IndexBuffer)
+		{
+			std::vector<uint32_t> indices(m_QuadsPerPage * 6);
+			for (uint32_t i = 0; i < m_QuadsPerPage; i++)
+			{
+				indices[i * 6 + 0] = i * 4 + 0;
+				indices[i * 6 + 1] = i * 4 + 1;
+				indices[i * 6 + 2] = i * 4 + 2;
+				indices[i * 6 + 3] = i * 4 + 2;
+				indices[i * 6 + 4] = i * 4 + 3;
+				indices[i * 6 + 5] = i * 4 + 0;
+			}
+
+			BufferDescription indexBufferDescription;
+			indexBufferDescription.Usage = BufferUsage::Index;
+			indexBufferDescription.AllocationUsage = BufferAllocationUsage::HostWrite;
+			indexBufferDescription.Size = indices.size() * sizeof(uint32_t);
+			indexBufferDescription.Data = indices.data();
+
+			m_IndexBuffer = new VulkanBuffer(indexBufferDescription, m_Allocator);
+		}
+
+		m_QuadCount = 0;
+		m_Batches.clear();
+
+		m_Page = VulkanArenaAllocation();
+		m_PageQuadCount = 0;
+	}
+
+	void VulkanSpriteBatcher::Submit(
+		VulkanGraphicsPipeline* pipeline,
+		ShaderVariantKey variant,
+		VulkanTexture* texture,
+		const glm::mat4& transform,
+		const glm::vec4& uvTransform)
+	{
+		ReserveQuad();
+
+		if (UsesInstanceData())
+		{
+			WriteInstance(texture, transform, uvTransform);
+		}
+		else
+		{
+			WriteVertices(transform, uvTransform);
+		}
+
+		AppendQuad(pipeline, variant, texture);
+	}
+
+	void VulkanSpriteBatcher::SubmitInstance(
+		VulkanGraphicsPipeline* pipeline,
+		ShaderVariantKey variant,
+		VulkanTexture* texture,
+		const SpriteInstanceData& instance)
+	{
+		BLD_CORE_ASSERT(UsesInstanceData(), "Instances can't be submitted to a batched sprite batcher");
+
+		ReserveQuad();
+
+		((SpriteInstanceData*)m_Page.Data)[m_PageQuadCount] = instance;
+
+		AppendQuad(pipeline, variant, texture);
+	}
+
+	void VulkanSpriteBatcher::BindBuffers(VkCommandBuffer commandBuffer)
+	{
+		m_BoundVertexBuffer = VK_NULL_HANDLE;
+		m_BoundVertexOffset = 0;
+
+		if (UsesInstanceData())
+		{
+			// Every instance draws the same unit quad, placed by its instance data in the vertex shader
+			VulkanMesh* quad = (VulkanMesh*)Mesh::Quad()->GetGPUMesh();
+
+			VkBuffer vertexBuffers[] = { quad->VertexBuffer->GetBuffer() };
+			VkDeviceSize offsets[] = { 0 };
+
+			vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+			vkCmdBindIndexBuffer(commandBuffer, quad->IndexBuffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT16);
+			return;
+		}
+
+		vkCmdBindIndexBuffer(commandBuffer, m_IndexBuffer->GetBuffer(), 0, VK_INDEX_TYPE_UINT32);
+	}
+
+	void VulkanSpriteBatcher::DrawBatch(VkCommandBuffer commandBuffer, const SpriteBatch& batch)
+	{
+		if (UsesInstanceData())
+		{
+			// The batch's instance page is bound through its descriptor set, gl_InstanceIndex starts at FirstQuad
+			vkCmdDrawIndexed(commandBuffer, 6, batch.QuadCount, 0, 0, batch.FirstQuad);
+			return;
+		}
+
+		if (batch.Buffer != m_BoundVertexBuffer || batch.BufferOffset != m_BoundVertexOffset)
+		{
+			VkBuffer vertexBuffers[] = { batch.Buffer };
+			VkDeviceSize offsets[] = { batch.BufferOffset };
+
+			vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+
+			m_BoundVertexBuffer = batch.Buffer;
+			m_BoundVertexOffset = batch.BufferOffset;
+		}
+
+		vkCmdDrawIndexed(commandBuffer, batch.QuadCount * 6, 1, batch.FirstQuad * 6, 0, 0);
+	}
+
+	uint64_t VulkanSpriteBatcher::GetPageSize() const
+	{
+		if (UsesInstanceData())
+		{
+			return (uint64_t)m_QuadsPerPage * sizeof(SpriteInstanceData);
+		}
+
+		return (uint64_t)m_QuadsPerPage * 4 * sizeof(VertexColorTexture);
+	}
+
+	void VulkanSpriteBatcher::WriteVertices(const glm::mat4& transform, const glm::vec4& uvTransform)
+	{
+		// Same corners and uvs as Mesh::Quad, expanded from the transform's basis instead of a full mat4 * vec4 per corner
+		const glm::vec3 right = glm::vec3(transform[0]) * 0.5f;
+		const glm::vec3 up = glm::vec3(transform[1]) * 0.5f;
+		const glm::vec3 origin = glm::vec3(transform[3]);
+
+		const glm::vec2 uvOffset = glm::vec2(uvTransform.x, uvTransform.y);
+		const glm::vec2 uvScale = glm::vec2(uvTransform.z, uvTransform.w);
+
+		const glm::vec4 color = glm::vec4(1.0f);
+
+		VertexColorTexture* vertices = (VertexColorTexture*)m_Page.Data + m_PageQuadCount * 4;
+
+		vertices[0].position = origin - right + up;
+		vertices[0].color = color;
+		vertices[0].textureCoordinate = uvOffset;
+
+		vertices[1].position = origin - right - up;
+		vertices[1].color = color;
+		vertices[1].textureCoordinate = glm::vec2(0.0f, 1.0f) * uvScale + uvOffset;
+
+		vertices[2].position = origin + right - up;
+		vertices[2].color = color;
+		vertices[2].textureCoordinate = uvScale + uvOffset;
+
+		vertices[3].position = origin + right + up;
+		vertices[3].color = color;
+		vertices[3].textureCoordinate = glm::vec2(1.0f, 0.0f) * uvScale + uvOffset;
+	}
+
+	void VulkanSpriteBatcher::WriteInstance(VulkanTexture* texture, const glm::mat4& transform, const glm::vec4& uvTransform)
+	{
+		SpriteInstanceData* instance = (SpriteInstanceData*)m_Page.Data + m_PageQuadCount;
+
+		instance->Basis = glm::vec4(transform[0].x, transform[0].y, transform[1].x, transform[1].y);
+		instance->Translation = glm::vec2(transform[3].x, transform[3].y);
+		instance->Tint = 0xFFFFFFFF;
+		instance->DepthTexture = (uint32_t)glm::packHalf1x16(transform[3].z) << 16;
+
+		// Only read by the bindless shader, the instanced one samples the texture bound with the batch
+		if (m_Mode == SpriteRenderMode::Bindless)
+		{
+			instance->DepthTexture |= texture->BindlessIndex & 0xFFFF;
+		}
+		instance->UVRect = uvTransform;
+	}
+
+	void VulkanSpriteBatcher::ReserveQuad()
+	{
+		if (!m_Page.Data || m_PageQuadCount == m_QuadsPerPage)
+		{
+			AllocatePage();
+		}
+	}
+
+	void VulkanSpriteBatcher::AppendQuad(VulkanGraphicsPipeline* pipeline, ShaderVariantKey variant, VulkanTexture* texture)
+	{
+		// A fresh page always starts a new batch since its first quad is 0,
+		// bindless sprites carry their texture index so only the pipeline variant can break the batch
+		if (m_PageQuadCount > 0 && !m_Batches.empty() && m_Batches.back().Pipeline == pipeline &&
+			m_Batches.back().Variant == variant && (m_Mode == SpriteRenderMode::Bindless || m_Batches.back().Texture == texture))
+		{
+			m_Batches.back().QuadCount++;
+		}
+		else
+		{
+			SpriteBatch batch;
+			batch.Pipeline = pipeline;
+			batch.Variant = variant;
+			batch.Texture = texture;
+			batch.Buffer = m_Page.Buffer->GetBuffer();
+			batch.BufferOffset = m_Page.Offset;
+			batch.FirstQuad = m_PageQuadCount;
+			batch.QuadCount = 1;
+
+			m_Batches.push_back(batch);
+		}
+
+		m_PageQuadCount++;
+		m_QuadCount++;
+	}
+
+	void VulkanSpriteBatcher::AllocatePage()
+	{
+		if (UsesInstanceData())
+		{
+			m_Page = m_Arena.AllocateStorage(GetPageSize());
+		}
+		else
+		{
+			m_Page = m_Arena.AllocateVertices(GetPageSize());
+		}
+
+		m_PageQuadCount = 0;
+	}
+
+}
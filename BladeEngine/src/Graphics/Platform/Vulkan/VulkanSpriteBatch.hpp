@@ -0,0 +1,117 @@
+#pragma once
+
+#include "BladeVulkanGraphicsPipeline.hpp"
+#include "BladeVulkanTexture.hpp"
+#include "VulkanBuffer.hpp"
+#include "VulkanFrameArena.hpp"
+
+#include "../../Vertex.hpp"
+#include "../../RenderSettings.hpp"
+
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	// Per sprite data of the instanced path, matches SpriteInstance in spriteInstanced.vert (std430)
+	struct SpriteInstanceData
+	{
+		// Columns of the 2x2 affine basis, xy = x axis, zw = y axis
+		glm::vec4 Basis;
+		glm::vec2 Translation;
+		// RGBA8
+		uint32_t Tint;
+		// Half precision depth in the high 16 bits, texture index in the low 16 bits
+		uint32_t DepthTexture;
+		// Offset in xy, scale in zw
+		glm::vec4 UVRect;
+	};
+
+	static_assert(sizeof(SpriteInstanceData) == 48, "SpriteInstanceData must match the shader's std430 layout");
+
+	// Contiguous run of sprites sharing pipeline variant, texture and page, drawn with a single vkCmdDrawIndexed
+	struct SpriteBatch
+	{
+		VulkanGraphicsPipeline* Pipeline = nullptr;
+		ShaderVariantKey Variant = 0;
+		VulkanTexture* Texture = nullptr;
+
+		// Vertex page when batched, instance storage page when instanced
+		VkBuffer Buffer = VK_NULL_HANDLE;
+		VkDeviceSize BufferOffset = 0;
+
+		// Relative to the start of the batch's page
+		uint32_t FirstQuad = 0;
+		uint32_t QuadCount = 0;
+	};
+
+	class VulkanSpriteBatcher
+	{
+	public:
+		VulkanSpriteBatcher(VulkanResourceAllocator& allocator, VulkanFrameArena& arena, uint32_t quadsPerPage);
+		~VulkanSpriteBatcher();
+
+		VulkanSpriteBatcher(const VulkanSpriteBatcher&) = delete;
+		VulkanSpriteBatcher& operator=(const VulkanSpriteBatcher&) = delete;
+
+		// Starts a new frame, pages are taken from the arena so it must already be reset for this frame
+		void Begin(SpriteRenderMode mode);
+
+		// Appends the sprite to the current batch, or opens a new batch if pipeline, variant,
+		// texture (ignored in bindless mode) or page differ from the previous sprite
+		void Submit(VulkanGraphicsPipeline* pipeline, ShaderVariantKey variant, VulkanTexture* texture,
+			const glm::mat4& transform, const glm::vec4& uvTransform);
+
+		// Appends an already built instance, only valid in the modes that use instance data
+		void SubmitInstance(VulkanGraphicsPipeline* pipeline, ShaderVariantKey variant, VulkanTexture* texture,
+			const SpriteInstanceData& instance);
+
+		void BindBuffers(VkCommandBuffer commandBuffer);
+		void DrawBatch(VkCommandBuffer commandBuffer, const SpriteBatch& batch);
+
+		SpriteRenderMode GetMode() const { return m_Mode; }
+		// Instanced and bindless sprites are written to storage pages, batched ones to vertex pages
+		bool UsesInstanceData() const { return m_Mode != SpriteRenderMode::Batched; }
+
+		const std::vector<SpriteBatch>& GetBatches() const { return m_Batches; }
+		uint32_t GetQuadCount() const { return m_QuadCount; }
+
+		// Size in bytes of a page, the range bound to the instance storage buffer descriptor
+		uint64_t GetPageSize() const;
+
+	private:
+		void WriteVertices(const glm::mat4& transform, const glm::vec4& uvTransform);
+		void WriteInstance(VulkanTexture* texture, const glm::mat4& transform, const glm::vec4& uvTransform);
+
+		// Makes room for one more quad in the current page
+		void ReserveQuad();
+		// Adds the quad just written to the current batch or opens a new one
+		void AppendQuad(VulkanGraphicsPipeline* pipeline, ShaderVariantKey variant, VulkanTexture* texture);
+
+		void AllocatePage();
+
+	private:
+		VulkanResourceAllocator& m_Allocator;
+		VulkanFrameArena& m_Arena;
+
+		SpriteRenderMode m_Mode = SpriteRenderMode::Batched;
+
+		uint32_t m_QuadsPerPage;
+
+		uint32_t m_QuadCount = 0;
+		uint32_t m_PageQuadCount = 0;
+
+		VulkanArenaAllocation m_Page;
+
+		std::vector<SpriteBatch> m_Batches;
+
+		VkBuffer m_BoundVertexBuffer = VK_NULL_HANDLE;
+		VkDeviceSize m_BoundVertexOffset = 0;
+
+		// Only created once a frame uses the batched mode
+		VulkanBuffer* m_IndexBuffer = nullptr;
+	};
+
+}
@@ -0,0 +1,695 @@
+#include "VulkanUploadManager.hpp"
+
+#include "../../../Core/Base.hpp"
+
+#include "BladeVulkanGraphicsPipeline.hpp"
+#include "VulkanCheck.hpp"
+
+#include <algorithm>
+#include <string.h>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	// Stages the acquire barriers are chained to, everything a draw reads an uploaded resource from
+	// plus the blits filling mip chains
+	static const VkPipelineStageFlags s_AcquireStages =
+		VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+
+	static const uint64_t s_StagingAlignment = 16;
+
+	VulkanUploadManager::VulkanUploadManager(VulkanDevice* device, VulkanResourceAllocator& allocator, uint64_t stagingSize)
+		: m_Device(device), m_Allocator(allocator), m_StagingSize(stagingSize)
+	{
+		VkCommandPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+		poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+		poolInfo.queueFamilyIndex = m_Device->transferQueueFamily;
+
+		BLD_VK_CHECK(vkCreateCommandPool(m_Device->logicalDevice, &poolInfo, nullptr, &m_CommandPool),
+			"Failed to create upload command pool");
+
+		BufferDescription stagingDescription;
+		stagingDescription.Usage = BufferUsage::TransferSource;
+		stagingDescription.AllocationUsage = BufferAllocationUsage::HostWrite;
+		stagingDescription.KeepMapped = true;
+		stagingDescription.Size = m_StagingSize;
+
+		m_StagingBuffer = new VulkanBuffer(stagingDescription, m_Allocator);
+		m_StagingData = (uint8_t*)m_StagingBuffer->Map();
+
+		if (m_Device->dedicatedTransferQueue)
+		{
+			BLD_CORE_INFO("Uploading resources through the dedicated transfer queue family {}", m_Device->transferQueueFamily);
+		}
+	}
+
+	VulkanUploadManager::~VulkanUploadManager()
+	{
+		delete m_StagingBuffer;
+	}
+
+	void VulkanUploadManager::Dispose()
+	{
+		const VkDevice device = m_Device->logicalDevice;
+
+		Flush();
+
+		for (Submission* submission : m_InFlight)
+		{
+			vkWaitForFences(device, 1, &submission->Fence, VK_TRUE, UINT64_MAX);
+			m_FreeSubmissions.push_back(submission);
+		}
+		m_InFlight.clear();
+
+		for (Submission* submission : m_FreeSubmissions)
+		{
+			for (VulkanBuffer* buffer : submission->TemporaryBuffers)
+			{
+				delete buffer;
+			}
+
+			vkDestroyFence(device, submission->Fence, nullptr);
+			if (submission->Semaphore)
+			{
+				vkDestroySemaphore(device, submission->Semaphore, nullptr);
+			}
+
+			delete submission;
+		}
+		m_FreeSubmissions.clear();
+
+		vkDestroyCommandPool(device, m_CommandPool, nullptr);
+	}
+
+	uint64_t VulkanUploadManager::UploadImage(VkImage image, const void* data, uint64_t size, uint32_t width, uint32_t height)
+	{
+		ImageUploadLevel level = { 0, width, height };
+		return RecordImageUpload(image, data, size, &level, 1, 1, false);
+	}
+
+	uint64_t VulkanUploadManager::UploadImage(VkImage image, const void* data, uint64_t size,
+		const ImageUploadLevel* levels, uint32_t levelCount)
+	{
+		return RecordImageUpload(image, data, size, levels, levelCount, levelCount, false);
+	}
+
+	uint64_t VulkanUploadManager::UploadImageWithMipChain(VkImage image, const void* data, uint64_t size,
+		uint32_t width, uint32_t height, uint32_t mipLevels)
+	{
+		ImageUploadLevel level = { 0, width, height };
+		return RecordImageUpload(image, data, size, &level, 1, mipLevels, mipLevels > 1);
+	}
+
+	uint64_t VulkanUploadManager::RecordImageUpload(VkImage image, const void* data, uint64_t size,
+		const ImageUploadLevel* levels, uint32_t levelCount, uint32_t mipLevels, bool generateMips)
+	{
+		StagingAllocation staging = AllocateStaging(size);
+		memcpy(staging.Data, data, size);
+
+		Submission& submission = GetRecordingSubmission();
+		const bool dedicated = m_Device->dedicatedTransferQueue;
+
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = mipLevels;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+
+		vkCmdPipelineBarrier(submission.CommandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+		std::vector<VkBufferImageCopy> regions(levelCount);
+		for (uint32_t i = 0; i < levelCount; i++)
+		{
+			VkBufferImageCopy& region = regions[i];
+			region.bufferOffset = staging.Offset + levels[i].Offset;
+			region.bufferRowLength = 0;
+			region.bufferImageHeight = 0;
+			region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			region.imageSubresource.mipLevel = i;
+			region.imageSubresource.baseArrayLayer = 0;
+			region.imageSubresource.layerCount = 1;
+			region.imageOffset = { 0, 0, 0 };
+			region.imageExtent = { levels[i].Width, levels[i].Height, 1 };
+		}
+
+		vkCmdCopyBufferToImage(submission.CommandBuffer, staging.Buffer, image,
+			VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, levelCount, regions.data());
+
+		MipChain chain = { image, levels[0].Width, levels[0].Height, mipLevels };
+
+		if (generateMips && !dedicated)
+		{
+			// The upload queue is the graphics family, blit right away
+			RecordMipChain(submission.CommandBuffer, chain);
+		}
+		else if (generateMips)
+		{
+			// Hand the image over still in TRANSFER_DST_OPTIMAL, the graphics queue blits it after the acquire
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = 0;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.srcQueueFamilyIndex = m_Device->transferQueueFamily;
+			barrier.dstQueueFamilyIndex = m_Device->graphicsQueueFamily;
+
+			vkCmdPipelineBarrier(submission.CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+				0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+			submission.ImageAcquires.push_back(barrier);
+			submission.MipChains.push_back(chain);
+		}
+		else
+		{
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+			if (dedicated)
+			{
+				// Release half of the ownership transfer, the layout change happens once across both halves
+				barrier.dstAccessMask = 0;
+				barrier.srcQueueFamilyIndex = m_Device->transferQueueFamily;
+				barrier.dstQueueFamilyIndex = m_Device->graphicsQueueFamily;
+
+				vkCmdPipelineBarrier(submission.CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+					0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+				barrier.srcAccessMask = 0;
+				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+				submission.ImageAcquires.push_back(barrier);
+			}
+			else
+			{
+				barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+				vkCmdPipelineBarrier(submission.CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+					0, 0, nullptr, 0, nullptr, 1, &barrier);
+			}
+		}
+
+		m_FrameStatistics.Uploads++;
+		m_FrameStatistics.Bytes += size;
+
+		return submission.ID;
+	}
+
+	void VulkanUploadManager::RecordMipChain(VkCommandBuffer commandBuffer, const MipChain& chain)
+	{
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = chain.Image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+
+		int32_t width = (int32_t)chain.Width;
+		int32_t height = (int32_t)chain.Height;
+
+		for (uint32_t level = 1; level < chain.MipLevels; level++)
+		{
+			// The previous level becomes the blit source
+			barrier.subresourceRange.baseMipLevel = level - 1;
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+				0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			int32_t nextWidth = width > 1 ? width / 2 : 1;
+			int32_t nextHeight = height > 1 ? height / 2 : 1;
+
+			VkImageBlit blit{};
+			blit.srcOffsets[0] = { 0, 0, 0 };
+			blit.srcOffsets[1] = { width, height, 1 };
+			blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			blit.srcSubresource.mipLevel = level - 1;
+			blit.srcSubresource.baseArrayLayer = 0;
+			blit.srcSubresource.layerCount = 1;
+			blit.dstOffsets[0] = { 0, 0, 0 };
+			blit.dstOffsets[1] = { nextWidth, nextHeight, 1 };
+			blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			blit.dstSubresource.mipLevel = level;
+			blit.dstSubresource.baseArrayLayer = 0;
+			blit.dstSubresource.layerCount = 1;
+
+			vkCmdBlitImage(commandBuffer,
+				chain.Image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+				chain.Image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+				1, &blit, VK_FILTER_LINEAR);
+
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+			vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+				0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+			width = nextWidth;
+			height = nextHeight;
+		}
+
+		// The last level was only ever written
+		barrier.subresourceRange.baseMipLevel = chain.MipLevels - 1;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+		vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &barrier);
+	}
+
+	uint64_t VulkanUploadManager::UploadBuffer(VkBuffer buffer, const void* data, uint64_t size,
+		VkAccessFlags dstAccess, VkPipelineStageFlags dstStage)
+	{
+		StagingAllocation staging = AllocateStaging(size);
+		memcpy(staging.Data, data, size);
+
+		Submission& submission = GetRecordingSubmission();
+
+		VkBufferCopy copyRegion{};
+		copyRegion.srcOffset = staging.Offset;
+		copyRegion.dstOffset = 0;
+		copyRegion.size = size;
+		vkCmdCopyBuffer(submission.CommandBuffer, staging.Buffer, buffer, 1, &copyRegion);
+
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = buffer;
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+
+		if (m_Device->dedicatedTransferQueue)
+		{
+			barrier.dstAccessMask = 0;
+			barrier.srcQueueFamilyIndex = m_Device->transferQueueFamily;
+			barrier.dstQueueFamilyIndex = m_Device->graphicsQueueFamily;
+
+			vkCmdPipelineBarrier(submission.CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+				0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+			barrier.srcAccessMask = 0;
+			barrier.dstAccessMask = dstAccess;
+			submission.BufferAcquires.push_back(barrier);
+		}
+		else
+		{
+			barrier.dstAccessMask = dstAccess;
+
+			vkCmdPipelineBarrier(submission.CommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, dstStage,
+				0, 0, nullptr, 1, &barrier, 0, nullptr);
+		}
+
+		m_FrameStatistics.Uploads++;
+		m_FrameStatistics.Bytes += size;
+
+		return submission.ID;
+	}
+
+	void VulkanUploadManager::Flush()
+	{
+		if (!m_Recording)
+		{
+			return;
+		}
+
+		Submission* submission = m_Recording;
+		m_Recording = nullptr;
+
+		BLD_VK_CHECK(vkEndCommandBuffer(submission->CommandBuffer),
+			"Failed to record upload command buffer");
+
+		submission->RingEnd = m_RingHead;
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = &submission->CommandBuffer;
+
+		if (submission->Semaphore)
+		{
+			submitInfo.signalSemaphoreCount = 1;
+			submitInfo.pSignalSemaphores = &submission->Semaphore;
+		}
+
+		BLD_VK_CHECK(vkQueueSubmit(m_Device->transferQueue, 1, &submitInfo, submission->Fence),
+			"Failed to submit upload command buffer");
+
+		m_InFlight.push_back(submission);
+		m_FrameStatistics.Submissions++;
+	}
+
+	void VulkanUploadManager::Update(uint64_t frameNumber)
+	{
+		m_FrameNumber = frameNumber;
+
+		PollCompletion();
+
+		// The semaphore of a consumed submission is free again once the frame that waited on it retired
+		while (!m_InFlight.empty())
+		{
+			Submission* submission = m_InFlight.front();
+
+			const bool semaphoreFree = !submission->Semaphore ||
+				(submission->Consumed && submission->ConsumedFrame + FRAMES_IN_FLIGHT <= m_FrameNumber);
+
+			if (!submission->Complete || !semaphoreFree)
+			{
+				break;
+			}
+
+			m_InFlight.pop_front();
+			m_FreeSubmissions.push_back(submission);
+		}
+	}
+
+	void VulkanUploadManager::WaitFor(uint64_t uploadID)
+	{
+		if (IsComplete(uploadID))
+		{
+			return;
+		}
+
+		if (m_Recording && m_Recording->ID <= uploadID)
+		{
+			Flush();
+		}
+
+		for (Submission* submission : m_InFlight)
+		{
+			if (submission->ID > uploadID)
+			{
+				break;
+			}
+
+			vkWaitForFences(m_Device->logicalDevice, 1, &submission->Fence, VK_TRUE, UINT64_MAX);
+		}
+
+		PollCompletion();
+	}
+
+	void VulkanUploadManager::Forget(VkImage image)
+	{
+		auto forget = [image](std::vector<VkImageMemoryBarrier>& barriers)
+		{
+			for (size_t i = 0; i < barriers.size();)
+			{
+				if (barriers[i].image == image)
+				{
+					barriers[i] = barriers.back();
+					barriers.pop_back();
+				}
+				else
+				{
+					i++;
+				}
+			}
+		};
+
+		auto forgetMipChains = [image](std::vector<MipChain>& chains)
+		{
+			for (size_t i = 0; i < chains.size();)
+			{
+				if (chains[i].Image == image)
+				{
+					chains[i] = chains.back();
+					chains.pop_back();
+				}
+				else
+				{
+					i++;
+				}
+			}
+		};
+
+		if (m_Recording)
+		{
+			forget(m_Recording->ImageAcquires);
+			forgetMipChains(m_Recording->MipChains);
+		}
+
+		for (Submission* submission : m_InFlight)
+		{
+			if (!submission->Consumed)
+			{
+				forget(submission->ImageAcquires);
+				forgetMipChains(submission->MipChains);
+			}
+		}
+	}
+
+	void VulkanUploadManager::Forget(VkBuffer buffer)
+	{
+		auto forget = [buffer](std::vector<VkBufferMemoryBarrier>& barriers)
+		{
+			for (size_t i = 0; i < barriers.size();)
+			{
+				if (barriers[i].buffer == buffer)
+				{
+					barriers[i] = barriers.back();
+					barriers.pop_back();
+				}
+				else
+				{
+					i++;
+				}
+			}
+		};
+
+		if (m_Recording)
+		{
+			forget(m_Recording->BufferAcquires);
+		}
+
+		for (Submission* submission : m_InFlight)
+		{
+			if (!submission->Consumed)
+			{
+				forget(submission->BufferAcquires);
+			}
+		}
+	}
+
+	void VulkanUploadManager::RecordAcquireBarriers(VkCommandBuffer commandBuffer, uint64_t frameNumber,
+		std::vector<VkSemaphore>& waitSemaphores, std::vector<VkPipelineStageFlags>& waitStages)
+	{
+		std::vector<VkImageMemoryBarrier> imageBarriers;
+		std::vector<VkBufferMemoryBarrier> bufferBarriers;
+		std::vector<MipChain> mipChains;
+
+		for (Submission* submission : m_InFlight)
+		{
+			if (submission->Consumed || !submission->Semaphore)
+			{
+				continue;
+			}
+
+			imageBarriers.insert(imageBarriers.end(), submission->ImageAcquires.begin(), submission->ImageAcquires.end());
+			bufferBarriers.insert(bufferBarriers.end(), submission->BufferAcquires.begin(), submission->BufferAcquires.end());
+
+			mipChains.insert(mipChains.end(), submission->MipChains.begin(), submission->MipChains.end());
+
+			submission->ImageAcquires.clear();
+			submission->BufferAcquires.clear();
+			submission->MipChains.clear();
+
+			// Waiting on a semaphore unsignals it, so each submission is waited on by exactly one frame
+			waitSemaphores.push_back(submission->Semaphore);
+			waitStages.push_back(s_AcquireStages);
+
+			submission->Consumed = true;
+			submission->ConsumedFrame = frameNumber;
+		}
+
+		if (imageBarriers.empty() && bufferBarriers.empty())
+		{
+			return;
+		}
+
+		vkCmdPipelineBarrier(commandBuffer, s_AcquireStages, s_AcquireStages, 0, 0, nullptr,
+			(uint32_t)bufferBarriers.size(), bufferBarriers.data(),
+			(uint32_t)imageBarriers.size(), imageBarriers.data());
+
+		for (const MipChain& chain : mipChains)
+		{
+			RecordMipChain(commandBuffer, chain);
+		}
+	}
+
+	VulkanUploadManager::Submission& VulkanUploadManager::GetRecordingSubmission()
+	{
+		if (m_Recording)
+		{
+			return *m_Recording;
+		}
+
+		const VkDevice device = m_Device->logicalDevice;
+
+		Submission* submission;
+		if (!m_FreeSubmissions.empty())
+		{
+			submission = m_FreeSubmissions.back();
+			m_FreeSubmissions.pop_back();
+
+			vkResetFences(device, 1, &submission->Fence);
+			vkResetCommandBuffer(submission->CommandBuffer, 0);
+
+			for (VulkanBuffer* buffer : submission->TemporaryBuffers)
+			{
+				delete buffer;
+			}
+			submission->TemporaryBuffers.clear();
+			submission->ImageAcquires.clear();
+			submission->BufferAcquires.clear();
+			submission->MipChains.clear();
+		}
+		else
+		{
+			submission = new Submission();
+
+			VkCommandBufferAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+			allocInfo.commandPool = m_CommandPool;
+			allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+			allocInfo.commandBufferCount = 1;
+
+			BLD_VK_CHECK(vkAllocateCommandBuffers(device, &allocInfo, &submission->CommandBuffer),
+				"Failed to allocate upload command buffer");
+
+			VkFenceCreateInfo fenceInfo{};
+			fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+			BLD_VK_CHECK(vkCreateFence(device, &fenceInfo, nullptr, &submission->Fence),
+				"Failed to create upload fence");
+
+			if (m_Device->dedicatedTransferQueue)
+			{
+				VkSemaphoreCreateInfo semaphoreInfo{};
+				semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+				BLD_VK_CHECK(vkCreateSemaphore(device, &semaphoreInfo, nullptr, &submission->Semaphore),
+					"Failed to create upload semaphore");
+			}
+		}
+
+		submission->ID = m_NextID++;
+		submission->Complete = false;
+		submission->Consumed = false;
+		submission->ConsumedFrame = 0;
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+		BLD_VK_CHECK(vkBeginCommandBuffer(submission->CommandBuffer, &beginInfo),
+			"Failed to begin upload command buffer");
+
+		m_Recording = submission;
+		return *submission;
+	}
+
+	VulkanUploadManager::StagingAllocation VulkanUploadManager::AllocateStaging(uint64_t size)
+	{
+		const uint64_t alignedSize = (size + s_StagingAlignment - 1) & ~(s_StagingAlignment - 1);
+
+		if (alignedSize > m_StagingSize)
+		{
+			BufferDescription stagingDescription;
+			stagingDescription.Usage = BufferUsage::TransferSource;
+			stagingDescription.AllocationUsage = BufferAllocationUsage::HostWrite;
+			stagingDescription.KeepMapped = true;
+			stagingDescription.Size = size;
+
+			VulkanBuffer* buffer = new VulkanBuffer(stagingDescription, m_Allocator);
+			GetRecordingSubmission().TemporaryBuffers.push_back(buffer);
+
+			return { buffer->GetBuffer(), 0, buffer->Map() };
+		}
+
+		while (true)
+		{
+			// Nothing staged is in use, restarting at the start of the ring lets any allocation up to its size fit.
+			// Otherwise a large allocation could need the padding to the end of the ring on top of the whole ring
+			if (m_RingHead == m_RingTail && m_RingHead % m_StagingSize != 0)
+			{
+				m_RingHead = m_RingTail = (m_RingHead / m_StagingSize + 1) * m_StagingSize;
+			}
+
+			// Allocations never wrap, the tail of the ring is skipped instead
+			uint64_t offset = m_RingHead % m_StagingSize;
+			uint64_t padding = offset + alignedSize > m_StagingSize ? m_StagingSize - offset : 0;
+
+			if (m_RingHead + padding + alignedSize - m_RingTail <= m_StagingSize)
+			{
+				m_RingHead += padding;
+				offset = m_RingHead % m_StagingSize;
+				m_RingHead += alignedSize;
+
+				return { m_StagingBuffer->GetBuffer(), offset, m_StagingData + offset };
+			}
+
+			// Ring full, submit what is recorded and wait for the oldest submission to give its space back
+			m_FrameStatistics.StagingStalls++;
+			Flush();
+
+			bool waited = false;
+			for (Submission* submission : m_InFlight)
+			{
+				if (!submission->Complete)
+				{
+					vkWaitForFences(m_Device->logicalDevice, 1, &submission->Fence, VK_TRUE, UINT64_MAX);
+					waited = true;
+					break;
+				}
+			}
+
+			// The space is held by some submission still running, or the loop would never make progress
+			BLD_CORE_ASSERT(waited, "Staging ring is full with no upload in flight to wait for");
+
+			PollCompletion();
+		}
+	}
+
+	void VulkanUploadManager::PollCompletion()
+	{
+		for (Submission* submission : m_InFlight)
+		{
+			if (submission->Complete)
+			{
+				continue;
+			}
+
+			if (vkGetFenceStatus(m_Device->logicalDevice, submission->Fence) != VK_SUCCESS)
+			{
+				break;
+			}
+
+			submission->Complete = true;
+			m_CompletedID = submission->ID;
+			// Never behind the head, which moves past the ring's end when it restarts an empty ring
+			m_RingTail = std::max(m_RingTail, submission->RingEnd);
+		}
+	}
+
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "BladeVulkanDevice.hpp"
+#include "VulkanBuffer.hpp"
+#include "VulkanResourceAllocator.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <deque>
+#include <vector>
+
+namespace BladeEngine::Graphics::Vulkan {
+
+	struct UploadStatistics
+	{
+		uint32_t Uploads = 0;
+		uint32_t Submissions = 0;
+		uint64_t Bytes = 0;
+		// Times an upload had to wait for the GPU to free staging space
+		uint32_t StagingStalls = 0;
+	};
+
+	struct ImageUploadLevel
+	{
+		// Byte offset of the level in the uploaded data
+		uint64_t Offset;
+		uint32_t Width;
+		uint32_t Height;
+	};
+
+	// Collects texture and buffer uploads into one command buffer that is submitted once per frame on the
+	// device's transfer queue. Source data is copied into a persistently mapped staging ring whose space is
+	// reclaimed when the submission's fence signals, so recording an upload never waits on the GPU unless the
+	// ring is full. Every upload returns the id of the submission carrying it, poll it with IsComplete.
+	//
+	// With a dedicated transfer queue resources are released to the graphics family at the end of the upload
+	// and acquired again by the next frame's command buffer (RecordAcquireBarriers), whose submission waits on
+	// the upload's semaphore. That makes a resource safe to draw in the same frame it was uploaded.
+	class VulkanUploadManager
+	{
+	public:
+		VulkanUploadManager(VulkanDevice* device, VulkanResourceAllocator& allocator, uint64_t stagingSize);
+		~VulkanUploadManager();
+
+		VulkanUploadManager(const VulkanUploadManager&) = delete;
+		VulkanUploadManager& operator=(const VulkanUploadManager&) = delete;
+
+		// Waits for every submission and destroys the Vulkan objects
+		void Dispose();
+
+		// Copies the pixels into staging and records the copy to mip 0, leaving the image in SHADER_READ_ONLY_OPTIMAL
+		uint64_t UploadImage(VkImage image, const void* data, uint64_t size, uint32_t width, uint32_t height);
+		// Same for a mip chain built on the CPU, data holds every level back to back
+		uint64_t UploadImage(VkImage image, const void* data, uint64_t size,
+			const ImageUploadLevel* levels, uint32_t levelCount);
+		// Copies mip 0 and fills the other levels with a chain of linear blits, the image format has to support them.
+		// Blits need a graphics queue, with a dedicated transfer queue they are recorded by RecordAcquireBarriers
+		uint64_t UploadImageWithMipChain(VkImage image, const void* data, uint64_t size,
+			uint32_t width, uint32_t height, uint32_t mipLevels);
+		// dstAccess and dstStage describe how the graphics queue reads the buffer afterwards
+		uint64_t UploadBuffer(VkBuffer buffer, const void* data, uint64_t size,
+			VkAccessFlags dstAccess, VkPipelineStageFlags dstStage);
+
+		// Submits the uploads recorded since the last flush
+		void Flush();
+
+		// Marks finished submissions complete and recycles the ones no frame in flight depends on,
+		// the fence of the frame FRAMES_IN_FLIGHT frames before frameNumber must have been waited on
+		void Update(uint64_t frameNumber);
+
+		bool IsComplete(uint64_t uploadID) const { return uploadID <= m_CompletedID; }
+		// Flushes if needed and blocks until the upload is complete
+		void WaitFor(uint64_t uploadID);
+
+		// Drops the acquire barriers still pending for a resource that is about to be destroyed
+		void Forget(VkImage image);
+		void Forget(VkBuffer buffer);
+
+		// Records the ownership acquire of everything flushed so far into a graphics command buffer, outside
+		// any render pass, and appends the semaphores its submission has to wait on
+		void RecordAcquireBarriers(VkCommandBuffer commandBuffer, uint64_t frameNumber,
+			std::vector<VkSemaphore>& waitSemaphores, std::vector<VkPipelineStageFlags>& waitStages);
+
+		// Counters since the previous ResetFrameStatistics
+		const UploadStatistics& GetFrameStatistics() const { return m_FrameStatistics; }
+		void ResetFrameStatistics() { m_FrameStatistics = UploadStatistics(); }
+
+	private:
+		struct MipChain
+		{
+			VkImage Image;
+			uint32_t Width;
+			uint32_t Height;
+			uint32_t MipLevels;
+		};
+
+		struct Submission
+		{
+			uint64_t ID = 0;
+
+			VkCommandBuffer CommandBuffer = VK_NULL_HANDLE;
+			VkFence Fence = VK_NULL_HANDLE;
+			// Only signaled with a dedicated transfer queue
+			VkSemaphore Semaphore = VK_NULL_HANDLE;
+
+			// Staging ring position once this submission's data is no longer needed
+			uint64_t RingEnd = 0;
+			// Uploads larger than the whole ring get their own staging buffer
+			std::vector<VulkanBuffer*> TemporaryBuffers;
+
+			std::vector<VkImageMemoryBarrier> ImageAcquires;
+			std::vector<VkBufferMemoryBarrier> BufferAcquires;
+			// Blitted by the graphics queue right after the acquire
+			std::vector<MipChain> MipChains;
+
+			bool Complete = false;
+			bool Consumed = false;
+			uint64_t ConsumedFrame = 0;
+		};
+
+		struct StagingAllocation
+		{
+			VkBuffer Buffer;
+			uint64_t Offset;
+			void* Data;
+		};
+
+		Submission& GetRecordingSubmission();
+
+		uint64_t RecordImageUpload(VkImage image, const void* data, uint64_t size,
+			const ImageUploadLevel* levels, uint32_t levelCount, uint32_t mipLevels, bool generateMips);
+
+		// Every level has to be in TRANSFER_DST_OPTIMAL, leaves them all in SHADER_READ_ONLY_OPTIMAL
+		static void RecordMipChain(VkCommandBuffer commandBuffer, const MipChain& chain);
+
+		StagingAllocation AllocateStaging(uint64_t size);
+
+		// Marks every submission whose fence signaled as complete, in submission order
+		void PollCompletion();
+
+	private:
+		VulkanDevice* m_Device;
+		VulkanResourceAllocator& m_Allocator;
+
+		VkCommandPool m_CommandPool = VK_NULL_HANDLE;
+
+		VulkanBuffer* m_StagingBuffer;
+		uint8_t* m_StagingData;
+		uint64_t m_StagingSize;
+
+		// Monotonic byte positions, the ring offset is position % m_StagingSize
+		uint64_t m_RingHead = 0;
+		uint64_t m_RingTail = 0;
+
+		Submission* m_Recording = nullptr;
+		std::deque<Submission*> m_InFlight;
+		std::vector<Submission*> m_FreeSubmissions;
+
+		uint64_t m_NextID = 1;
+		uint64_t m_CompletedID = 0;
+		uint64_t m_FrameNumber = 0;
+
+		UploadStatistics m_FrameStatistics;
+	};
+
+}
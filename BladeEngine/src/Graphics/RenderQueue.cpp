@@ -0,0 +1,122 @@
+#include "RenderQueue.hpp"
+
+#include <cstring>
+#include <utility>
+
+namespace BladeEngine::Graphics {
+
+	static const uint64_t LayerShift = 56;
+	static const uint64_t TranslucentShift = 55;
+	static const uint64_t DepthShift = 32;
+	static const uint64_t PipelineShift = 24;
+
+	static const uint32_t DepthBits = 23;
+	static const uint32_t TextureMask = 0xFFFFFF;
+
+	// Maps the float to an unsigned integer with the same ordering, negative values included
+	static uint32_t OrderedFloatBits(float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		return bits & 0x80000000 ? ~bits : bits | 0x80000000;
+	}
+
+	uint64_t RenderQueue::MakeSortKey(uint8_t layer, bool translucent, float depth, uint8_t pipeline, uint32_t texture)
+	{
+		uint64_t key = (uint64_t)layer << LayerShift;
+
+		// The camera looks down -Z, so ascending Z draws the farthest sprites first
+		if (translucent)
+		{
+			key |= 1ull << TranslucentShift;
+			key |= (uint64_t)(OrderedFloatBits(depth) >> (32 - DepthBits)) << DepthShift;
+		}
+
+		key |= (uint64_t)pipeline << PipelineShift;
+		key |= texture & TextureMask;
+
+		return key;
+	}
+
+	void RenderQueue::Clear()
+	{
+		m_Commands.clear();
+	}
+
+	void RenderQueue::Reserve(size_t count)
+	{
+		m_Commands.reserve(count);
+		m_Scratch.reserve(count);
+	}
+
+	void RenderQueue::Submit(uint64_t sortKey, uint32_t payload)
+	{
+		m_Commands.push_back({ sortKey, payload });
+	}
+
+	void RenderQueue::Sort()
+	{
+		m_LastSortPassCount = 0;
+
+		const size_t count = m_Commands.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		// All eight histograms are built in a single read of the keys
+		uint32_t histograms[8][256];
+		memset(histograms, 0, sizeof(histograms));
+
+		for (const auto& command : m_Commands)
+		{
+			uint64_t key = command.SortKey;
+			for (uint32_t byte = 0; byte < 8; byte++)
+			{
+				histograms[byte][(key >> (byte * 8)) & 0xFF]++;
+			}
+		}
+
+		m_Scratch.resize(count);
+
+		RenderCommand* source = m_Commands.data();
+		RenderCommand* destination = m_Scratch.data();
+
+		for (uint32_t byte = 0; byte < 8; byte++)
+		{
+			uint32_t* histogram = histograms[byte];
+
+			// A byte every key shares would only copy the array
+			uint32_t firstKeyBucket = (source[0].SortKey >> (byte * 8)) & 0xFF;
+			if (histogram[firstKeyBucket] == count)
+			{
+				continue;
+			}
+
+			uint32_t offset = 0;
+			for (uint32_t bucket = 0; bucket < 256; bucket++)
+			{
+				uint32_t bucketCount = histogram[bucket];
+				histogram[bucket] = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+			{
+				uint32_t bucket = (source[i].SortKey >> (byte * 8)) & 0xFF;
+				destination[histogram[bucket]++] = source[i];
+			}
+
+			std::swap(source, destination);
+			m_LastSortPassCount++;
+		}
+
+		// An odd number of passes leaves the result in the scratch buffer
+		if (source != m_Commands.data())
+		{
+			m_Commands.swap(m_Scratch);
+		}
+	}
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace BladeEngine::Graphics {
+
+	// Draw submitted to a RenderQueue, Payload is an index into the submitter's own draw data
+	struct RenderCommand
+	{
+		uint64_t SortKey;
+		uint32_t Payload;
+	};
+
+	// Collects draws for a frame and orders them by their 64 bit sort key.
+	// Key layout, most significant bits first:
+	//   layer (8) | translucent (1) | depth (23) | pipeline (8) | texture (24)
+	// Opaque draws leave depth at 0 so they group by pipeline and texture,
+	// translucent draws are ordered back to front before pipeline and texture
+	class RenderQueue
+	{
+	public:
+		static uint64_t MakeSortKey(uint8_t layer, bool translucent, float depth, uint8_t pipeline, uint32_t texture);
+
+		void Clear();
+		void Reserve(size_t count);
+
+		void Submit(uint64_t sortKey, uint32_t payload);
+
+		// Stable LSD radix sort over the key bytes, bytes shared by every key are skipped
+		void Sort();
+
+		const std::vector<RenderCommand>& GetCommands() const { return m_Commands; }
+		size_t GetSize() const { return m_Commands.size(); }
+
+		// Radix passes run by the last Sort, 0 when every key was equal or the queue was empty
+		uint32_t GetLastSortPassCount() const { return m_LastSortPassCount; }
+
+	private:
+		std::vector<RenderCommand> m_Commands;
+		std::vector<RenderCommand> m_Scratch;
+
+		uint32_t m_LastSortPassCount = 0;
+	};
+
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+namespace BladeEngine::Graphics {
+
+	enum class SpriteRenderMode
+	{
+		// Quads are transformed on the CPU and streamed as vertices
+		Batched,
+		// Unit quad drawn once per batch, per sprite data read from a storage buffer
+		Instanced,
+		// Instanced, with the texture picked per sprite from the bindless texture table,
+		// falls back to Instanced when the device lacks descriptor indexing
+		Bindless
+	};
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BladeEngine::Graphics {
+
+	// Counters gathered by the renderer while recording a frame, published when the frame is submitted
+	struct RenderStatistics
+	{
+		uint32_t DrawCalls = 0;
+		uint32_t PipelineBinds = 0;
+		// Shader variants compiled on first use while recording, a stall unless the pipeline cache had them
+		uint32_t PipelineVariantsCompiled = 0;
+
+		uint32_t SpriteBatches = 0;
+		uint32_t Sprites = 0;
+
+		uint32_t Strings = 0;
+		// Glyph instances written to the frame's shared text stream
+		uint32_t Glyphs = 0;
+
+		// Strings whose glyph layout was reused or rebuilt, hit rate is hits / (hits + misses)
+		uint32_t TextLayoutCacheHits = 0;
+		uint32_t TextLayoutCacheMisses = 0;
+		float TextLayoutMilliseconds = 0.0f;
+
+		// Renderables tested against the camera before submission and how many of them were rejected
+		uint32_t CullingCandidates = 0;
+		uint32_t Culled = 0;
+
+		// Descriptor set lookups served from the pipelines' caches and the ones that had to be created
+		uint32_t DescriptorCacheHits = 0;
+		uint32_t DescriptorCacheMisses = 0;
+		uint32_t DescriptorSetAllocations = 0;
+		uint32_t DescriptorWrites = 0;
+
+		// Textures and buffers queued on the upload manager, the transfer submissions carrying them and their size
+		uint32_t Uploads = 0;
+		uint32_t UploadSubmissions = 0;
+		uint64_t UploadedBytes = 0;
+
+		// Bytes sub-allocated from the frame arena for uniforms, vertices and indices
+		uint64_t TransientMemoryUsed = 0;
+	};
+
+}
@@ -1,11 +1,13 @@
 #include "Shader.hpp"
 #include "../Core/Utils.hpp"
+#include "../Core/Profiler.hpp"
 
 #include <vulkan/vulkan.h>
 
 using namespace BladeEngine::Graphics;
 
 Shader::Shader(std::string path, ShaderType shaderType) {
+  BLD_PROFILE_SCOPE("Load Shader");
   data = Utils::ReadFile_vec(path + ".spv");
   type = shaderType;
 }
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BladeEngine::Graphics {
+
+	// Features a pipeline variant is built with. Bit i reaches the shaders as the boolean specialization
+	// constant with constant_id = i, so every variant is compiled without the branches of the others
+	enum ShaderFeature : uint32_t
+	{
+		// Discards texels under half alpha and writes the rest without blending
+		ShaderFeatureAlphaTest = 1 << 0,
+		// Multiplies the texture by the vertex or instance color
+		ShaderFeatureTint = 1 << 1,
+		// Text only, surrounds the glyphs with a dark outline taken from the distance field
+		ShaderFeatureOutline = 1 << 2
+	};
+
+	static const uint32_t ShaderFeatureCount = 3;
+
+	// Combination of ShaderFeature bits, 0 is the blended, untinted variant
+	typedef uint32_t ShaderVariantKey;
+
+}
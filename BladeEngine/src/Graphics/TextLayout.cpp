@@ -0,0 +1,96 @@
+#include "TextLayout.hpp"
+
+#include "MSDFData.hpp"
+
+namespace BladeEngine::Graphics {
+
+	void LayoutText(const Font* font, const std::string& string, const TextLayoutParams& params, std::vector<GlyphQuad>& glyphs)
+	{
+		const auto& fontGeometry = font->GetMSDFData()->FontGeometry;
+		const auto& metrics = fontGeometry.getMetrics();
+		Texture2D* fontAtlas = font->GetAtlasTexture();
+
+		const float texelWidth = 1.0f / (float)fontAtlas->GetWidth();
+		const float texelHeight = 1.0f / (float)fontAtlas->GetHeight();
+		const float atlasHeight = (float)fontAtlas->GetHeight();
+
+		double x = 0.0;
+		double fsScale = 1.0 / (metrics.ascenderY - metrics.descenderY);
+		double y = 0.0;
+
+		const float spaceGlyphAdvance = fontGeometry.getGlyph(' ')->getAdvance();
+
+		for (size_t i = 0; i < string.size(); i++)
+		{
+			char character = string[i];
+			if (character == '\r')
+				continue;
+
+			if (character == '\n')
+			{
+				x = 0;
+				y -= fsScale * metrics.lineHeight + params.LineSpacing;
+				continue;
+			}
+
+			if (character == ' ')
+			{
+				float advance = spaceGlyphAdvance;
+				if (i < string.size() - 1)
+				{
+					char nextCharacter = string[i + 1];
+					double dAdvance;
+					fontGeometry.getAdvance(dAdvance, character, nextCharacter);
+					advance = (float)dAdvance;
+				}
+
+				x += fsScale * advance + params.Kerning;
+				continue;
+			}
+
+			if (character == '\t')
+			{
+				x += 4.0f * (fsScale * spaceGlyphAdvance + params.Kerning);
+				continue;
+			}
+
+			auto glyph = fontGeometry.getGlyph(character);
+			if (!glyph)
+				glyph = fontGeometry.getGlyph('?');
+			if (!glyph)
+				return;
+
+			double al, ab, ar, at;
+			glyph->getQuadAtlasBounds(al, ab, ar, at);
+			glm::vec2 texCoordMin((float)al, atlasHeight - (float)at);
+			glm::vec2 texCoordMax((float)ar, atlasHeight - (float)ab);
+
+			// switched bottom and top bounds
+			double pl, pb, pr, pt;
+			glyph->getQuadPlaneBounds(pl, pt, pr, pb);
+			glm::vec2 quadMin((float)pl, (float)pb);
+			glm::vec2 quadMax((float)pr, (float)pt);
+
+			quadMin *= fsScale, quadMax *= fsScale;
+			quadMin += glm::vec2(x, y);
+			quadMax += glm::vec2(x, y);
+
+			GlyphQuad quad;
+			quad.PlaneMin = quadMin;
+			quad.PlaneMax = quadMax;
+			quad.UVMin = texCoordMin * glm::vec2(texelWidth, texelHeight);
+			quad.UVMax = texCoordMax * glm::vec2(texelWidth, texelHeight);
+			glyphs.push_back(quad);
+
+			if (i < string.size() - 1)
+			{
+				double advance = glyph->getAdvance();
+				char nextCharacter = string[i + 1];
+				fontGeometry.getAdvance(advance, character, nextCharacter);
+
+				x += fsScale * advance + params.Kerning;
+			}
+		}
+	}
+
+}
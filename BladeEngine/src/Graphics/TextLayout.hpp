@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Font.hpp"
+
+#include <glm/glm.hpp>
+
+#include <string>
+#include <vector>
+
+namespace BladeEngine::Graphics {
+
+	struct TextLayoutParams
+	{
+		glm::vec4 Color{ 1.0f, 0.5f, 1.0f, 1.0f };
+		float Kerning = 0.0f;
+		float LineSpacing = 0.0f;
+
+		bool operator==(const TextLayoutParams& other) const
+		{
+			return Color == other.Color && Kerning == other.Kerning && LineSpacing == other.LineSpacing;
+		}
+	};
+
+	// Glyph rectangle in text space and its region of the font atlas in normalized coordinates
+	struct GlyphQuad
+	{
+		glm::vec2 PlaneMin;
+		glm::vec2 PlaneMax;
+		glm::vec2 UVMin;
+		glm::vec2 UVMax;
+	};
+
+	// Lays the string out from the origin along +X, lines going down by the font's line height.
+	// Glyph quads are appended to glyphs, whitespace produces none
+	void LayoutText(const Font* font, const std::string& string, const TextLayoutParams& params, std::vector<GlyphQuad>& glyphs);
+
+}
@@ -0,0 +1,132 @@
+#include "TextLayoutCache.hpp"
+
+#include "../Core/Base.hpp"
+#include "../Utils/Timer.hpp"
+
+#include <glm/gtc/packing.hpp>
+
+#include <cstring>
+#include <functional>
+
+namespace BladeEngine::Graphics {
+
+	// Bit patterns of two floats in one word, so each parameter is hashed on its own whatever the struct layout
+	static uint64_t PackFloatBits(float high, float low)
+	{
+		uint32_t highBits, lowBits;
+		memcpy(&highBits, &high, sizeof(highBits));
+		memcpy(&lowBits, &low, sizeof(lowBits));
+
+		return (uint64_t)highBits << 32 | lowBits;
+	}
+
+	TextLayoutCache::TextLayoutCache(uint32_t capacity, uint32_t maxGlyphsPerString)
+		: m_Capacity(capacity), m_MaxGlyphsPerString(maxGlyphsPerString)
+	{
+	}
+
+	void TextLayoutCache::BeginFrame(uint64_t frameNumber)
+	{
+		m_FrameNumber = frameNumber;
+		m_FrameStatistics = TextLayoutCacheStatistics();
+
+		EvictUnused();
+	}
+
+	const CachedTextLayout* TextLayoutCache::Get(const std::string& string, Font* font, const TextLayoutParams& params)
+	{
+		uint64_t key = MakeKey(string, font, params);
+
+		auto it = m_EntryMap.find(key);
+		if (it != m_EntryMap.end())
+		{
+			Entry& entry = *it->second;
+			m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+			entry.LastUsedFrame = m_FrameNumber;
+
+			if (entry.TextFont == font && entry.Text == string && entry.Params == params)
+			{
+				m_FrameStatistics.Hits++;
+				return entry.Layout.Glyphs.size() > 0 ? &entry.Layout : nullptr;
+			}
+
+			// Hash collision, the entry is taken over by the new string
+			entry.TextFont = font;
+			entry.Text = string;
+			entry.Params = params;
+
+			BuildLayout(entry);
+			return entry.Layout.Glyphs.size() > 0 ? &entry.Layout : nullptr;
+		}
+
+		Entry entry;
+		entry.Key = key;
+		entry.TextFont = font;
+		entry.Text = string;
+		entry.Params = params;
+		entry.LastUsedFrame = m_FrameNumber;
+
+		m_Entries.push_front(std::move(entry));
+		m_EntryMap[key] = m_Entries.begin();
+
+		BuildLayout(m_Entries.front());
+
+		const CachedTextLayout& layout = m_Entries.front().Layout;
+
+		EvictUnused();
+
+		return layout.Glyphs.size() > 0 ? &layout : nullptr;
+	}
+
+	uint64_t TextLayoutCache::MakeKey(const std::string& string, Font* font, const TextLayoutParams& params)
+	{
+		const uint64_t paramBits[3] = {
+			PackFloatBits(params.Color.r, params.Color.g),
+			PackFloatBits(params.Color.b, params.Color.a),
+			PackFloatBits(params.Kerning, params.LineSpacing)
+		};
+
+		uint64_t key = std::hash<std::string>()(string);
+		for (uint64_t value : { (uint64_t)(uintptr_t)font, paramBits[0], paramBits[1], paramBits[2] })
+		{
+			key ^= value + 0x9E3779B97F4A7C15ull + (key << 6) + (key >> 2);
+		}
+
+		return key;
+	}
+
+	void TextLayoutCache::BuildLayout(Entry& entry)
+	{
+		Utils::Timer timer;
+
+		entry.Layout.Glyphs.clear();
+		LayoutText(entry.TextFont, entry.Text, entry.Params, entry.Layout.Glyphs);
+
+		if (entry.Layout.Glyphs.size() > m_MaxGlyphsPerString)
+		{
+			BLD_CORE_WARN("String of {} glyphs truncated to {}", entry.Layout.Glyphs.size(), m_MaxGlyphsPerString);
+			entry.Layout.Glyphs.resize(m_MaxGlyphsPerString);
+		}
+
+		entry.Layout.Glyphs.shrink_to_fit();
+		entry.Layout.Tint = glm::packUnorm4x8(entry.Params.Color);
+
+		m_FrameStatistics.Misses++;
+		m_FrameStatistics.LayoutMilliseconds += timer.ElapsedMilliseconds();
+	}
+
+	void TextLayoutCache::EvictUnused()
+	{
+		// Layouts handed out this frame are still referenced by the renderer's text draws
+		while (m_Entries.size() > m_Capacity && m_Entries.back().LastUsedFrame < m_FrameNumber)
+		{
+			Entry& entry = m_Entries.back();
+
+			m_EntryMap.erase(entry.Key);
+			m_Entries.pop_back();
+
+			m_FrameStatistics.Evictions++;
+		}
+	}
+
+}
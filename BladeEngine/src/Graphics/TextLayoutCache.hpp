@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Font.hpp"
+#include "TextLayout.hpp"
+
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BladeEngine::Graphics {
+
+	// Glyph quads of a laid out string in text space, expanded into the frame's glyph instances every time it is drawn
+	struct CachedTextLayout
+	{
+		std::vector<GlyphQuad> Glyphs;
+		// Params color as RGBA8
+		uint32_t Tint = 0xFFFFFFFF;
+	};
+
+	struct TextLayoutCacheStatistics
+	{
+		uint32_t Hits = 0;
+		uint32_t Misses = 0;
+		uint32_t Evictions = 0;
+		float LayoutMilliseconds = 0.0f;
+	};
+
+	// LRU cache of text layouts keyed by (font, string, params), a string is only laid out again
+	// once its content changes or its entry got evicted
+	class TextLayoutCache
+	{
+	public:
+		TextLayoutCache(uint32_t capacity, uint32_t maxGlyphsPerString);
+
+		TextLayoutCache(const TextLayoutCache&) = delete;
+		TextLayoutCache& operator=(const TextLayoutCache&) = delete;
+
+		// Resets the frame statistics, layouts returned during the previous frame may be evicted from here on
+		void BeginFrame(uint64_t frameNumber);
+
+		// Returns the cached layout, laying the string out on a miss. Null when it has no visible glyph.
+		// The layout stays valid until the next BeginFrame
+		const CachedTextLayout* Get(const std::string& string, Font* font, const TextLayoutParams& params);
+
+		const TextLayoutCacheStatistics& GetFrameStatistics() const { return m_FrameStatistics; }
+		size_t GetEntryCount() const { return m_Entries.size(); }
+
+	private:
+		struct Entry
+		{
+			uint64_t Key;
+
+			Font* TextFont;
+			std::string Text;
+			TextLayoutParams Params;
+
+			CachedTextLayout Layout;
+			uint64_t LastUsedFrame;
+		};
+
+		static uint64_t MakeKey(const std::string& string, Font* font, const TextLayoutParams& params);
+
+		void BuildLayout(Entry& entry);
+		void EvictUnused();
+
+	private:
+		uint32_t m_Capacity;
+		uint32_t m_MaxGlyphsPerString;
+
+		uint64_t m_FrameNumber = 0;
+
+		// Most recently used at the front
+		std::list<Entry> m_Entries;
+		std::unordered_map<uint64_t, std::list<Entry>::iterator> m_EntryMap;
+
+		TextLayoutCacheStatistics m_FrameStatistics;
+	};
+
+}
@@ -1,8 +1,16 @@
 #include "Texture2D.hpp"
 
 #include "../Core/Base.hpp"
+#include "../Core/MappedFile.hpp"
+#include "../Core/Profiler.hpp"
 
 #include "GraphicsManager.hpp"
+#include "TextureContainer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
@@ -16,24 +24,19 @@ namespace BladeEngine::Graphics {
 	}
 
 	Texture2D::Texture2D(const char* path)
+		: m_Width(0), m_Height(0), m_Format(TextureFormat::RGBA8)
 	{
-		int width, height, texChannels;
-
-		m_Pixels = stbi_load(path, &width, &height, &texChannels, STBI_rgb_alpha);
+		ImageFile image;
+		bool loaded = ReadImageFile(path, image);
 
-		m_Width = width;
-		m_Height = height;
-		m_Format = TextureFormat::RGBA8;
+		BLD_CORE_ASSERT(loaded, "Failed to load texture at {}", path);
 
-		BLD_CORE_ASSERT(m_Pixels, "Failed to load texture at {}", path);
+		SetImage(image);
 	}
 
 	Texture2D::~Texture2D()
 	{
-		if (m_Pixels)
-		{
-			stbi_image_free(m_Pixels);
-		}
+		ReleasePixels();
 
 		if (m_GPUTextureHandle)
 		{
@@ -57,6 +60,12 @@ namespace BladeEngine::Graphics {
 			return 4;
 		case TextureFormat::RGBA32F:
 			return 16;
+		case TextureFormat::BC1:
+		case TextureFormat::BC3:
+		case TextureFormat::BC7:
+		case TextureFormat::ETC2_RGB8:
+		case TextureFormat::ETC2_RGBA8:
+			return 0;
 		}
 
 		BLD_CORE_ASSERT(false, "Unknown Texture Format");
@@ -64,6 +73,30 @@ namespace BladeEngine::Graphics {
 		return 0;
 	}
 
+	bool Texture2D::IsCompressed() const
+	{
+		return IsCompressedFormat(m_Format);
+	}
+
+	uint32_t Texture2D::GetLevelSize(uint32_t level) const
+	{
+		uint32_t width = std::max(m_Width >> level, 1u);
+		uint32_t height = std::max(m_Height >> level, 1u);
+
+		return (uint32_t)GetTextureLevelSize(m_Format, width, height);
+	}
+
+	uint32_t Texture2D::GetSize() const
+	{
+		uint32_t size = 0;
+		for (uint32_t level = 0; level < m_MipLevels; level++)
+		{
+			size += GetLevelSize(level);
+		}
+
+		return size;
+	}
+
 	void Texture2D::SetSamplerConfiguration(SamplerConfiguration samplerConfig)
 	{
 		m_SamplerConfig = samplerConfig;
@@ -77,6 +110,173 @@ namespace BladeEngine::Graphics {
 		BLD_CORE_ASSERT(size = m_Width * m_Height * bpp, "Provided data size does not match Texture2D size");
 
 		m_Pixels = (uint8_t*)pixels;
+
+		UpdateTranslucency();
+	}
+
+	void Texture2D::UpdateTranslucency()
+	{
+		// Only RGBA8 is scanned, other formats are assumed translucent
+		m_HasTranslucency = true;
+		if (m_Format != TextureFormat::RGBA8 || !m_Pixels)
+		{
+			return;
+		}
+
+		m_HasTranslucency = HasTranslucentPixels(m_Pixels, m_Width * m_Height);
+	}
+
+	bool Texture2D::HasTranslucentPixels(const uint8_t* pixels, uint32_t pixelCount)
+	{
+		for (uint32_t i = 0; i < pixelCount; i++)
+		{
+			uint8_t alpha = pixels[i * 4 + 3];
+			if (alpha != 0 && alpha != 255)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	bool Texture2D::ReadImageFile(const char* path, ImageFile& image)
+	{
+		BLD_PROFILE_FUNCTION();
+
+		std::filesystem::path sourcePath(path);
+		if (sourcePath.extension() == ".btex")
+		{
+			return ReadBTexFile(path, image);
+		}
+
+		// Prefer the cooked file, unless the image was edited after it was written
+		std::filesystem::path cookedPath = sourcePath;
+		cookedPath.replace_extension(".btex");
+
+		std::error_code error;
+		auto cookedTime = std::filesystem::last_write_time(cookedPath, error);
+		if (!error)
+		{
+			auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+			if ((error || cookedTime >= sourceTime) && ReadBTexFile(cookedPath.string().c_str(), image))
+			{
+				return true;
+			}
+		}
+
+		int width, height, channels;
+		image.Pixels = stbi_load(path, &width, &height, &channels, STBI_rgb_alpha);
+		if (!image.Pixels)
+		{
+			return false;
+		}
+
+		image.Width = (uint32_t)width;
+		image.Height = (uint32_t)height;
+		image.Format = TextureFormat::RGBA8;
+		image.MipLevels = 1;
+		image.HasTranslucency = HasTranslucentPixels(image.Pixels, image.Width * image.Height);
+
+		return true;
+	}
+
+	bool Texture2D::ReadBTexFile(const char* path, ImageFile& image)
+	{
+		MappedFile* file = new MappedFile(path);
+		if (!file->IsValid() || file->GetSize() < sizeof(BTexHeader))
+		{
+			delete file;
+			return false;
+		}
+
+		BTexHeader header;
+		memcpy(&header, file->GetData(), sizeof(header));
+
+		if (header.Magic != BTexMagic || header.Version != BTexVersion ||
+			header.Format == (uint32_t)TextureFormat::None || header.Format > (uint32_t)TextureFormat::ETC2_RGBA8 ||
+			header.Width == 0 || header.Height == 0 || header.MipLevels == 0 || header.MipLevels > 32)
+		{
+			delete file;
+			return false;
+		}
+
+		TextureFormat format = (TextureFormat)header.Format;
+
+		uint64_t size = 0;
+		for (uint32_t level = 0; level < header.MipLevels; level++)
+		{
+			size += GetTextureLevelSize(format,
+				std::max(header.Width >> level, 1u), std::max(header.Height >> level, 1u));
+		}
+
+		if (file->GetSize() < sizeof(BTexHeader) + size)
+		{
+			delete file;
+			return false;
+		}
+
+		// Loads run on worker threads, fault the pixels in here instead of in the upload on the main thread
+		file->Prefetch(sizeof(BTexHeader), size);
+
+		image.Pixels = file->GetData() + sizeof(BTexHeader);
+		image.Mapping = file;
+		image.Width = header.Width;
+		image.Height = header.Height;
+		image.Format = format;
+		image.MipLevels = header.MipLevels;
+		image.HasTranslucency = (header.Flags & BTexFlagTranslucent) != 0;
+
+		return true;
+	}
+
+	void Texture2D::ReleaseImageFile(ImageFile& image)
+	{
+		if (image.Mapping)
+		{
+			delete image.Mapping;
+		}
+		else if (image.Pixels)
+		{
+			stbi_image_free(image.Pixels);
+		}
+
+		image.Pixels = nullptr;
+		image.Mapping = nullptr;
+	}
+
+	uint8_t* Texture2D::AllocatePixels(uint64_t size)
+	{
+		// Same allocator as stb_image so every kind of pixels is freed the same way
+		return (uint8_t*)STBI_MALLOC(size);
+	}
+
+	void Texture2D::SetImage(const ImageFile& image)
+	{
+		ReleasePixels();
+
+		m_Pixels = image.Pixels;
+		m_MappedFile = image.Mapping;
+		m_Width = image.Width;
+		m_Height = image.Height;
+		m_Format = image.Format;
+		m_MipLevels = image.MipLevels;
+		m_HasTranslucency = image.HasTranslucency;
+	}
+
+	void Texture2D::ReleasePixels()
+	{
+		if (m_MappedFile)
+		{
+			delete m_MappedFile;
+		}
+		else if (m_Pixels)
+		{
+			stbi_image_free(m_Pixels);
+		}
+
+		m_Pixels = nullptr;
+		m_MappedFile = nullptr;
 	}
 
 	void Texture2D::CreateGPUTexture()
@@ -84,6 +284,11 @@ namespace BladeEngine::Graphics {
 		m_GPUTextureHandle = GraphicsManager::Instance()->UploadTextureToGPU(this);
 	}
 
+	bool Texture2D::IsGPUTextureReady() const
+	{
+		return m_GPUTextureHandle && GraphicsManager::Instance()->IsGPUTextureReady(m_GPUTextureHandle);
+	}
+
 	void Texture2D::DestroyGPUTexture()
 	{
 		GraphicsManager::Instance()->ReleaseGPUTexture(m_GPUTextureHandle);
@@ -2,6 +2,10 @@
 
 #include <cstdint>
 
+namespace BladeEngine {
+	class MappedFile;
+}
+
 namespace BladeEngine::Graphics {
 
 	enum class TextureFormat
@@ -12,7 +16,14 @@ namespace BladeEngine::Graphics {
 		RG8,
 		RGB8,
 		RGBA8,
-		RGBA32F
+		RGBA32F,
+
+		// 4x4 block compressed, only loaded from .btex files
+		BC1,
+		BC3,
+		BC7,
+		ETC2_RGB8,
+		ETC2_RGBA8
 	};
 
 	enum class SamplerFilter
@@ -40,10 +51,14 @@ namespace BladeEngine::Graphics {
 		{
 			SamplerFilter Filter = SamplerFilter::Nearest;
 			SamplerAddressMode AdressMode = SamplerAddressMode::Repeat;
+			// Builds the full mip chain on upload and samples it trilinearly, for textures that get minified
+			bool GenerateMipmaps = false;
 		};
 
 	public:
 		Texture2D(uint32_t width, uint32_t height, TextureFormat format = TextureFormat::RGBA8);
+		// Decodes an image with stb_image, or maps a .btex file and uses its pixels as is. A .btex file next
+		// to the image with the same name is used instead when it is not older than the image
 		Texture2D(const char* path);
 		~Texture2D();
 
@@ -51,36 +66,85 @@ namespace BladeEngine::Graphics {
 		uint32_t GetHeight() const { return m_Height; }
 
 		TextureFormat GetFormat() const { return m_Format; }
+		// 0 for block compressed formats
 		uint32_t GetBPP() const;
+		bool IsCompressed() const;
 
-		uint32_t GetSize() const { return m_Width * m_Height * GetBPP(); }
+		// Levels stored in the pixel data, only files with a prebuilt mip chain have more than one
+		uint32_t GetMipLevels() const { return m_MipLevels; }
+		uint32_t GetLevelSize(uint32_t level) const;
+		// Size of every level together
+		uint32_t GetSize() const;
 
 		uint8_t* GetData() { return m_Pixels; }
 
+		// True when some pixel is neither fully opaque nor fully transparent, such textures
+		// have to be drawn back to front while alpha tested ones can be grouped freely
+		bool HasTranslucency() const { return m_HasTranslucency; }
+
 		void SetSamplerConfiguration(SamplerConfiguration samplerConfig);
 		const SamplerConfiguration* GetSamplerConfiguration() const { return &m_SamplerConfig; }
 
 		void SetData(void* pixels, uint32_t size);
 
 
+		// Queues the upload and returns immediately, the texture can be drawn right away
 		void CreateGPUTexture();
 		void DestroyGPUTexture();
 
 		void* GetGPUTexture() const { return m_GPUTextureHandle; }
+		// True once the pixels are resident in GPU memory
+		bool IsGPUTextureReady() const;
 
 	private:
+		struct ImageFile
+		{
+			// Points into Mapping for .btex files, otherwise allocated through stb_image
+			uint8_t* Pixels = nullptr;
+			MappedFile* Mapping = nullptr;
+			uint32_t Width = 0, Height = 0;
+			TextureFormat Format = TextureFormat::RGBA8;
+			uint32_t MipLevels = 1;
+			bool HasTranslucency = true;
+		};
+
+		// Safe to call from any thread
+		static bool ReadImageFile(const char* path, ImageFile& image);
+		static bool ReadBTexFile(const char* path, ImageFile& image);
+		// Frees an image that was never handed to SetImage
+		static void ReleaseImageFile(ImageFile& image);
+
+		void UpdateTranslucency();
+
+		static bool HasTranslucentPixels(const uint8_t* pixels, uint32_t pixelCount);
+
+		// Pixel memory SetImage can take ownership of
+		static uint8_t* AllocatePixels(uint64_t size);
+
+		// Takes ownership of the image pixels and mapping
+		void SetImage(const ImageFile& image);
+		void ReleasePixels();
+
 		// Texture dimensions
 		uint32_t m_Width, m_Height;
 
 		TextureFormat m_Format;
+		uint32_t m_MipLevels = 1;
 
 		SamplerConfiguration m_SamplerConfig;
 
 		// Texture pixel data
 		uint8_t* m_Pixels = nullptr;
+		// Backs m_Pixels when the texture was read from a .btex file
+		MappedFile* m_MappedFile = nullptr;
+
+		bool m_HasTranslucency = true;
 
 		void* m_GPUTextureHandle = nullptr;
 
+		friend class TextureLoader;
+		friend struct TextureLoadRequest;
+		friend class TextureAtlas;
 	};
 
 } // namespace BladeEngine
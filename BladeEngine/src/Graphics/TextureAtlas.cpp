@@ -0,0 +1,651 @@
+#include "TextureAtlas.hpp"
+
+#include "../Core/Base.hpp"
+#include "../Core/JobSystem.hpp"
+#include "../Core/Profiler.hpp"
+
+#include "TextureContainer.hpp"
+#include "TextureLoader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <thread>
+
+namespace BladeEngine::Graphics {
+
+	static const uint32_t AtlasCacheMagic = 0x4C544142; // "BATL" read as little endian
+	static const uint32_t AtlasCacheVersion = 1;
+
+	struct AtlasCacheHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		uint64_t Key;
+		uint32_t PageCount;
+		uint32_t SpriteCount;
+	};
+
+	// Followed by NameLength bytes of name
+	struct AtlasCacheSprite
+	{
+		uint32_t NameLength;
+		uint32_t Page;
+		float UVStartX, UVStartY;
+		float UVWidth, UVHeight;
+	};
+
+	namespace {
+
+	// Places rectangles at the lowest spot along the top edge of what was placed so far
+	class SkylinePacker
+	{
+	public:
+		SkylinePacker(uint32_t size)
+			: m_Size(size)
+		{
+			m_Nodes.push_back({ 0, 0, size });
+		}
+
+		bool Insert(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y)
+		{
+			size_t bestIndex = m_Nodes.size();
+			uint32_t bestBottom = UINT32_MAX, bestWidth = UINT32_MAX, bestY = 0;
+
+			for (size_t i = 0; i < m_Nodes.size(); i++)
+			{
+				uint32_t nodeY;
+				if (!Fit(i, width, height, nodeY))
+				{
+					continue;
+				}
+
+				if (nodeY + height < bestBottom || (nodeY + height == bestBottom && m_Nodes[i].Width < bestWidth))
+				{
+					bestIndex = i;
+					bestBottom = nodeY + height;
+					bestWidth = m_Nodes[i].Width;
+					bestY = nodeY;
+				}
+			}
+
+			if (bestIndex == m_Nodes.size())
+			{
+				return false;
+			}
+
+			x = m_Nodes[bestIndex].X;
+			y = bestY;
+
+			m_Nodes.insert(m_Nodes.begin() + bestIndex, { x, y + height, width });
+
+			// Cut the nodes now covered by the new one
+			for (size_t i = bestIndex + 1; i < m_Nodes.size();)
+			{
+				const Node& previous = m_Nodes[i - 1];
+				uint32_t previousEnd = previous.X + previous.Width;
+				if (m_Nodes[i].X >= previousEnd)
+				{
+					break;
+				}
+
+				uint32_t overlap = previousEnd - m_Nodes[i].X;
+				if (m_Nodes[i].Width <= overlap)
+				{
+					m_Nodes.erase(m_Nodes.begin() + i);
+					continue;
+				}
+
+				m_Nodes[i].X += overlap;
+				m_Nodes[i].Width -= overlap;
+				break;
+			}
+
+			for (size_t i = 0; i + 1 < m_Nodes.size();)
+			{
+				if (m_Nodes[i].Y == m_Nodes[i + 1].Y)
+				{
+					m_Nodes[i].Width += m_Nodes[i + 1].Width;
+					m_Nodes.erase(m_Nodes.begin() + i + 1);
+					continue;
+				}
+
+				i++;
+			}
+
+			m_UsedWidth = std::max(m_UsedWidth, x + width);
+			m_UsedHeight = std::max(m_UsedHeight, y + height);
+
+			return true;
+		}
+
+		uint32_t GetUsedWidth() const { return m_UsedWidth; }
+		uint32_t GetUsedHeight() const { return m_UsedHeight; }
+
+	private:
+		struct Node
+		{
+			uint32_t X, Y, Width;
+		};
+
+		// Lowest y a rectangle starting at the node can sit at without overlapping the skyline
+		bool Fit(size_t index, uint32_t width, uint32_t height, uint32_t& y) const
+		{
+			if (m_Nodes[index].X + width > m_Size)
+			{
+				return false;
+			}
+
+			y = 0;
+			uint32_t widthLeft = width;
+			for (size_t i = index; widthLeft > 0; i++)
+			{
+				y = std::max(y, m_Nodes[i].Y);
+				if (y + height > m_Size)
+				{
+					return false;
+				}
+
+				widthLeft -= std::min(widthLeft, m_Nodes[i].Width);
+			}
+
+			return true;
+		}
+
+	private:
+		uint32_t m_Size;
+		uint32_t m_UsedWidth = 0, m_UsedHeight = 0;
+		std::vector<Node> m_Nodes;
+	};
+
+	}
+
+	static uint64_t HashBytes(uint64_t hash, const void* data, size_t size)
+	{
+		// FNV-1a
+		const uint8_t* bytes = (const uint8_t*)data;
+		for (size_t i = 0; i < size; i++)
+		{
+			hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+		}
+
+		return hash;
+	}
+
+	static uint64_t HashString(uint64_t hash, const std::string& string)
+	{
+		uint64_t length = string.size();
+		hash = HashBytes(hash, &length, sizeof(length));
+		return HashBytes(hash, string.data(), string.size());
+	}
+
+	TextureAtlas::TextureAtlas(const TextureAtlasConfiguration& config)
+		: m_Config(config)
+	{
+	}
+
+	TextureAtlas::~TextureAtlas()
+	{
+		ClearPages();
+	}
+
+	void TextureAtlas::AddTexture(const std::string& name, Texture2D* texture)
+	{
+		Source source;
+		source.Name = name;
+		source.Texture = texture;
+		m_Sources.push_back(source);
+	}
+
+	void TextureAtlas::AddFile(const std::string& path, const std::string& name)
+	{
+		Source source;
+		source.Name = name.empty() ? path : name;
+		source.Path = path;
+		m_Sources.push_back(source);
+	}
+
+	bool TextureAtlas::Build()
+	{
+		BLD_PROFILE_SCOPE("Build Texture Atlas");
+
+		ClearPages();
+		m_LoadedFromCache = false;
+
+		uint64_t key = 0;
+		if (!m_Config.CachePath.empty())
+		{
+			key = ComputeCacheKey();
+			if (LoadCache(key))
+			{
+				m_LoadedFromCache = true;
+				return true;
+			}
+		}
+
+		// File sources are decoded on the job system, textures are read in place
+		std::vector<Texture2D::ImageFile> images(m_Sources.size());
+		std::vector<uint8_t> loaded(m_Sources.size(), 0);
+
+		// Waits for its own decodes only, JobSystem::Wait would also wait for every texture still streaming in
+		std::atomic<uint32_t> remainingSources((uint32_t)m_Sources.size());
+
+		JobSystem::Dispatch((uint32_t)m_Sources.size(), 1, [this, &images, &loaded, &remainingSources](uint32_t begin, uint32_t end)
+		{
+			for (uint32_t i = begin; i < end; i++)
+			{
+				if (!m_Sources[i].Texture)
+				{
+					loaded[i] = Texture2D::ReadImageFile(m_Sources[i].Path.c_str(), images[i]);
+				}
+			}
+
+			remainingSources.fetch_sub(end - begin, std::memory_order_release);
+		});
+
+		while (remainingSources.load(std::memory_order_acquire) > 0)
+		{
+			std::this_thread::yield();
+		}
+
+		bool success = true;
+		for (size_t i = 0; i < m_Sources.size(); i++)
+		{
+			Texture2D* texture = m_Sources[i].Texture;
+			if (texture)
+			{
+				images[i].Pixels = texture->GetData();
+				images[i].Width = texture->GetWidth();
+				images[i].Height = texture->GetHeight();
+				images[i].Format = texture->GetFormat();
+			}
+			else if (!loaded[i])
+			{
+				BLD_CORE_ERROR("Failed to read atlas source {}", m_Sources[i].Path);
+				success = false;
+				continue;
+			}
+
+			if (!images[i].Pixels || images[i].Format != TextureFormat::RGBA8)
+			{
+				BLD_CORE_ERROR("Atlas source {} has no RGBA8 pixels in memory", m_Sources[i].Name);
+				success = false;
+			}
+		}
+
+		// Tallest first keeps the skyline flat
+		std::vector<uint32_t> order(m_Sources.size());
+		for (uint32_t i = 0; i < order.size(); i++)
+		{
+			order[i] = i;
+		}
+
+		std::sort(order.begin(), order.end(), [&images](uint32_t a, uint32_t b)
+		{
+			if (images[a].Height != images[b].Height)
+			{
+				return images[a].Height > images[b].Height;
+			}
+			return images[a].Width > images[b].Width;
+		});
+
+		const uint32_t border = m_Config.Extrude * 2 + m_Config.Padding;
+
+		std::vector<SkylinePacker> packers;
+		std::vector<uint32_t> pageIndices(m_Sources.size(), 0);
+		std::vector<uint32_t> positionsX(m_Sources.size(), 0), positionsY(m_Sources.size(), 0);
+
+		for (uint32_t i : order)
+		{
+			if (!success)
+			{
+				break;
+			}
+
+			uint32_t width = images[i].Width + border;
+			uint32_t height = images[i].Height + border;
+
+			if (width > m_Config.PageSize || height > m_Config.PageSize)
+			{
+				BLD_CORE_ERROR("Atlas source {} is larger than a {} page", m_Sources[i].Name, m_Config.PageSize);
+				success = false;
+				break;
+			}
+
+			bool placed = false;
+			for (uint32_t page = 0; page < packers.size() && !placed; page++)
+			{
+				placed = packers[page].Insert(width, height, positionsX[i], positionsY[i]);
+				pageIndices[i] = page;
+			}
+
+			if (!placed)
+			{
+				packers.emplace_back(m_Config.PageSize);
+				packers.back().Insert(width, height, positionsX[i], positionsY[i]);
+				pageIndices[i] = (uint32_t)packers.size() - 1;
+			}
+		}
+
+		if (success)
+		{
+			std::vector<Texture2D::ImageFile> pages(packers.size());
+			for (size_t page = 0; page < pages.size(); page++)
+			{
+				// Multiples of 4 keep the pages block compressible
+				pages[page].Width = std::min((packers[page].GetUsedWidth() + 3) & ~3u, m_Config.PageSize);
+				pages[page].Height = std::min((packers[page].GetUsedHeight() + 3) & ~3u, m_Config.PageSize);
+				pages[page].Format = TextureFormat::RGBA8;
+
+				uint64_t size = (uint64_t)pages[page].Width * pages[page].Height * 4;
+				pages[page].Pixels = Texture2D::AllocatePixels(size);
+				memset(pages[page].Pixels, 0, size);
+			}
+
+			const int32_t extrude = (int32_t)m_Config.Extrude;
+
+			m_Sprites.resize(m_Sources.size());
+			for (size_t i = 0; i < m_Sources.size(); i++)
+			{
+				const Texture2D::ImageFile& image = images[i];
+				Texture2D::ImageFile& page = pages[pageIndices[i]];
+
+				// Edge texels are repeated into the extruded border
+				for (int32_t y = -extrude; y < (int32_t)image.Height + extrude; y++)
+				{
+					int32_t sourceY = std::clamp(y, 0, (int32_t)image.Height - 1);
+					uint8_t* row = page.Pixels + ((uint64_t)(positionsY[i] + extrude + y) * page.Width) * 4;
+
+					for (int32_t x = -extrude; x < (int32_t)image.Width + extrude; x++)
+					{
+						int32_t sourceX = std::clamp(x, 0, (int32_t)image.Width - 1);
+						memcpy(row + (positionsX[i] + extrude + x) * 4,
+							image.Pixels + ((uint64_t)sourceY * image.Width + sourceX) * 4, 4);
+					}
+				}
+
+				Sprite& sprite = m_Sprites[i];
+				sprite.Page = pageIndices[i];
+				sprite.UVStartPos = Vec2((float)(positionsX[i] + extrude) / page.Width,
+					(float)(positionsY[i] + extrude) / page.Height);
+				sprite.UVDimensions = Vec2((float)image.Width / page.Width, (float)image.Height / page.Height);
+
+				m_SpriteIndices[m_Sources[i].Name] = (uint32_t)i;
+			}
+
+			for (Texture2D::ImageFile& page : pages)
+			{
+				page.HasTranslucency = Texture2D::HasTranslucentPixels(page.Pixels, page.Width * page.Height);
+
+				Texture2D* texture = new Texture2D(0, 0, TextureFormat::RGBA8);
+				texture->SetSamplerConfiguration(m_Config.SamplerConfig);
+				texture->SetImage(page);
+				texture->CreateGPUTexture();
+
+				m_Pages.push_back(texture);
+			}
+
+			BLD_CORE_INFO("Packed {} sprites into {} atlas pages", m_Sprites.size(), m_Pages.size());
+		}
+
+		for (size_t i = 0; i < m_Sources.size(); i++)
+		{
+			if (!m_Sources[i].Texture)
+			{
+				Texture2D::ReleaseImageFile(images[i]);
+			}
+		}
+
+		if (!success)
+		{
+			ClearPages();
+			return false;
+		}
+
+		if (!m_Config.CachePath.empty())
+		{
+			SaveCache(key);
+		}
+
+		return true;
+	}
+
+	SpriteRenderer TextureAtlas::GetSprite(const std::string& name) const
+	{
+		SpriteRenderer renderer;
+
+		auto it = m_SpriteIndices.find(name);
+		if (it == m_SpriteIndices.end())
+		{
+			BLD_CORE_WARN("Texture atlas has no sprite named {}", name);
+			renderer.Texture = TextureLoader::GetPlaceholder();
+			return renderer;
+		}
+
+		const Sprite& sprite = m_Sprites[it->second];
+		renderer.Texture = m_Pages[sprite.Page];
+		renderer.UVStartPos = sprite.UVStartPos;
+		renderer.UVDimensions = sprite.UVDimensions;
+
+		return renderer;
+	}
+
+	std::vector<SpriteRenderer> TextureAtlas::GetFrames(const std::vector<std::string>& names) const
+	{
+		std::vector<SpriteRenderer> frames(names.size());
+
+		for (size_t i = 0; i < frames.size(); i++)
+		{
+			frames[i] = GetSprite(names[i]);
+		}
+
+		return frames;
+	}
+
+	uint64_t TextureAtlas::ComputeCacheKey() const
+	{
+		uint64_t hash = 0xCBF29CE484222325ull;
+
+		uint32_t config[] = { AtlasCacheVersion, m_Config.PageSize, m_Config.Padding, m_Config.Extrude };
+		hash = HashBytes(hash, config, sizeof(config));
+
+		for (const Source& source : m_Sources)
+		{
+			hash = HashString(hash, source.Name);
+
+			if (source.Texture)
+			{
+				uint32_t size[] = { source.Texture->GetWidth(), source.Texture->GetHeight(),
+					(uint32_t)source.Texture->GetFormat() };
+				hash = HashBytes(hash, size, sizeof(size));
+
+				if (source.Texture->GetData())
+				{
+					hash = HashBytes(hash, source.Texture->GetData(), source.Texture->GetSize());
+				}
+				continue;
+			}
+
+			hash = HashString(hash, source.Path);
+
+			// A cooked .btex next to the image replaces it when read, so its time counts as well
+			std::filesystem::path cookedPath(source.Path);
+			cookedPath.replace_extension(".btex");
+
+			for (const std::filesystem::path& path : { std::filesystem::path(source.Path), cookedPath })
+			{
+				std::error_code error;
+				int64_t stamp[2] = {};
+
+				auto size = std::filesystem::file_size(path, error);
+				if (!error)
+				{
+					stamp[0] = (int64_t)size;
+				}
+
+				auto time = std::filesystem::last_write_time(path, error);
+				if (!error)
+				{
+					stamp[1] = (int64_t)time.time_since_epoch().count();
+				}
+
+				hash = HashBytes(hash, stamp, sizeof(stamp));
+			}
+		}
+
+		return hash;
+	}
+
+	bool TextureAtlas::LoadCache(uint64_t key)
+	{
+		FILE* file = fopen(m_Config.CachePath.c_str(), "rb");
+		if (!file)
+		{
+			return false;
+		}
+
+		AtlasCacheHeader header;
+		if (fread(&header, sizeof(header), 1, file) != 1 || header.Magic != AtlasCacheMagic ||
+			header.Version != AtlasCacheVersion || header.Key != key)
+		{
+			fclose(file);
+			return false;
+		}
+
+		bool valid = true;
+		for (uint32_t i = 0; i < header.SpriteCount && valid; i++)
+		{
+			AtlasCacheSprite entry;
+			valid = fread(&entry, sizeof(entry), 1, file) == 1 && entry.Page < header.PageCount;
+
+			std::string name(valid ? entry.NameLength : 0, '\0');
+			valid = valid && fread(name.data(), 1, name.size(), file) == name.size();
+
+			if (valid)
+			{
+				Sprite sprite;
+				sprite.Page = entry.Page;
+				sprite.UVStartPos = Vec2(entry.UVStartX, entry.UVStartY);
+				sprite.UVDimensions = Vec2(entry.UVWidth, entry.UVHeight);
+
+				m_SpriteIndices[name] = (uint32_t)m_Sprites.size();
+				m_Sprites.push_back(sprite);
+			}
+		}
+		fclose(file);
+
+		for (uint32_t page = 0; page < header.PageCount && valid; page++)
+		{
+			std::string pagePath = m_Config.CachePath + "." + std::to_string(page) + ".btex";
+
+			Texture2D::ImageFile image;
+			valid = Texture2D::ReadImageFile(pagePath.c_str(), image);
+
+			if (valid)
+			{
+				Texture2D* texture = new Texture2D(0, 0, TextureFormat::RGBA8);
+				texture->SetSamplerConfiguration(m_Config.SamplerConfig);
+				texture->SetImage(image);
+				texture->CreateGPUTexture();
+
+				m_Pages.push_back(texture);
+			}
+		}
+
+		if (!valid)
+		{
+			BLD_CORE_WARN("Texture atlas cache {} is incomplete, packing again", m_Config.CachePath);
+			ClearPages();
+			return false;
+		}
+
+		return true;
+	}
+
+	void TextureAtlas::SaveCache(uint64_t key) const
+	{
+		std::error_code error;
+		std::filesystem::path directory = std::filesystem::path(m_Config.CachePath).parent_path();
+		if (!directory.empty())
+		{
+			std::filesystem::create_directories(directory, error);
+		}
+
+		// Pages first, so a cache file always refers to complete pages
+		for (uint32_t page = 0; page < m_Pages.size(); page++)
+		{
+			std::string pagePath = m_Config.CachePath + "." + std::to_string(page) + ".btex";
+
+			FILE* file = fopen(pagePath.c_str(), "wb");
+			if (!file)
+			{
+				BLD_CORE_WARN("Failed to write texture atlas page {}", pagePath);
+				return;
+			}
+
+			Texture2D* texture = m_Pages[page];
+
+			BTexHeader header = {};
+			header.Magic = BTexMagic;
+			header.Version = BTexVersion;
+			header.Format = (uint32_t)TextureFormat::RGBA8;
+			header.Width = texture->GetWidth();
+			header.Height = texture->GetHeight();
+			header.MipLevels = 1;
+			header.Flags = texture->HasTranslucency() ? BTexFlagTranslucent : 0;
+
+			fwrite(&header, sizeof(header), 1, file);
+			fwrite(texture->GetData(), 1, texture->GetSize(), file);
+			fclose(file);
+		}
+
+		FILE* file = fopen(m_Config.CachePath.c_str(), "wb");
+		if (!file)
+		{
+			BLD_CORE_WARN("Failed to write texture atlas cache {}", m_Config.CachePath);
+			return;
+		}
+
+		AtlasCacheHeader header;
+		header.Magic = AtlasCacheMagic;
+		header.Version = AtlasCacheVersion;
+		header.Key = key;
+		header.PageCount = (uint32_t)m_Pages.size();
+		header.SpriteCount = (uint32_t)m_SpriteIndices.size();
+		fwrite(&header, sizeof(header), 1, file);
+
+		for (const auto& [name, index] : m_SpriteIndices)
+		{
+			const Sprite& sprite = m_Sprites[index];
+
+			AtlasCacheSprite entry;
+			entry.NameLength = (uint32_t)name.size();
+			entry.Page = sprite.Page;
+			entry.UVStartX = sprite.UVStartPos.X;
+			entry.UVStartY = sprite.UVStartPos.Y;
+			entry.UVWidth = sprite.UVDimensions.X;
+			entry.UVHeight = sprite.UVDimensions.Y;
+
+			fwrite(&entry, sizeof(entry), 1, file);
+			fwrite(name.data(), 1, name.size(), file);
+		}
+
+		fclose(file);
+	}
+
+	void TextureAtlas::ClearPages()
+	{
+		for (Texture2D* page : m_Pages)
+		{
+			delete page;
+		}
+
+		m_Pages.clear();
+		m_Sprites.clear();
+		m_SpriteIndices.clear();
+	}
+
+}
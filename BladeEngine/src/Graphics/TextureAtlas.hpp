@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../Components/Components.hpp"
+#include "Texture2D.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace BladeEngine::Graphics {
+
+	struct TextureAtlasConfiguration
+	{
+		// Largest width and height of a page, pages are trimmed to the area actually used
+		uint32_t PageSize = 2048;
+		// Empty texels between two sprites
+		uint32_t Padding = 2;
+		// Texels of each sprite edge repeated around it, keeps linear filtering from reading the neighbours
+		uint32_t Extrude = 1;
+
+		Texture2D::SamplerConfiguration SamplerConfig;
+
+		// When set the packed pages and sprite rects are written to this file (pages next to it as
+		// <CachePath>.<page>.btex) and read back by later builds over the same sources
+		std::string CachePath;
+	};
+
+	// Packs many small images into a few RGBA8 pages so the sprites using them share a texture
+	// and batch together. Add the sources, call Build once, then hand out sprites by name
+	class TextureAtlas
+	{
+	public:
+		TextureAtlas(const TextureAtlasConfiguration& config = TextureAtlasConfiguration());
+		~TextureAtlas();
+
+		TextureAtlas(const TextureAtlas&) = delete;
+		TextureAtlas& operator=(const TextureAtlas&) = delete;
+
+		// The texture pixels have to be RGBA8 and still in memory when Build runs
+		void AddTexture(const std::string& name, Texture2D* texture);
+		// The file is only read when the cache is missing or out of date, the name defaults to the path
+		void AddFile(const std::string& path, const std::string& name = "");
+
+		// Packs every source and uploads the pages, false if some source could not be read or does not fit a page
+		bool Build();
+
+		bool HasSprite(const std::string& name) const { return m_SpriteIndices.find(name) != m_SpriteIndices.end(); }
+		// Sprite showing the named source, the placeholder texture if there is none
+		SpriteRenderer GetSprite(const std::string& name) const;
+		std::vector<SpriteRenderer> GetFrames(const std::vector<std::string>& names) const;
+
+		uint32_t GetPageCount() const { return (uint32_t)m_Pages.size(); }
+		Texture2D* GetPage(uint32_t index) const { return m_Pages[index]; }
+
+		// True when the last Build read its result from the cache
+		bool WasLoadedFromCache() const { return m_LoadedFromCache; }
+
+	private:
+		struct Source
+		{
+			std::string Name;
+			std::string Path;
+			Texture2D* Texture = nullptr;
+		};
+
+		struct Sprite
+		{
+			uint32_t Page;
+			Vec2 UVStartPos;
+			Vec2 UVDimensions;
+		};
+
+		// Identifies the sources and configuration, file sources by size and modification time
+		uint64_t ComputeCacheKey() const;
+		bool LoadCache(uint64_t key);
+		void SaveCache(uint64_t key) const;
+
+		void ClearPages();
+
+	private:
+		TextureAtlasConfiguration m_Config;
+
+		std::vector<Source> m_Sources;
+
+		std::vector<Texture2D*> m_Pages;
+		std::vector<Sprite> m_Sprites;
+		std::unordered_map<std::string, uint32_t> m_SpriteIndices;
+
+		bool m_LoadedFromCache = false;
+	};
+
+}
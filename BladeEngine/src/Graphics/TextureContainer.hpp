@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Texture2D.hpp"
+
+#include <cstdint>
+
+namespace BladeEngine::Graphics {
+
+	// .btex files are written by Tools/TextureCompressor: a BTexHeader followed by every mip level
+	// back to back, largest first, each GetTextureLevelSize bytes long. The pixels are stored exactly as
+	// the GPU wants them so the file is mapped and copied to staging as is
+	static const uint32_t BTexMagic = 0x58455442; // "BTEX" read as little endian
+	static const uint32_t BTexVersion = 1;
+
+	enum BTexFlags : uint32_t
+	{
+		// Some pixel of the source image was neither fully opaque nor fully transparent
+		BTexFlagTranslucent = 1 << 0
+	};
+
+	struct BTexHeader
+	{
+		uint32_t Magic;
+		uint32_t Version;
+		// TextureFormat value
+		uint32_t Format;
+		uint32_t Width;
+		uint32_t Height;
+		uint32_t MipLevels;
+		uint32_t Flags;
+		uint32_t Reserved;
+	};
+
+	inline bool IsCompressedFormat(TextureFormat format)
+	{
+		switch (format)
+		{
+		case TextureFormat::BC1:
+		case TextureFormat::BC3:
+		case TextureFormat::BC7:
+		case TextureFormat::ETC2_RGB8:
+		case TextureFormat::ETC2_RGBA8:
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	// Bytes of one 4x4 block, 0 for uncompressed formats
+	inline uint32_t GetFormatBlockSize(TextureFormat format)
+	{
+		switch (format)
+		{
+		case TextureFormat::BC1:
+		case TextureFormat::ETC2_RGB8:
+			return 8;
+		case TextureFormat::BC3:
+		case TextureFormat::BC7:
+		case TextureFormat::ETC2_RGBA8:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	// Bytes of one pixel, 0 for block compressed formats
+	inline uint32_t GetFormatPixelSize(TextureFormat format)
+	{
+		switch (format)
+		{
+		case TextureFormat::R8:
+			return 1;
+		case TextureFormat::RG8:
+			return 2;
+		case TextureFormat::RGB8:
+			return 3;
+		case TextureFormat::RGBA8:
+			return 4;
+		case TextureFormat::RGBA32F:
+			return 16;
+		default:
+			return 0;
+		}
+	}
+
+	// Partial blocks on the right and bottom edges are stored whole
+	inline uint64_t GetTextureLevelSize(TextureFormat format, uint32_t width, uint32_t height)
+	{
+		if (!IsCompressedFormat(format))
+		{
+			return (uint64_t)width * height * GetFormatPixelSize(format);
+		}
+
+		uint64_t blocksX = (width + 3) / 4;
+		uint64_t blocksY = (height + 3) / 4;
+		return blocksX * blocksY * GetFormatBlockSize(format);
+	}
+
+}
@@ -0,0 +1,250 @@
+#include "TextureLoader.hpp"
+
+#include "../Core/Base.hpp"
+#include "../Core/JobSystem.hpp"
+#include "../Core/Profiler.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+namespace BladeEngine::Graphics {
+
+	static const char* s_PlaceholderPath = "assets/sprites/default-checker-gray.png";
+
+	enum class TextureLoadState : uint8_t
+	{
+		Decoding,
+		// Pixels are waiting for the main thread
+		Decoded,
+		// Pixels were handed to the texture and the GPU upload is queued
+		Uploading,
+		Ready,
+		Failed
+	};
+
+	struct TextureLoadRequest
+	{
+		std::string Path;
+		Texture2D* Texture = nullptr;
+
+		std::atomic<TextureLoadState> State { TextureLoadState::Decoding };
+
+		// Written by the worker, read by the main thread once State is Decoded
+		Texture2D::ImageFile Image;
+
+		// Set by Unload, the worker frees the pixels instead of publishing them
+		bool Cancelled = false;
+	};
+
+	// Guards the hand over of decoded pixels between the workers and the main thread
+	static std::mutex s_DecodeMutex;
+	static std::condition_variable s_DecodeFinished;
+
+	Texture2D* TextureLoader::s_Placeholder = nullptr;
+	uint64_t TextureLoader::s_UploadBudget = 16 * 1024 * 1024;
+	std::vector<std::shared_ptr<TextureLoadRequest>> TextureLoader::s_Requests;
+	std::vector<std::shared_ptr<TextureLoadRequest>> TextureLoader::s_Pending;
+
+	bool TextureHandle::IsReady() const
+	{
+		return m_Request && m_Request->State == TextureLoadState::Ready;
+	}
+
+	bool TextureHandle::HasFailed() const
+	{
+		return m_Request && m_Request->State == TextureLoadState::Failed;
+	}
+
+	Texture2D* TextureHandle::Get() const
+	{
+		return IsReady() ? m_Request->Texture : TextureLoader::GetPlaceholder();
+	}
+
+	Texture2D* TextureHandle::GetTexture() const
+	{
+		return m_Request ? m_Request->Texture : nullptr;
+	}
+
+	void TextureHandle::Wait() const
+	{
+		if (!m_Request)
+		{
+			return;
+		}
+
+		TextureLoader::WaitDecoded(*m_Request);
+		TextureLoader::Apply(*m_Request);
+	}
+
+	void TextureLoader::Init()
+	{
+		s_Placeholder = new Texture2D(s_PlaceholderPath);
+		s_Placeholder->CreateGPUTexture();
+	}
+
+	void TextureLoader::Shutdown()
+	{
+		// Decode jobs only hold on to their request, they can finish after the textures are gone
+		std::vector<std::shared_ptr<TextureLoadRequest>> requests = std::move(s_Requests);
+		for (auto& request : requests)
+		{
+			TextureHandle handle;
+			handle.m_Request = request;
+			Unload(handle);
+		}
+		s_Requests.clear();
+
+		delete s_Placeholder;
+		s_Placeholder = nullptr;
+	}
+
+	TextureHandle TextureLoader::LoadAsync(const std::string& path, Texture2D::SamplerConfiguration samplerConfig)
+	{
+		auto request = std::make_shared<TextureLoadRequest>();
+		request->Path = path;
+		request->Texture = new Texture2D(0, 0, TextureFormat::RGBA8);
+		request->Texture->SetSamplerConfiguration(samplerConfig);
+
+		s_Requests.push_back(request);
+		s_Pending.push_back(request);
+
+		JobSystem::Execute([request]() { Decode(request); });
+
+		TextureHandle handle;
+		handle.m_Request = request;
+		return handle;
+	}
+
+	void TextureLoader::Unload(TextureHandle& handle)
+	{
+		if (!handle.m_Request)
+		{
+			return;
+		}
+
+		std::shared_ptr<TextureLoadRequest> request = std::move(handle.m_Request);
+
+		{
+			std::lock_guard<std::mutex> lock(s_DecodeMutex);
+			request->Cancelled = true;
+
+			if (request->State == TextureLoadState::Decoded)
+			{
+				Texture2D::ReleaseImageFile(request->Image);
+			}
+		}
+
+		s_Pending.erase(std::remove(s_Pending.begin(), s_Pending.end(), request), s_Pending.end());
+		s_Requests.erase(std::remove(s_Requests.begin(), s_Requests.end(), request), s_Requests.end());
+
+		delete request->Texture;
+		request->Texture = nullptr;
+	}
+
+	void TextureLoader::Update()
+	{
+		uint64_t uploadedBytes = 0;
+
+		for (size_t i = 0; i < s_Pending.size();)
+		{
+			TextureLoadRequest& request = *s_Pending[i];
+
+			if (request.State == TextureLoadState::Decoded && (uploadedBytes == 0 || uploadedBytes < s_UploadBudget))
+			{
+				Apply(request);
+				uploadedBytes += request.Texture->GetSize();
+			}
+
+			if (request.State == TextureLoadState::Uploading && request.Texture->IsGPUTextureReady())
+			{
+				request.State = TextureLoadState::Ready;
+			}
+
+			if (request.State == TextureLoadState::Failed)
+			{
+				BLD_CORE_WARN("Failed to load texture at {}, drawing the placeholder instead", request.Path);
+			}
+
+			if (request.State == TextureLoadState::Ready || request.State == TextureLoadState::Failed)
+			{
+				s_Pending.erase(s_Pending.begin() + i);
+				continue;
+			}
+
+			i++;
+		}
+	}
+
+	void TextureLoader::WaitAll()
+	{
+		for (size_t i = 0; i < s_Pending.size(); i++)
+		{
+			WaitDecoded(*s_Pending[i]);
+			Apply(*s_Pending[i]);
+		}
+	}
+
+	void TextureLoader::Decode(const std::shared_ptr<TextureLoadRequest>& request)
+	{
+		BLD_PROFILE_SCOPE("Decode Texture");
+
+		{
+			std::lock_guard<std::mutex> lock(s_DecodeMutex);
+			if (request->Cancelled)
+			{
+				return;
+			}
+		}
+
+		Texture2D::ImageFile image;
+		bool loaded = Texture2D::ReadImageFile(request->Path.c_str(), image);
+
+		{
+			std::lock_guard<std::mutex> lock(s_DecodeMutex);
+
+			if (request->Cancelled)
+			{
+				Texture2D::ReleaseImageFile(image);
+				return;
+			}
+
+			if (loaded)
+			{
+				request->Image = image;
+				request->State = TextureLoadState::Decoded;
+			}
+			else
+			{
+				request->State = TextureLoadState::Failed;
+			}
+		}
+
+		s_DecodeFinished.notify_all();
+	}
+
+	void TextureLoader::Apply(TextureLoadRequest& request)
+	{
+		if (request.State != TextureLoadState::Decoded)
+		{
+			return;
+		}
+
+		request.Texture->SetImage(request.Image);
+		request.Image.Pixels = nullptr;
+		request.Image.Mapping = nullptr;
+
+		request.Texture->CreateGPUTexture();
+
+		// The device may lack the block compression family of the file
+		request.State = request.Texture->GetGPUTexture() ? TextureLoadState::Uploading : TextureLoadState::Failed;
+	}
+
+	void TextureLoader::WaitDecoded(const TextureLoadRequest& request)
+	{
+		std::unique_lock<std::mutex> lock(s_DecodeMutex);
+		s_DecodeFinished.wait(lock, [&request]() { return request.State != TextureLoadState::Decoding; });
+	}
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Texture2D.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace BladeEngine::Graphics {
+
+	struct TextureLoadRequest;
+
+	// Reference to a texture streamed in by the TextureLoader. The texture object exists right away
+	// and can be handed to sprites, it is drawn with the placeholder until its pixels are on the GPU
+	class TextureHandle
+	{
+	public:
+		TextureHandle() = default;
+
+		bool IsValid() const { return m_Request != nullptr; }
+
+		// True once the pixels are resident in GPU memory
+		bool IsReady() const;
+		// True when the file could not be read or decoded, the placeholder is drawn instead
+		bool HasFailed() const;
+
+		// The texture when it is ready, the placeholder otherwise
+		Texture2D* Get() const;
+		// The streamed texture itself, its size is only known once it has been decoded
+		Texture2D* GetTexture() const;
+
+		// Blocks until the texture is decoded and its upload queued, after which its size and pixels are valid
+		void Wait() const;
+
+	private:
+		std::shared_ptr<TextureLoadRequest> m_Request;
+
+		friend class TextureLoader;
+	};
+
+	// Decodes image files on the JobSystem workers and uploads them from the main thread in Update,
+	// spreading the uploads over several frames when many textures finish decoding at once
+	class TextureLoader
+	{
+	public:
+		// Loads the placeholder synchronously, needs the GraphicsManager and the JobSystem
+		static void Init();
+		// Cancels the pending loads and destroys every texture that was not unloaded
+		static void Shutdown();
+
+		static TextureHandle LoadAsync(const std::string& path,
+			Texture2D::SamplerConfiguration samplerConfig = Texture2D::SamplerConfiguration());
+		// Cancels the load if it is still pending and destroys the texture
+		static void Unload(TextureHandle& handle);
+
+		// Applies decoded pixels and queues their upload, called once per frame on the main thread
+		static void Update();
+		// Blocks until every pending texture is decoded and its upload queued
+		static void WaitAll();
+
+		static Texture2D* GetPlaceholder() { return s_Placeholder; }
+		static uint32_t GetPendingCount() { return (uint32_t)s_Pending.size(); }
+
+		// Bytes of decoded pixels queued for upload per Update, at least one texture is always uploaded
+		static void SetUploadBudget(uint64_t bytesPerFrame) { s_UploadBudget = bytesPerFrame; }
+
+	private:
+		static void Decode(const std::shared_ptr<TextureLoadRequest>& request);
+		// Hands the decoded pixels to the texture and queues its upload, no-op unless the request is decoded
+		static void Apply(TextureLoadRequest& request);
+
+		static void WaitDecoded(const TextureLoadRequest& request);
+
+	private:
+		static Texture2D* s_Placeholder;
+
+		static uint64_t s_UploadBudget;
+
+		// Every request that was not unloaded yet
+		static std::vector<std::shared_ptr<TextureLoadRequest>> s_Requests;
+		// Requests whose texture is not resident yet, in load order
+		static std::vector<std::shared_ptr<TextureLoadRequest>> s_Pending;
+
+		friend class TextureHandle;
+	};
+
+}
@@ -0,0 +1,93 @@
+#include "VisibilityCulling.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace BladeEngine::Graphics {
+
+	const glm::vec4 VisibilityCuller::QuadBounds = glm::vec4(-0.5f, -0.5f, 0.5f, 0.5f);
+
+	void VisibilityCuller::BeginFrame(Camera* camera)
+	{
+		m_Statistics = CullingStatistics();
+
+		m_Enabled = camera && camera->GetType() == CameraType::ORTHOGRAPHIC;
+		if (!m_Enabled)
+		{
+			return;
+		}
+
+		// Orthographic, so x and y of the unprojected NDC corners do not depend on depth
+		glm::mat4 inverseViewProjection = glm::inverse(camera->GetProjectionMatrix() * camera->GetViewMatrix());
+
+		glm::vec2 min(INFINITY), max(-INFINITY);
+		for (float x : { -1.0f, 1.0f })
+		{
+			for (float y : { -1.0f, 1.0f })
+			{
+				glm::vec4 corner = inverseViewProjection * glm::vec4(x, y, 0.0f, 1.0f);
+				glm::vec2 world = glm::vec2(corner) / corner.w;
+
+				min = glm::min(min, world);
+				max = glm::max(max, world);
+			}
+		}
+
+		m_ViewCenter = (min + max) * 0.5f;
+		m_ViewHalfExtents = (max - min) * 0.5f;
+	}
+
+	bool VisibilityCuller::IsVisible(const glm::mat4& transform, const glm::vec4& localBounds)
+	{
+		uint8_t visible;
+		CullBatch(&transform[0][0], 1, 16, localBounds, &visible);
+
+		return visible;
+	}
+
+	uint32_t VisibilityCuller::CullBatch(const float* matrices, size_t count, size_t stride,
+		const glm::vec4& localBounds, uint8_t* visibility)
+	{
+		m_Statistics.Candidates += (uint32_t)count;
+
+		if (!m_Enabled)
+		{
+			std::fill(visibility, visibility + count, (uint8_t)1);
+			return (uint32_t)count;
+		}
+
+		const float localCenterX = (localBounds.x + localBounds.z) * 0.5f;
+		const float localCenterY = (localBounds.y + localBounds.w) * 0.5f;
+		const float localHalfX = (localBounds.z - localBounds.x) * 0.5f;
+		const float localHalfY = (localBounds.w - localBounds.y) * 0.5f;
+
+		const float viewCenterX = m_ViewCenter.x, viewCenterY = m_ViewCenter.y;
+		const float viewHalfX = m_ViewHalfExtents.x, viewHalfY = m_ViewHalfExtents.y;
+
+		// Straight line arithmetic with no early out so the loop vectorizes,
+		// the world AABB of the transformed rectangle is tested against the view rectangle
+		uint32_t visibleCount = 0;
+		for (size_t i = 0; i < count; i++)
+		{
+			const float* m = matrices + i * stride;
+
+			const float centerX = m[0] * localCenterX + m[4] * localCenterY + m[12];
+			const float centerY = m[1] * localCenterX + m[5] * localCenterY + m[13];
+
+			const float halfX = std::fabs(m[0]) * localHalfX + std::fabs(m[4]) * localHalfY;
+			const float halfY = std::fabs(m[1]) * localHalfX + std::fabs(m[5]) * localHalfY;
+
+			const bool visible =
+				(std::fabs(centerX - viewCenterX) <= halfX + viewHalfX) &
+				(std::fabs(centerY - viewCenterY) <= halfY + viewHalfY);
+
+			visibility[i] = (uint8_t)visible;
+			visibleCount += visible;
+		}
+
+		m_Statistics.Culled += (uint32_t)count - visibleCount;
+
+		return visibleCount;
+	}
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "../Core/Camera.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace BladeEngine::Graphics {
+
+	// Candidates tested against the view since the last BeginFrame
+	struct CullingStatistics
+	{
+		uint32_t Candidates = 0;
+		uint32_t Culled = 0;
+	};
+
+	// Rejects renderables whose world space bounds fall outside the orthographic view rectangle.
+	// Perspective cameras disable culling, every test passes
+	class VisibilityCuller
+	{
+	public:
+		// Local bounds of Mesh::Quad, the mesh every sprite is drawn with
+		static const glm::vec4 QuadBounds;
+
+		void BeginFrame(Camera* camera);
+
+		// Bounds are given in the renderable's local space as (min x, min y, max x, max y)
+		bool IsVisible(const glm::mat4& transform, const glm::vec4& localBounds);
+
+		// Tests count column major 4x4 matrices laid out contiguously with the given stride in floats,
+		// writing 1 to visibility for every visible one. Returns the visible count
+		uint32_t CullBatch(const float* matrices, size_t count, size_t stride,
+			const glm::vec4& localBounds, uint8_t* visibility);
+
+		const CullingStatistics& GetStatistics() const { return m_Statistics; }
+
+	private:
+		bool m_Enabled = false;
+
+		glm::vec2 m_ViewCenter{ 0.0f };
+		glm::vec2 m_ViewHalfExtents{ 0.0f };
+
+		CullingStatistics m_Statistics;
+	};
+
+}
@@ -1,9 +1,14 @@
 #include "Physics2D.hpp"
 
 #include "../Components/Components.hpp"
+#include "../Core/JobSystem.hpp"
+#include "../Core/Profiler.hpp"
 
 #include "box2d/box2d.h"
 
+#include <atomic>
+#include <thread>
+
 namespace BladeEngine
 {
 
@@ -42,11 +47,348 @@ namespace BladeEngine
 
     static WorldContactListener* s_ContactListener;
 
+    // Owned by the physics bridge. Rigidbody2D::RuntimeBody is only a copy, setting the component overwrites it
+    struct PhysicsBody2D
+    {
+        b2Body* Body = nullptr;
+    };
+
+    // The rigidbody or a collider changed, the next fixed step creates or rebuilds the body
+    struct PhysicsBodyDirty { };
+
+    // Fixture and body definitions are built on the stack, Box2D takes bodies, fixtures and shapes
+    // from its block allocator free lists, so steady spawning and destroying does not reach the heap
+    template<typename Collider>
+    static void CreateFixture(b2Body* body, const b2Shape& shape, const Collider& collider, flecs::entity_t entity)
+    {
+        b2FixtureDef fixtureDef;
+        fixtureDef.shape = &shape;
+        // World queries report the entity a fixture belongs to
+        fixtureDef.userData.pointer = (uintptr_t)entity;
+        fixtureDef.density = collider.Material.Density;
+        fixtureDef.friction = collider.Material.Friction;
+        fixtureDef.restitution = collider.Material.Restitution;
+        fixtureDef.restitutionThreshold = collider.Material.RestitutionThreshold;
+
+        fixtureDef.filter.categoryBits = collider.CollisionLayers;
+        fixtureDef.filter.maskBits = collider.CollisionMask;
+        fixtureDef.filter.groupIndex = collider.GroupId;
+
+        fixtureDef.isSensor = collider.IsSensor;
+
+        body->CreateFixture(&fixtureDef);
+    }
+
+    static void DestroyFixtures(b2Body* body, b2Shape::Type type)
+    {
+        b2Fixture* fixture = body->GetFixtureList();
+        while (fixture)
+        {
+            b2Fixture* next = fixture->GetNext();
+            if (fixture->GetType() == type)
+            {
+                body->DestroyFixture(fixture);
+            }
+            fixture = next;
+        }
+    }
+
+    // Creates the body the first time, afterwards applies the rigidbody settings and rebuilds the fixtures
+    static void SyncBody(flecs::entity e, const Position& pos, Rigidbody2D& rb)
+    {
+        b2Body* body = rb.RuntimeBody;
+
+        if (!body)
+        {
+            const Rotation* rot = e.get<Rotation>();
+
+            b2BodyDef bodyDef;
+            bodyDef.type = (b2BodyType)rb.Type;
+            bodyDef.position.Set(pos.Value.X, pos.Value.Y);
+            bodyDef.angle = rot ? rot->Angle : 0.0f;
+            bodyDef.fixedRotation = rb.LockRotation;
+
+            body = ((b2World*)Physics2D::GetPhysicsWorldHandle())->CreateBody(&bodyDef);
+
+            rb.RuntimeBody = body;
+            rb.SyncedPosition = pos.Value;
+            rb.SyncedAngle = bodyDef.angle;
+
+            e.set<PhysicsBody2D>({ body });
+
+            // Bodies move in fixed steps, draw them in between
+            TransformInterpolation interpolation;
+            interpolation.PreviousPosition = pos.Value;
+            interpolation.PreviousAngle = bodyDef.angle;
+            e.set<TransformInterpolation>(interpolation);
+        }
+        else
+        {
+            body->SetType((b2BodyType)rb.Type);
+            body->SetFixedRotation(rb.LockRotation);
+
+            DestroyFixtures(body, b2Shape::e_polygon);
+            DestroyFixtures(body, b2Shape::e_circle);
+        }
+
+        if (rb.ContactListener)
+        {
+            rb.ContactListener->SetEntity(e);
+        }
+        body->GetUserData().pointer = (uintptr_t)rb.ContactListener;
+
+        if (const BoxCollider2D* collider = e.get<BoxCollider2D>())
+        {
+            b2PolygonShape shape;
+            shape.SetAsBox(collider->HalfExtents.X, collider->HalfExtents.Y);
+            CreateFixture(body, shape, *collider, e.id());
+        }
+
+        if (const CircleCollider2D* collider = e.get<CircleCollider2D>())
+        {
+            b2CircleShape shape;
+            shape.m_radius = collider->Radius;
+            CreateFixture(body, shape, *collider, e.id());
+        }
+    }
+
     int Physics2D::s_VelocityIterations = 6;
     int Physics2D::s_PositionIterations = 2;
 
     b2World* Physics2D::s_PhysicsWorld;
 
+    static bool PassesFilter(b2Fixture* fixture, const PhysicsQueryFilter& filter)
+    {
+        return (fixture->GetFilterData().categoryBits & filter.LayerMask) != 0 &&
+            (filter.IncludeSensors || !fixture->IsSensor());
+    }
+
+    static flecs::entity GetFixtureEntity(b2Fixture* fixture)
+    {
+        return flecs::entity(*World::GetECSWorldHandle(), (flecs::entity_t)fixture->GetUserData().pointer);
+    }
+
+    // Keeps the closest hits sorted by distance, once full the ray is clipped to the farthest one kept
+    class ClosestHitsRaycastCallback : public b2RayCastCallback
+    {
+    public:
+        ClosestHitsRaycastCallback(const PhysicsQueryFilter& filter, float maxDistance, RaycastHit* hits, uint32_t maxHits)
+            : m_Filter(filter), m_MaxDistance(maxDistance), m_Hits(hits), m_MaxHits(maxHits) { }
+
+        virtual float ReportFixture(b2Fixture* fixture, const b2Vec2& point, const b2Vec2& normal, float fraction) override
+        {
+            if (!PassesFilter(fixture, m_Filter))
+            {
+                return -1.0f;
+            }
+
+            const float distance = fraction * m_MaxDistance;
+
+            uint32_t i = m_Count < m_MaxHits ? m_Count++ : m_Count - 1;
+            for (; i > 0 && m_Hits[i - 1].Distance > distance; i--)
+            {
+                m_Hits[i] = m_Hits[i - 1];
+            }
+
+            m_Hits[i].Entity = GetFixtureEntity(fixture);
+            m_Hits[i].Point = Vec2(point.x, point.y);
+            m_Hits[i].Normal = Vec2(normal.x, normal.y);
+            m_Hits[i].Distance = distance;
+
+            return m_Count == m_MaxHits ? m_Hits[m_Count - 1].Distance / m_MaxDistance : 1.0f;
+        }
+
+        uint32_t GetCount() const { return m_Count; }
+
+    private:
+        const PhysicsQueryFilter& m_Filter;
+        float m_MaxDistance;
+
+        RaycastHit* m_Hits;
+        uint32_t m_MaxHits;
+        uint32_t m_Count = 0;
+    };
+
+    class OverlapQueryCallback : public b2QueryCallback
+    {
+    public:
+        OverlapQueryCallback(const b2Shape& shape, const b2Transform& transform, const PhysicsQueryFilter& filter,
+            flecs::entity* entities, uint32_t maxEntities)
+            : m_Shape(shape), m_Transform(transform), m_Filter(filter), m_Entities(entities), m_MaxEntities(maxEntities) { }
+
+        virtual bool ReportFixture(b2Fixture* fixture) override
+        {
+            if (!PassesFilter(fixture, m_Filter))
+            {
+                return true;
+            }
+
+            // The broadphase only compares fattened bounds, the shapes themselves decide
+            const b2Shape* shape = fixture->GetShape();
+            for (int32 child = 0; child < shape->GetChildCount(); child++)
+            {
+                if (b2TestOverlap(shape, child, &m_Shape, 0, fixture->GetBody()->GetTransform(), m_Transform))
+                {
+                    Add(GetFixtureEntity(fixture));
+                    break;
+                }
+            }
+
+            return m_Count < m_MaxEntities;
+        }
+
+        uint32_t GetCount() const { return m_Count; }
+
+    private:
+        // A body with several colliders is listed once
+        void Add(flecs::entity entity)
+        {
+            for (uint32_t i = 0; i < m_Count; i++)
+            {
+                if (m_Entities[i].id() == entity.id())
+                {
+                    return;
+                }
+            }
+
+            m_Entities[m_Count++] = entity;
+        }
+
+    private:
+        const b2Shape& m_Shape;
+        b2Transform m_Transform;
+        const PhysicsQueryFilter& m_Filter;
+
+        flecs::entity* m_Entities;
+        uint32_t m_MaxEntities;
+        uint32_t m_Count = 0;
+    };
+
+    // Sweeps the shape against every fixture whose bounds touch the swept bounds, keeping the earliest contact
+    class ShapeCastCallback : public b2QueryCallback
+    {
+    public:
+        ShapeCastCallback(const b2Shape& shape, const b2Vec2& origin, const b2Vec2& translation, const PhysicsQueryFilter& filter)
+            : m_Filter(filter)
+        {
+            m_Input.proxyB.Set(&shape, 0);
+            m_Input.transformB.Set(origin, 0.0f);
+            m_Input.translationB = translation;
+        }
+
+        virtual bool ReportFixture(b2Fixture* fixture) override
+        {
+            if (!PassesFilter(fixture, m_Filter))
+            {
+                return true;
+            }
+
+            m_Input.transformA = fixture->GetBody()->GetTransform();
+
+            const b2Shape* shape = fixture->GetShape();
+            for (int32 child = 0; child < shape->GetChildCount(); child++)
+            {
+                m_Input.proxyA.Set(shape, child);
+
+                b2ShapeCastOutput output;
+                if (b2ShapeCast(&output, &m_Input) && output.lambda < m_Lambda)
+                {
+                    m_Lambda = output.lambda;
+                    m_Fixture = fixture;
+                    m_Point = output.point;
+                    m_Normal = output.normal;
+                }
+            }
+
+            return true;
+        }
+
+        bool GetHit(float maxDistance, RaycastHit& hit) const
+        {
+            if (!m_Fixture)
+            {
+                return false;
+            }
+
+            // Facing back against the sweep, whichever side the cast reported
+            b2Vec2 normal = m_Normal;
+            if (b2Dot(normal, m_Input.translationB) > 0.0f)
+            {
+                normal = -normal;
+            }
+
+            hit.Entity = GetFixtureEntity(m_Fixture);
+            hit.Point = Vec2(m_Point.x, m_Point.y);
+            hit.Normal = Vec2(normal.x, normal.y);
+            hit.Distance = m_Lambda * maxDistance;
+
+            return true;
+        }
+
+    private:
+        const PhysicsQueryFilter& m_Filter;
+        b2ShapeCastInput m_Input;
+
+        b2Fixture* m_Fixture = nullptr;
+        float m_Lambda = 1.0f;
+        b2Vec2 m_Point;
+        b2Vec2 m_Normal;
+    };
+
+    static uint32_t Overlap(const b2Shape& shape, Vec2 center, const PhysicsQueryFilter& filter,
+        flecs::entity* entities, uint32_t maxEntities)
+    {
+        b2World* physicsWorld = (b2World*)Physics2D::GetPhysicsWorldHandle();
+        if (!physicsWorld || maxEntities == 0)
+        {
+            return 0;
+        }
+
+        b2Transform transform;
+        transform.Set(b2Vec2(center.X, center.Y), 0.0f);
+
+        b2AABB bounds;
+        shape.ComputeAABB(&bounds, transform, 0);
+
+        OverlapQueryCallback callback(shape, transform, filter, entities, maxEntities);
+        physicsWorld->QueryAABB(&callback, bounds);
+
+        return callback.GetCount();
+    }
+
+    static bool ShapeCast(const b2Shape& shape, Vec2 origin, Vec2 direction, float maxDistance, RaycastHit& hit,
+        const PhysicsQueryFilter& filter)
+    {
+        hit = RaycastHit();
+
+        b2World* physicsWorld = (b2World*)Physics2D::GetPhysicsWorldHandle();
+        const float length = direction.Length();
+        if (!physicsWorld || maxDistance <= 0.0f || length <= 0.0f)
+        {
+            return false;
+        }
+
+        const b2Vec2 start(origin.X, origin.Y);
+        const b2Vec2 translation(direction.X * maxDistance / length, direction.Y * maxDistance / length);
+
+        b2Transform transform;
+        transform.Set(start, 0.0f);
+        b2AABB startBounds;
+        shape.ComputeAABB(&startBounds, transform, 0);
+
+        transform.Set(start + translation, 0.0f);
+        b2AABB endBounds;
+        shape.ComputeAABB(&endBounds, transform, 0);
+
+        b2AABB sweptBounds;
+        sweptBounds.Combine(startBounds, endBounds);
+
+        ShapeCastCallback callback(shape, start, translation, filter);
+        physicsWorld->QueryAABB(&callback, sweptBounds);
+
+        return callback.GetHit(maxDistance, hit);
+    }
+
     void Physics2D::SetVelocity2D(Rigidbody2D& rb, Vec2 direction, float strength)
     {
         b2Vec2 velocity(direction.X * strength, direction.Y * strength);
@@ -60,14 +402,95 @@ namespace BladeEngine
 
         s_ContactListener = new WorldContactListener();
         s_PhysicsWorld->SetContactListener(s_ContactListener);
+
+        RegisterBodyLifecycle();
     }
     
     void Physics2D::Shutdown()
     {
         delete s_PhysicsWorld;
+        // Entities deleted later, the whole ECS world on exit included, have no bodies left to destroy
+        s_PhysicsWorld = nullptr;
 
         delete s_ContactListener;
     }
+
+    void Physics2D::RegisterBodyLifecycle()
+    {
+        flecs::world* world = World::GetECSWorldHandle();
+
+        // Observers only flag the entity, the body is built by the next fixed step. By then every component
+        // an entity was spawned with is in place, however it was added, and no rebuild runs twice a step
+        world->observer<Rigidbody2D>("Rigidbody Changed")
+            .term_at(1).self()
+            .event(flecs::OnAdd)
+            .event(flecs::OnSet)
+            .each([](flecs::entity e, Rigidbody2D& rb)
+            {
+                if (const PhysicsBody2D* body = e.get<PhysicsBody2D>())
+                {
+                    rb.RuntimeBody = body->Body;
+                }
+
+                e.add<PhysicsBodyDirty>();
+            });
+
+        world->observer<const BoxCollider2D, const Rigidbody2D>("Box Collider Changed")
+            .term_at(2).self().filter()
+            .event(flecs::OnAdd)
+            .event(flecs::OnSet)
+            .each([](flecs::entity e, const BoxCollider2D&, const Rigidbody2D&) { e.add<PhysicsBodyDirty>(); });
+
+        world->observer<const CircleCollider2D, const Rigidbody2D>("Circle Collider Changed")
+            .term_at(2).self().filter()
+            .event(flecs::OnAdd)
+            .event(flecs::OnSet)
+            .each([](flecs::entity e, const CircleCollider2D&, const Rigidbody2D&) { e.add<PhysicsBodyDirty>(); });
+
+        // Removals act right away, the entity may be gone by the next step
+        world->observer<const BoxCollider2D, const Rigidbody2D>("Box Collider Removed")
+            .term_at(2).self().filter()
+            .event(flecs::OnRemove)
+            .each([](const BoxCollider2D&, const Rigidbody2D& rb)
+            {
+                if (s_PhysicsWorld && rb.RuntimeBody) DestroyFixtures(rb.RuntimeBody, b2Shape::e_polygon);
+            });
+
+        world->observer<const CircleCollider2D, const Rigidbody2D>("Circle Collider Removed")
+            .term_at(2).self().filter()
+            .event(flecs::OnRemove)
+            .each([](const CircleCollider2D&, const Rigidbody2D& rb)
+            {
+                if (s_PhysicsWorld && rb.RuntimeBody) DestroyFixtures(rb.RuntimeBody, b2Shape::e_circle);
+            });
+
+        world->observer<Rigidbody2D, PhysicsBody2D>("Rigidbody Removed")
+            .term_at(1).self()
+            .term_at(2).self()
+            .event(flecs::OnRemove)
+            .each([](Rigidbody2D& rb, PhysicsBody2D& body)
+            {
+                if (s_PhysicsWorld && body.Body)
+                {
+                    s_PhysicsWorld->DestroyBody(body.Body);
+                }
+
+                body.Body = nullptr;
+                rb.RuntimeBody = nullptr;
+            });
+
+        world->system<const Position, Rigidbody2D>("Sync Physics Bodies")
+            .term_at(2).self()
+            .term<PhysicsBodyDirty>().self()
+            .kind(flecs::OnLoad)
+            .run(World::RunSystem)
+            .each([](flecs::entity e, const Position& pos, Rigidbody2D& rb)
+            {
+                SyncBody(e, pos, rb);
+                e.remove<PhysicsBodyDirty>();
+            })
+            .add(World::GetFixedStepTag());
+    }
     
     void Physics2D::AddImpulse(Rigidbody2D& rb, Vec2 direction, float strength)
     {
@@ -135,5 +558,106 @@ namespace BladeEngine
 
     }
 
+    bool Physics2D::Raycast(Vec2 origin, Vec2 direction, float maxDistance, RaycastHit& hit, const PhysicsQueryFilter& filter)
+    {
+        if (RaycastAll(origin, direction, maxDistance, &hit, 1, filter) == 0)
+        {
+            hit = RaycastHit();
+            return false;
+        }
+
+        return true;
+    }
+
+    uint32_t Physics2D::RaycastAll(Vec2 origin, Vec2 direction, float maxDistance, RaycastHit* hits, uint32_t maxHits,
+        const PhysicsQueryFilter& filter)
+    {
+        const float length = direction.Length();
+        if (!s_PhysicsWorld || maxHits == 0 || maxDistance <= 0.0f || length <= 0.0f)
+        {
+            return 0;
+        }
+
+        const Vec2 end = origin + direction * (maxDistance / length);
+
+        ClosestHitsRaycastCallback callback(filter, maxDistance, hits, maxHits);
+        s_PhysicsWorld->RayCast(&callback, b2Vec2(origin.X, origin.Y), b2Vec2(end.X, end.Y));
+
+        return callback.GetCount();
+    }
+
+    void Physics2D::RaycastBatch(const RaycastQuery* queries, uint32_t count, RaycastHit* hits, uint32_t* hitCounts,
+        uint32_t maxHitsPerQuery)
+    {
+        BLD_PROFILE_FUNCTION();
+
+        const uint32_t groupSize = 64;
+
+        auto castRange = [queries, hits, hitCounts, maxHitsPerQuery](uint32_t begin, uint32_t end)
+        {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const RaycastQuery& query = queries[i];
+                hitCounts[i] = RaycastAll(query.Origin, query.Direction, query.MaxDistance,
+                    hits + (size_t)i * maxHitsPerQuery, maxHitsPerQuery, query.Filter);
+            }
+        };
+
+        // Not worth waking the workers for
+        if (count <= groupSize)
+        {
+            castRange(0, count);
+            return;
+        }
+
+        // Waits for its own groups only, JobSystem::Wait would also wait for unrelated jobs such as texture decodes
+        std::atomic<uint32_t> remainingGroups((count + groupSize - 1) / groupSize);
+
+        JobSystem::Dispatch(count, groupSize, [&castRange, &remainingGroups](uint32_t begin, uint32_t end)
+        {
+            castRange(begin, end);
+            remainingGroups.fetch_sub(1, std::memory_order_release);
+        });
+
+        while (remainingGroups.load(std::memory_order_acquire) > 0)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    uint32_t Physics2D::OverlapBox(Vec2 center, Vec2 halfExtents, flecs::entity* entities, uint32_t maxEntities,
+        const PhysicsQueryFilter& filter)
+    {
+        b2PolygonShape shape;
+        shape.SetAsBox(halfExtents.X, halfExtents.Y);
 
+        return Overlap(shape, center, filter, entities, maxEntities);
+    }
+
+    uint32_t Physics2D::OverlapCircle(Vec2 center, float radius, flecs::entity* entities, uint32_t maxEntities,
+        const PhysicsQueryFilter& filter)
+    {
+        b2CircleShape shape;
+        shape.m_radius = radius;
+
+        return Overlap(shape, center, filter, entities, maxEntities);
+    }
+
+    bool Physics2D::BoxCast(Vec2 origin, Vec2 halfExtents, Vec2 direction, float maxDistance, RaycastHit& hit,
+        const PhysicsQueryFilter& filter)
+    {
+        b2PolygonShape shape;
+        shape.SetAsBox(halfExtents.X, halfExtents.Y);
+
+        return ShapeCast(shape, origin, direction, maxDistance, hit, filter);
+    }
+
+    bool Physics2D::CircleCast(Vec2 origin, float radius, Vec2 direction, float maxDistance, RaycastHit& hit,
+        const PhysicsQueryFilter& filter)
+    {
+        b2CircleShape shape;
+        shape.m_radius = radius;
+
+        return ShapeCast(shape, origin, direction, maxDistance, hit, filter);
+    }
 }
\ No newline at end of file
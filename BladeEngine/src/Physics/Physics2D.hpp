@@ -23,6 +23,32 @@ namespace BladeEngine
         Vec2 Normal;
     };
 
+    // Which colliders a world query can hit
+    struct PhysicsQueryFilter
+    {
+        // PhysicsLayer bits, a collider is hit when one of its CollisionLayers is in the mask
+        uint16_t LayerMask = 0xFFFF;
+        bool IncludeSensors = false;
+    };
+
+    struct RaycastHit
+    {
+        // Not valid when nothing was hit
+        flecs::entity Entity;
+        Vec2 Point;
+        Vec2 Normal;
+        // Along the cast, from its origin
+        float Distance = 0.0f;
+    };
+
+    struct RaycastQuery
+    {
+        Vec2 Origin;
+        Vec2 Direction;
+        float MaxDistance = 0.0f;
+        PhysicsQueryFilter Filter;
+    };
+
     class BaseBodyContactListener
     {
     public:
@@ -62,10 +88,90 @@ namespace BladeEngine
 
         static bool Raycast(Rigidbody2D& rb, Vec2 origin, Vec2 direction, float length, RaycastHitInfo& hitInfo);
 
+        /**
+         * @brief Casts a ray against every collider in the world.
+         * 
+         * World queries read the physics world from any thread, but must not overlap the fixed step.
+         * 
+         * @param origin start of the ray.
+         * @param direction direction of the ray, does not need to be normalized.
+         * @param maxDistance length of the ray.
+         * @param hit closest hit.
+         * @param filter colliders the ray can hit.
+         * @return false if nothing was hit.
+         */
+        static bool Raycast(Vec2 origin, Vec2 direction, float maxDistance, RaycastHit& hit,
+            const PhysicsQueryFilter& filter = PhysicsQueryFilter());
+
+        /**
+         * @brief Casts a ray against every collider in the world and keeps the closest hits.
+         * 
+         * @param hits receives up to maxHits hits, sorted by distance.
+         * @param maxHits size of hits.
+         * @return number of hits written.
+         */
+        static uint32_t RaycastAll(Vec2 origin, Vec2 direction, float maxDistance, RaycastHit* hits, uint32_t maxHits,
+            const PhysicsQueryFilter& filter = PhysicsQueryFilter());
+
+        /**
+         * @brief Casts many rays at once, spread over the job system workers.
+         * 
+         * Blocks until every query is done, so it must not be called from a job. The results of
+         * query i are written to hits[i * maxHitsPerQuery] onwards and their count to hitCounts[i].
+         * 
+         * @param queries rays to cast.
+         * @param count number of queries.
+         * @param hits receives count * maxHitsPerQuery hits.
+         * @param hitCounts receives count hit counts.
+         * @param maxHitsPerQuery closest hits kept per ray, 1 only keeps the closest.
+         */
+        static void RaycastBatch(const RaycastQuery* queries, uint32_t count, RaycastHit* hits, uint32_t* hitCounts,
+            uint32_t maxHitsPerQuery = 1);
+
+        /**
+         * @brief Finds the colliders overlapping an axis aligned box.
+         * 
+         * @param entities receives up to maxEntities entities, each listed once.
+         * @param maxEntities size of entities.
+         * @return number of entities written.
+         */
+        static uint32_t OverlapBox(Vec2 center, Vec2 halfExtents, flecs::entity* entities, uint32_t maxEntities,
+            const PhysicsQueryFilter& filter = PhysicsQueryFilter());
+
+        /**
+         * @brief Finds the colliders overlapping a circle.
+         * 
+         * @param entities receives up to maxEntities entities, each listed once.
+         * @param maxEntities size of entities.
+         * @return number of entities written.
+         */
+        static uint32_t OverlapCircle(Vec2 center, float radius, flecs::entity* entities, uint32_t maxEntities,
+            const PhysicsQueryFilter& filter = PhysicsQueryFilter());
+
+        /**
+         * @brief Sweeps an axis aligned box along a direction and finds the first collider it touches.
+         * 
+         * @param hit closest hit, Point lies on the collider that was hit.
+         * @return false if nothing was hit.
+         */
+        static bool BoxCast(Vec2 origin, Vec2 halfExtents, Vec2 direction, float maxDistance, RaycastHit& hit,
+            const PhysicsQueryFilter& filter = PhysicsQueryFilter());
+
+        /**
+         * @brief Sweeps a circle along a direction and finds the first collider it touches.
+         * 
+         * @param hit closest hit, Point lies on the collider that was hit.
+         * @return false if nothing was hit.
+         */
+        static bool CircleCast(Vec2 origin, float radius, Vec2 direction, float maxDistance, RaycastHit& hit,
+            const PhysicsQueryFilter& filter = PhysicsQueryFilter());
+
     private:
         static void Init();
         static void Shutdown();
 
+        static void RegisterBodyLifecycle();
+
     private:
         static int s_VelocityIterations;
         static int s_PositionIterations;
@@ -1,12 +1,52 @@
 #pragma once
 
-namespace BaldeEngine::Utils 
+#include <chrono>
+#include <cstdint>
+
+namespace BladeEngine::Utils
 {
-    
-    class Timer 
+    /**
+     * @brief Measures the time elapsed since it was created or last reset, on a monotonic clock.
+     *
+     */
+    class Timer
     {
     public:
-        Timer() {}
+        Timer() { Reset(); }
+
+        /**
+         * @brief Restarts the measurement from now.
+         *
+         */
+        void Reset() { m_Start = std::chrono::steady_clock::now(); }
+
+        /**
+         * @brief Time elapsed since the last reset.
+         *
+         * @return elapsed time in nanoseconds.
+         */
+        uint64_t ElapsedNanoseconds() const
+        {
+            return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_Start).count();
+        }
+
+        /**
+         * @brief Time elapsed since the last reset.
+         *
+         * @return elapsed time in milliseconds.
+         */
+        float ElapsedMilliseconds() const { return ElapsedNanoseconds() * 0.000001f; }
+
+        /**
+         * @brief Time elapsed since the last reset.
+         *
+         * @return elapsed time in seconds.
+         */
+        float ElapsedSeconds() const { return ElapsedNanoseconds() * 0.000000001f; }
+
+    private:
+        std::chrono::steady_clock::time_point m_Start;
     };
 
-}
\ No newline at end of file
+}
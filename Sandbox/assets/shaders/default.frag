@@ -1,6 +1,10 @@
 #version 450
 
-layout(binding = 1) uniform sampler2D texureSampler;
+// Specialization constants, constant_id matches the bit of the ShaderFeature
+layout(constant_id = 0) const bool ALPHA_TEST = false;
+layout(constant_id = 1) const bool TINT = false;
+
+layout(set = 1, binding = 0) uniform sampler2D texureSampler;
 
 layout(location = 0) in vec3 fragmentColor;
 layout(location = 1) in vec2 fragmentTextureCoordinate;
@@ -8,11 +12,26 @@ layout(location = 1) in vec2 fragmentTextureCoordinate;
 layout(location = 0) out vec4 outColor;
 
 void main() {
-    
-    outColor = texture(texureSampler, fragmentTextureCoordinate) * vec4(fragmentColor,1);
-    
-    if(outColor.w <= 0)
+    vec4 color = texture(texureSampler, fragmentTextureCoordinate);
+
+    if (TINT)
+    {
+        color *= vec4(fragmentColor, 1);
+    }
+
+    if (ALPHA_TEST)
+    {
+        // Drawn without blending, only fully covered texels are written
+        if (color.w < 0.5)
+        {
+            discard;
+        }
+        color.w = 1.0;
+    }
+    else if (color.w <= 0)
     {
         discard;
     }
+
+    outColor = color;
 }
@@ -1,13 +1,12 @@
 #version 450
 
-layout(binding = 0) uniform MVP{
-  mat4 model;
-  mat4 view;
-  mat4 proj;
-} mvp;
+layout(set = 0, binding = 0) uniform Camera{
+  mat4 viewProjection;
+} camera;
 
 layout (push_constant) uniform PushConstantData
 {
+  mat4 model;
   vec4 uvTransform;
 } extraData;
 
@@ -19,7 +18,7 @@ layout(location = 0) out vec3 fragmentColor;
 layout(location = 1) out vec2 fragmentTextureCoordinate;
 
 void main() {
-  gl_Position = mvp.proj * mvp.view * mvp.model * vec4(inPosition, 1.0);
+  gl_Position = camera.viewProjection * extraData.model * vec4(inPosition, 1.0);
 
   fragmentColor = inColor;
   fragmentTextureCoordinate = inTextureCoordinate * extraData.uvTransform.zw + extraData.uvTransform.xy;
@@ -1,6 +1,10 @@
 #version 450
 
-layout(binding = 1) uniform sampler2D msdf;
+// Specialization constants, constant_id matches the bit of the ShaderFeature
+layout(constant_id = 1) const bool TINT = false;
+layout(constant_id = 2) const bool OUTLINE = false;
+
+layout(set = 1, binding = 0) uniform sampler2D msdf;
 
 layout(location = 0) in vec4 fragmentColor;
 layout(location = 1) in vec2 fragmentTextureCoordinate;
@@ -24,9 +28,23 @@ void main()
 {
     vec3 msd = texture(msdf, fragmentTextureCoordinate).rgb;
     float sd = median(msd.r, msd.g, msd.b);
-    float screenPxDistance = screenPxRange()*(sd - 0.5);
-    float opacity = clamp(screenPxDistance + 0.5, 0.0, 1.0);
+    float pxRange = screenPxRange();
+    float opacity = clamp(pxRange*(sd - 0.5) + 0.5, 0.0, 1.0);
+
+    vec4 color = TINT ? fragmentColor : vec4(1.0);
+
+    if (OUTLINE)
+    {
+        // Dark band around the glyph, a bit further out along the distance field
+        const float outlineDistance = 0.3;
+        float outlineOpacity = clamp(pxRange*(sd - outlineDistance) + 0.5, 0.0, 1.0);
+        if (outlineOpacity == 0.0) discard;
+
+        outColor = mix(vec4(0.0, 0.0, 0.0, outlineOpacity * color.a), color, opacity);
+        return;
+    }
+
     if (opacity == 0.0) discard;
 
-    outColor = mix(vec4(0.0), fragmentColor, opacity);
+    outColor = mix(vec4(0.0), color, opacity);
 }
@@ -0,0 +1,38 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform Camera{
+  mat4 viewProjection;
+} camera;
+
+struct SpriteInstance
+{
+  vec4 basis;
+  vec2 translation;
+  uint tint;
+  uint depthTexture;
+  vec4 uvRect;
+};
+
+layout(std430, set = 0, binding = 1) readonly buffer SpriteInstances{
+  SpriteInstance instances[];
+} spriteInstances;
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 2) in vec2 inTextureCoordinate;
+
+layout(location = 0) out vec4 fragmentColor;
+layout(location = 1) out vec2 fragmentTextureCoordinate;
+layout(location = 2) flat out uint fragmentTextureIndex;
+
+void main() {
+  SpriteInstance instance = spriteInstances.instances[gl_InstanceIndex];
+
+  vec2 position = instance.basis.xy * inPosition.x + instance.basis.zw * inPosition.y + instance.translation;
+  float depth = unpackHalf2x16(instance.depthTexture).y;
+
+  gl_Position = camera.viewProjection * vec4(position, depth, 1.0);
+
+  fragmentColor = unpackUnorm4x8(instance.tint);
+  fragmentTextureCoordinate = inTextureCoordinate * instance.uvRect.zw + instance.uvRect.xy;
+  fragmentTextureIndex = instance.depthTexture & 0xFFFFu;
+}
@@ -0,0 +1,37 @@
+#version 450
+
+// Specialization constants, constant_id matches the bit of the ShaderFeature
+layout(constant_id = 0) const bool ALPHA_TEST = false;
+layout(constant_id = 1) const bool TINT = false;
+
+layout(set = 1, binding = 0) uniform sampler2D texureSampler;
+
+layout(location = 0) in vec4 fragmentColor;
+layout(location = 1) in vec2 fragmentTextureCoordinate;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    vec4 color = texture(texureSampler, fragmentTextureCoordinate);
+
+    if (TINT)
+    {
+        color *= fragmentColor;
+    }
+
+    if (ALPHA_TEST)
+    {
+        // Drawn without blending, only fully covered texels are written
+        if (color.w < 0.5)
+        {
+            discard;
+        }
+        color.w = 1.0;
+    }
+    else if (color.w <= 0)
+    {
+        discard;
+    }
+
+    outColor = color;
+}
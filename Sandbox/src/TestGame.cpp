@@ -3,6 +3,8 @@
 #include "BladeEngine.hpp"
 
 #include "Graphics/SpriteSheet.hpp"
+#include "Graphics/TextureAtlas.hpp"
+#include "Graphics/TextureLoader.hpp"
 #include "Audio/AudioClip.hpp"
 #include "Audio/AudioManager.hpp"
 #include "Audio/AudioSource.hpp"
@@ -38,11 +40,10 @@ namespace BladeEngine {
 
 	struct Player {};
 
-	Graphics::Texture2D* g_TextureChickBoy;
-	Graphics::Texture2D* g_TexturePlatformBlock;
-	std::vector<Graphics::Texture2D*> g_BackgroundTextures;
+	Graphics::TextureAtlas* g_PropsAtlas;
+	std::vector<Graphics::TextureHandle> g_BackgroundTextures;
 
-	Graphics::Texture2D* g_TexturePlayerIdle;
+	Graphics::TextureHandle g_TexturePlayerIdle;
 	Graphics::SpriteSheet* g_SpriteSheetPlayerIdle;
 
 	AudioClip* jumpClip;
@@ -62,33 +63,34 @@ namespace BladeEngine {
 		samplerConfig.Filter = SamplerFilter::Nearest;
 		samplerConfig.AdressMode = SamplerAddressMode::ClampToEdges;
 
-		g_TextureChickBoy =
-			new Texture2D("assets/sprites/Chick-Boy Free Pack/tile000.png");
-		g_TextureChickBoy->SetSamplerConfiguration(samplerConfig);
-		g_TextureChickBoy->CreateGPUTexture();
+		// Small sprites share one atlas page so they batch together, the packed page is cached on disk
+		TextureAtlasConfiguration atlasConfig;
+		atlasConfig.SamplerConfig = samplerConfig;
+		atlasConfig.CachePath = "cache/props.atlas";
 
-		g_TexturePlatformBlock =
-			new Texture2D("assets/sprites/Sunny-land-assets-files/PNG/"
-				"environment/props/block-big.png");
-		g_TexturePlatformBlock->SetSamplerConfiguration(samplerConfig);
-		g_TexturePlatformBlock->CreateGPUTexture();
+		g_PropsAtlas = new TextureAtlas(atlasConfig);
+		g_PropsAtlas->AddFile("assets/sprites/Chick-Boy Free Pack/tile000.png", "chick-boy");
+		g_PropsAtlas->AddFile("assets/sprites/Sunny-land-assets-files/PNG/environment/props/block-big.png", "block-big");
+		g_PropsAtlas->Build();
 
-		g_TexturePlayerIdle = new Texture2D("assets/sprites/Sunny-land-assets-files/PNG/spritesheets/player-idle.png");
-		g_TexturePlayerIdle->SetSamplerConfiguration(samplerConfig);
-		g_TexturePlayerIdle->CreateGPUTexture();
+		g_TexturePlayerIdle = TextureLoader::LoadAsync(
+			"assets/sprites/Sunny-land-assets-files/PNG/spritesheets/player-idle.png", samplerConfig);
 
-		g_SpriteSheetPlayerIdle = new SpriteSheet(g_TexturePlayerIdle, 33, 32);
+		// The parallax layers are the largest textures and get minified the most when the camera zooms out
+		Texture2D::SamplerConfiguration backgroundSamplerConfig = samplerConfig;
+		backgroundSamplerConfig.GenerateMipmaps = true;
 
 		g_BackgroundTextures.resize(6);
 		for (size_t i = 0; i < 6; i++) {
 			std::stringstream path;
 			path << "assets/sprites/PineForestParallax/MorningLayer" << i + 1 << ".png";
 
-			Texture2D* tex = new Texture2D(path.str().c_str());
-			g_BackgroundTextures[i] = tex;
-			g_BackgroundTextures[i]->SetSamplerConfiguration(samplerConfig);
-			g_BackgroundTextures[i]->CreateGPUTexture();
+			g_BackgroundTextures[i] = TextureLoader::LoadAsync(path.str(), backgroundSamplerConfig);
 		}
+
+		// The sprite sheet is cut from the texture size, the other textures keep decoding meanwhile
+		g_TexturePlayerIdle.Wait();
+		g_SpriteSheetPlayerIdle = new SpriteSheet(g_TexturePlayerIdle.GetTexture(), 33, 32);
 	}
 
 	void LoadAudioClips() {
@@ -109,15 +111,15 @@ namespace BladeEngine {
 
 	void UnloadTextures() 
 	{
-		delete g_TextureChickBoy;
-		g_TextureChickBoy = nullptr;
-
-		delete g_TexturePlatformBlock;
-		g_TexturePlatformBlock = nullptr;
+		using namespace Graphics;
 
-		delete g_TexturePlayerIdle;
-		g_TexturePlayerIdle = nullptr;
+		delete g_PropsAtlas;
+		TextureLoader::Unload(g_TexturePlayerIdle);
 
+		for (TextureHandle& texture : g_BackgroundTextures)
+		{
+			TextureLoader::Unload(texture);
+		}
 		g_BackgroundTextures.clear();
 	}
 
@@ -156,7 +158,7 @@ namespace BladeEngine {
 	void MovePlatform(flecs::entity e, const MovingPlatform& movingPlatform, Position& pos)
 	{
 		pos.Value = movingPlatform.Anchor + 
-			sinf(Time::CurrentWorldTime() * movingPlatform.Frequency) 
+			sinf(Time::FixedWorldTime() * movingPlatform.Frequency) 
 			* movingPlatform.Movement;
 	}
 
@@ -226,7 +228,7 @@ namespace BladeEngine {
 			.set_override<Scale>({ { 1.0f, 1.0f } })
 			.set_override<Rigidbody2D>({ })
 			.add<BoxCollider2D>()
-			.set<SpriteRenderer>({ g_TexturePlatformBlock });
+			.set<SpriteRenderer>(g_PropsAtlas->GetSprite("block-big"));
 
 		blockPrefab.get_mut<BoxCollider2D>()->HalfExtents = { 0.5f, 0.5f };
 
@@ -249,7 +251,7 @@ namespace BladeEngine {
 					.set_override<Position>({ { -numOfBlocks * 0.5f + 0.5f + i, 0.0f } })
 					.set_override<Rotation>({ 0.0f })
 					.set_override<Scale>({ {1.0f, 1.0f} })
-					.set<SpriteRenderer>({ g_TexturePlatformBlock });
+					.set<SpriteRenderer>(g_PropsAtlas->GetSprite("block-big"));
 			}
 
 		auto smallPlatform = World::GetECSWorldHandle()->prefab("Platform Small")
@@ -271,7 +273,7 @@ namespace BladeEngine {
 					.set_override<Position>({ { -numOfBlocks * 0.5f + 0.5f + i, 0.0f } })
 					.set_override<Rotation>({ 0.0f })
 					.set_override<Scale>({ {1.0f, 1.0f} })
-					.set<SpriteRenderer>({ g_TexturePlatformBlock });
+					.set<SpriteRenderer>(g_PropsAtlas->GetSprite("block-big"));
 			}
 			
 
@@ -291,7 +293,7 @@ namespace BladeEngine {
 			.set<Position>({ { 0.0f, 0.0f } })
 			.set<Rotation>({ 0.0f })
 			.set<Scale>({ { 1.0f, 1.0f } })
-			.set<SpriteRenderer>({ g_TextureChickBoy })
+			.set<SpriteRenderer>(g_PropsAtlas->GetSprite("chick-boy"))
 			.add<Rigidbody2D>()
 			.add<BoxCollider2D>();
 
@@ -323,7 +325,7 @@ namespace BladeEngine {
 		playerRB->ContactListener = new GroundedContactListener();
 		player.add<CircleCollider2D>();
 
-		player.set<SpriteRenderer>({ g_TextureChickBoy });
+		player.set<SpriteRenderer>(g_PropsAtlas->GetSprite("chick-boy"));
 
 		player.add<SpriteAnimator>();
 		auto anim = player.get_mut<SpriteAnimator>();
@@ -346,7 +348,7 @@ namespace BladeEngine {
 			background.AddComponent<LocalToWorld>();
 			background.SetComponent<DepthSorting>({ -10.0f });
 
-			background.SetComponent<SpriteRenderer>({ g_BackgroundTextures[i] });
+			background.SetComponent<SpriteRenderer>({ g_BackgroundTextures[i].GetTexture() });
 		}
 
 
@@ -356,10 +358,10 @@ namespace BladeEngine {
 		someText.SetComponent<Position>({ { -15.0f, 7.0f } });
 		someText.SetComponent<Rotation>({ 0.0f });
 		someText.SetComponent<Scale>({ { 2.0f, 2.0f } });
-		someText.SetComponent<TextRenderer>({ g_OpenSansRegular, "Count: 0" });
+		someText.SetComponent<TextRenderer>({ g_OpenSansRegular, "Count: 0", true });
 		someText.AddComponent<FallCountText>();
 
-		World::BindSystem<const MovingPlatform, Position>(flecs::OnUpdate, "Move Platform", MovePlatform);
+		World::BindFixedSystem<const MovingPlatform, Position>(flecs::OnUpdate, "Move Platform", MovePlatform);
 		World::BindSystem<const Controller, Rigidbody2D, const Position>(
 			flecs::OnUpdate, "Move", Move);
 
@@ -0,0 +1,873 @@
+#include "BlockEncoders.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace BladeEngine::Tools {
+
+	static int Clamp255(int value)
+	{
+		return std::min(std::max(value, 0), 255);
+	}
+
+	static int SquaredDistance(const int* a, const uint8_t* b, int channels)
+	{
+		int distance = 0;
+		for (int c = 0; c < channels; c++)
+		{
+			int d = a[c] - b[c];
+			distance += d * d;
+		}
+
+		return distance;
+	}
+
+	// Principal axis of the pixels through their mean, by power iteration on the covariance matrix.
+	// Returns false when the pixels are all the same color
+	static bool FitLine(const uint8_t* pixels, const bool* mask, int channels, float* mean, float* axis)
+	{
+		int count = 0;
+		for (int c = 0; c < channels; c++)
+		{
+			mean[c] = 0.0f;
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			if (mask && !mask[i])
+			{
+				continue;
+			}
+
+			for (int c = 0; c < channels; c++)
+			{
+				mean[c] += pixels[i * 4 + c];
+			}
+			count++;
+		}
+
+		if (count == 0)
+		{
+			return false;
+		}
+
+		for (int c = 0; c < channels; c++)
+		{
+			mean[c] /= count;
+		}
+
+		float covariance[4][4] = {};
+		for (int i = 0; i < 16; i++)
+		{
+			if (mask && !mask[i])
+			{
+				continue;
+			}
+
+			for (int a = 0; a < channels; a++)
+			{
+				for (int b = 0; b < channels; b++)
+				{
+					covariance[a][b] += (pixels[i * 4 + a] - mean[a]) * (pixels[i * 4 + b] - mean[b]);
+				}
+			}
+		}
+
+		for (int c = 0; c < channels; c++)
+		{
+			axis[c] = 1.0f;
+		}
+
+		for (int iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4] = {};
+			float length = 0.0f;
+			for (int a = 0; a < channels; a++)
+			{
+				for (int b = 0; b < channels; b++)
+				{
+					next[a] += covariance[a][b] * axis[b];
+				}
+				length += next[a] * next[a];
+			}
+
+			length = std::sqrt(length);
+			if (length < 1e-6f)
+			{
+				return false;
+			}
+
+			for (int c = 0; c < channels; c++)
+			{
+				axis[c] = next[c] / length;
+			}
+		}
+
+		return true;
+	}
+
+	// Endpoints at the extreme projections of the pixels on their principal axis
+	static void FitEndpoints(const uint8_t* pixels, const bool* mask, int channels, float* start, float* end)
+	{
+		float mean[4], axis[4];
+		if (!FitLine(pixels, mask, channels, mean, axis))
+		{
+			for (int c = 0; c < channels; c++)
+			{
+				start[c] = end[c] = mean[c];
+			}
+			return;
+		}
+
+		float minT = 1e9f, maxT = -1e9f;
+		for (int i = 0; i < 16; i++)
+		{
+			if (mask && !mask[i])
+			{
+				continue;
+			}
+
+			float t = 0.0f;
+			for (int c = 0; c < channels; c++)
+			{
+				t += (pixels[i * 4 + c] - mean[c]) * axis[c];
+			}
+
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		for (int c = 0; c < channels; c++)
+		{
+			start[c] = std::min(std::max(mean[c] + axis[c] * maxT, 0.0f), 255.0f);
+			end[c] = std::min(std::max(mean[c] + axis[c] * minT, 0.0f), 255.0f);
+		}
+	}
+
+	// BC1
+
+	static uint16_t To565(const float* color)
+	{
+		int r = (int)(color[0] * 31.0f / 255.0f + 0.5f);
+		int g = (int)(color[1] * 63.0f / 255.0f + 0.5f);
+		int b = (int)(color[2] * 31.0f / 255.0f + 0.5f);
+		return (uint16_t)((r << 11) | (g << 5) | b);
+	}
+
+	static void From565(uint16_t color, int* rgb)
+	{
+		int r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+		rgb[0] = (r << 3) | (r >> 2);
+		rgb[1] = (g << 2) | (g >> 4);
+		rgb[2] = (b << 3) | (b >> 2);
+	}
+
+	static void WriteColorBlock(uint16_t color0, uint16_t color1, uint32_t indices, uint8_t* block)
+	{
+		block[0] = (uint8_t)(color0 & 0xFF);
+		block[1] = (uint8_t)(color0 >> 8);
+		block[2] = (uint8_t)(color1 & 0xFF);
+		block[3] = (uint8_t)(color1 >> 8);
+		for (int i = 0; i < 4; i++)
+		{
+			block[4 + i] = (uint8_t)(indices >> (i * 8));
+		}
+	}
+
+	static void EncodeColorBlock(const uint8_t* pixels, bool allowTransparency, uint8_t* block)
+	{
+		bool opaque[16];
+		bool hasTransparent = false;
+		for (int i = 0; i < 16; i++)
+		{
+			opaque[i] = !allowTransparency || pixels[i * 4 + 3] >= 128;
+			hasTransparent |= !opaque[i];
+		}
+
+		float start[3], end[3];
+
+		if (!hasTransparent)
+		{
+			FitEndpoints(pixels, nullptr, 3, start, end);
+
+			uint16_t color0 = To565(start);
+			uint16_t color1 = To565(end);
+
+			// The 4 color mode is selected by color0 > color1
+			if (color0 < color1)
+			{
+				std::swap(color0, color1);
+			}
+
+			if (color0 == color1)
+			{
+				WriteColorBlock(color0, color1, 0, block);
+				return;
+			}
+
+			int palette[4][3];
+			From565(color0, palette[0]);
+			From565(color1, palette[1]);
+			for (int c = 0; c < 3; c++)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			uint32_t indices = 0;
+			for (int i = 0; i < 16; i++)
+			{
+				int best = 0, bestDistance = SquaredDistance(palette[0], pixels + i * 4, 3);
+				for (int p = 1; p < 4; p++)
+				{
+					int distance = SquaredDistance(palette[p], pixels + i * 4, 3);
+					if (distance < bestDistance)
+					{
+						best = p;
+						bestDistance = distance;
+					}
+				}
+
+				indices |= (uint32_t)best << (i * 2);
+			}
+
+			WriteColorBlock(color0, color1, indices, block);
+			return;
+		}
+
+		// 3 color mode, index 3 is transparent black and only the opaque pixels are fitted
+		FitEndpoints(pixels, opaque, 3, start, end);
+
+		uint16_t color0 = To565(start);
+		uint16_t color1 = To565(end);
+		if (color0 > color1)
+		{
+			std::swap(color0, color1);
+		}
+
+		int palette[3][3];
+		From565(color0, palette[0]);
+		From565(color1, palette[1]);
+		for (int c = 0; c < 3; c++)
+		{
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+		}
+
+		uint32_t indices = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			int best = 3;
+			if (opaque[i])
+			{
+				int bestDistance = SquaredDistance(palette[0], pixels + i * 4, 3);
+				best = 0;
+				for (int p = 1; p < 3; p++)
+				{
+					int distance = SquaredDistance(palette[p], pixels + i * 4, 3);
+					if (distance < bestDistance)
+					{
+						best = p;
+						bestDistance = distance;
+					}
+				}
+			}
+
+			indices |= (uint32_t)best << (i * 2);
+		}
+
+		WriteColorBlock(color0, color1, indices, block);
+	}
+
+	void EncodeBC1(const uint8_t* pixels, uint8_t* block)
+	{
+		EncodeColorBlock(pixels, true, block);
+	}
+
+	// BC3
+
+	static void EncodeAlphaBlock(const uint8_t* pixels, uint8_t* block)
+	{
+		int minAlpha = 255, maxAlpha = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			minAlpha = std::min(minAlpha, (int)pixels[i * 4 + 3]);
+			maxAlpha = std::max(maxAlpha, (int)pixels[i * 4 + 3]);
+		}
+
+		// 8 value mode, alpha0 > alpha1 and 6 values interpolated between them
+		int alpha0 = maxAlpha, alpha1 = minAlpha;
+
+		int palette[8] = { alpha0, alpha1 };
+		for (int i = 2; i < 8; i++)
+		{
+			palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7;
+		}
+
+		uint64_t indices = 0;
+		if (alpha0 != alpha1)
+		{
+			for (int i = 0; i < 16; i++)
+			{
+				int alpha = pixels[i * 4 + 3];
+				int best = 0, bestDistance = std::abs(palette[0] - alpha);
+				for (int p = 1; p < 8; p++)
+				{
+					int distance = std::abs(palette[p] - alpha);
+					if (distance < bestDistance)
+					{
+						best = p;
+						bestDistance = distance;
+					}
+				}
+
+				indices |= (uint64_t)best << (i * 3);
+			}
+		}
+
+		block[0] = (uint8_t)alpha0;
+		block[1] = (uint8_t)alpha1;
+		for (int i = 0; i < 6; i++)
+		{
+			block[2 + i] = (uint8_t)(indices >> (i * 8));
+		}
+	}
+
+	void EncodeBC3(const uint8_t* pixels, uint8_t* block)
+	{
+		EncodeAlphaBlock(pixels, block);
+		EncodeColorBlock(pixels, false, block + 8);
+	}
+
+	// BC7
+
+	static const int s_BC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	struct BitWriter
+	{
+		uint8_t* Data;
+		int Position = 0;
+
+		void Write(uint32_t value, int bits)
+		{
+			for (int i = 0; i < bits; i++, Position++)
+			{
+				if (value & (1u << i))
+				{
+					Data[Position / 8] |= (uint8_t)(1 << (Position % 8));
+				}
+			}
+		}
+	};
+
+	static const int s_BC7Weights2[4] = { 0, 21, 43, 64 };
+
+	static int BC7Interpolate(int value0, int value1, int weight)
+	{
+		return ((64 - weight) * value0 + weight * value1 + 32) >> 6;
+	}
+
+	// Mode 6: one RGBA line with 7 bit endpoints plus a shared low bit each, 4 bit indices
+	static int EncodeBC7Mode6(const uint8_t* pixels, uint8_t* block)
+	{
+		float start[4], end[4];
+		FitEndpoints(pixels, nullptr, 4, start, end);
+
+		int bestError = -1;
+		int bestEndpoints[2][4] = {};
+		int bestPBits[2] = {};
+		int bestIndices[16] = {};
+
+		// The endpoint's lowest bit is shared by its 4 channels, try every combination
+		for (int pBits = 0; pBits < 4; pBits++)
+		{
+			int pBit[2] = { pBits & 1, pBits >> 1 };
+
+			int endpoints[2][4];
+			int palette[16][4];
+			for (int c = 0; c < 4; c++)
+			{
+				endpoints[0][c] = std::min(std::max((int)std::lround((start[c] - pBit[0]) / 2.0f), 0), 127);
+				endpoints[1][c] = std::min(std::max((int)std::lround((end[c] - pBit[1]) / 2.0f), 0), 127);
+
+				int value0 = (endpoints[0][c] << 1) | pBit[0];
+				int value1 = (endpoints[1][c] << 1) | pBit[1];
+				for (int i = 0; i < 16; i++)
+				{
+					palette[i][c] = BC7Interpolate(value0, value1, s_BC7Weights4[i]);
+				}
+			}
+
+			int error = 0;
+			int indices[16];
+			for (int i = 0; i < 16; i++)
+			{
+				int best = 0, bestDistance = SquaredDistance(palette[0], pixels + i * 4, 4);
+				for (int p = 1; p < 16; p++)
+				{
+					int distance = SquaredDistance(palette[p], pixels + i * 4, 4);
+					if (distance < bestDistance)
+					{
+						best = p;
+						bestDistance = distance;
+					}
+				}
+
+				indices[i] = best;
+				error += bestDistance;
+			}
+
+			if (bestError < 0 || error < bestError)
+			{
+				bestError = error;
+				memcpy(bestEndpoints, endpoints, sizeof(endpoints));
+				memcpy(bestPBits, pBit, sizeof(pBit));
+				memcpy(bestIndices, indices, sizeof(indices));
+			}
+		}
+
+		// The first index is stored without its top bit, swap the endpoints when it is set
+		if (bestIndices[0] >= 8)
+		{
+			for (int c = 0; c < 4; c++)
+			{
+				std::swap(bestEndpoints[0][c], bestEndpoints[1][c]);
+			}
+			std::swap(bestPBits[0], bestPBits[1]);
+
+			for (int i = 0; i < 16; i++)
+			{
+				bestIndices[i] = 15 - bestIndices[i];
+			}
+		}
+
+		memset(block, 0, 16);
+
+		BitWriter writer = { block };
+		writer.Write(1 << 6, 7);
+		for (int c = 0; c < 4; c++)
+		{
+			writer.Write(bestEndpoints[0][c], 7);
+			writer.Write(bestEndpoints[1][c], 7);
+		}
+		writer.Write(bestPBits[0], 1);
+		writer.Write(bestPBits[1], 1);
+		for (int i = 0; i < 16; i++)
+		{
+			writer.Write(bestIndices[i], i == 0 ? 3 : 4);
+		}
+
+		return bestError;
+	}
+
+	// Mode 5: separate RGB and alpha lines with 2 bit indices each, for blocks mixing
+	// transparent pixels with several opaque colors that no single RGBA line goes through
+	static int EncodeBC7Mode5(const uint8_t* pixels, uint8_t* block)
+	{
+		float start[3], end[3];
+		FitEndpoints(pixels, nullptr, 3, start, end);
+
+		int colorEndpoints[2][3];
+		int colorPalette[4][3];
+		for (int c = 0; c < 3; c++)
+		{
+			colorEndpoints[0][c] = std::min(std::max((int)std::lround(start[c] * 127.0f / 255.0f), 0), 127);
+			colorEndpoints[1][c] = std::min(std::max((int)std::lround(end[c] * 127.0f / 255.0f), 0), 127);
+
+			int value0 = (colorEndpoints[0][c] << 1) | (colorEndpoints[0][c] >> 6);
+			int value1 = (colorEndpoints[1][c] << 1) | (colorEndpoints[1][c] >> 6);
+			for (int i = 0; i < 4; i++)
+			{
+				colorPalette[i][c] = BC7Interpolate(value0, value1, s_BC7Weights2[i]);
+			}
+		}
+
+		int alphaEndpoints[2] = { 0, 255 };
+		for (int i = 0; i < 16; i++)
+		{
+			alphaEndpoints[0] = std::max(alphaEndpoints[0], (int)pixels[i * 4 + 3]);
+			alphaEndpoints[1] = std::min(alphaEndpoints[1], (int)pixels[i * 4 + 3]);
+		}
+
+		int alphaPalette[4];
+		for (int i = 0; i < 4; i++)
+		{
+			alphaPalette[i] = BC7Interpolate(alphaEndpoints[0], alphaEndpoints[1], s_BC7Weights2[i]);
+		}
+
+		int error = 0;
+		int colorIndices[16], alphaIndices[16];
+		for (int i = 0; i < 16; i++)
+		{
+			const uint8_t* pixel = pixels + i * 4;
+
+			int best = 0, bestDistance = SquaredDistance(colorPalette[0], pixel, 3);
+			for (int p = 1; p < 4; p++)
+			{
+				int distance = SquaredDistance(colorPalette[p], pixel, 3);
+				if (distance < bestDistance)
+				{
+					best = p;
+					bestDistance = distance;
+				}
+			}
+			colorIndices[i] = best;
+			error += bestDistance;
+
+			best = 0;
+			bestDistance = std::abs(alphaPalette[0] - pixel[3]);
+			for (int p = 1; p < 4; p++)
+			{
+				int distance = std::abs(alphaPalette[p] - pixel[3]);
+				if (distance < bestDistance)
+				{
+					best = p;
+					bestDistance = distance;
+				}
+			}
+			alphaIndices[i] = best;
+			error += bestDistance * bestDistance;
+		}
+
+		if (colorIndices[0] >= 2)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				std::swap(colorEndpoints[0][c], colorEndpoints[1][c]);
+			}
+			for (int i = 0; i < 16; i++)
+			{
+				colorIndices[i] = 3 - colorIndices[i];
+			}
+		}
+
+		if (alphaIndices[0] >= 2)
+		{
+			std::swap(alphaEndpoints[0], alphaEndpoints[1]);
+			for (int i = 0; i < 16; i++)
+			{
+				alphaIndices[i] = 3 - alphaIndices[i];
+			}
+		}
+
+		memset(block, 0, 16);
+
+		BitWriter writer = { block };
+		writer.Write(1 << 5, 6);
+		// No channel rotation
+		writer.Write(0, 2);
+		for (int c = 0; c < 3; c++)
+		{
+			writer.Write(colorEndpoints[0][c], 7);
+			writer.Write(colorEndpoints[1][c], 7);
+		}
+		writer.Write(alphaEndpoints[0], 8);
+		writer.Write(alphaEndpoints[1], 8);
+		for (int i = 0; i < 16; i++)
+		{
+			writer.Write(colorIndices[i], i == 0 ? 1 : 2);
+		}
+		for (int i = 0; i < 16; i++)
+		{
+			writer.Write(alphaIndices[i], i == 0 ? 1 : 2);
+		}
+
+		return error;
+	}
+
+	void EncodeBC7(const uint8_t* pixels, uint8_t* block)
+	{
+		uint8_t mode5[16];
+		int mode5Error = EncodeBC7Mode5(pixels, mode5);
+		int mode6Error = EncodeBC7Mode6(pixels, block);
+
+		if (mode5Error < mode6Error)
+		{
+			memcpy(block, mode5, 16);
+		}
+	}
+
+	// ETC2
+
+	static const int s_ETCModifiers[8][2] = {
+		{ 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 }
+	};
+
+	static const int s_EACModifiers[16][8] = {
+		{ -3, -6, -9, -15, 2, 5, 8, 14 },
+		{ -3, -7, -10, -13, 2, 6, 9, 12 },
+		{ -2, -5, -8, -13, 1, 4, 7, 12 },
+		{ -2, -4, -6, -13, 1, 3, 5, 12 },
+		{ -3, -6, -8, -12, 2, 5, 7, 11 },
+		{ -3, -7, -9, -11, 2, 6, 8, 10 },
+		{ -4, -7, -8, -11, 3, 6, 7, 10 },
+		{ -3, -5, -8, -11, 2, 4, 7, 10 },
+		{ -2, -6, -8, -10, 1, 5, 7, 9 },
+		{ -2, -5, -8, -10, 1, 4, 7, 9 },
+		{ -2, -4, -8, -10, 1, 3, 7, 9 },
+		{ -2, -5, -7, -10, 1, 4, 6, 9 },
+		{ -3, -4, -7, -10, 2, 3, 6, 9 },
+		{ -1, -2, -3, -10, 0, 1, 2, 9 },
+		{ -4, -6, -8, -9, 3, 5, 7, 8 },
+		{ -3, -5, -7, -9, 2, 4, 6, 8 }
+	};
+
+	static void WriteBigEndian(uint64_t value, uint8_t* block)
+	{
+		for (int i = 0; i < 8; i++)
+		{
+			block[i] = (uint8_t)(value >> (56 - i * 8));
+		}
+	}
+
+	struct ETCSubblock
+	{
+		int Table;
+		// Pixel indices, bit 1 selects the negative modifier and bit 0 the larger one
+		int Indices[8];
+		int Error;
+	};
+
+	// Pixels of subblock 0 or 1, ETC numbers pixels column major
+	static void GetSubblockPixels(bool flip, int subblock, int* pixelIndices)
+	{
+		int n = 0;
+		for (int x = 0; x < 4; x++)
+		{
+			for (int y = 0; y < 4; y++)
+			{
+				int coordinate = flip ? y : x;
+				if ((coordinate >= 2) == (subblock == 1))
+				{
+					pixelIndices[n++] = x * 4 + y;
+				}
+			}
+		}
+	}
+
+	static ETCSubblock FitSubblockTable(const uint8_t* pixels, const int* pixelIndices, const int* base)
+	{
+		ETCSubblock best = {};
+		best.Error = -1;
+
+		for (int table = 0; table < 8; table++)
+		{
+			ETCSubblock candidate = {};
+			candidate.Table = table;
+
+			for (int n = 0; n < 8; n++)
+			{
+				int j = pixelIndices[n];
+				const uint8_t* pixel = pixels + ((j % 4) * 4 + j / 4) * 4;
+
+				int bestIndex = 0, bestDistance = -1;
+				for (int index = 0; index < 4; index++)
+				{
+					int modifier = s_ETCModifiers[table][index & 1] * ((index & 2) ? -1 : 1);
+					int color[3] = { Clamp255(base[0] + modifier), Clamp255(base[1] + modifier), Clamp255(base[2] + modifier) };
+
+					int distance = SquaredDistance(color, pixel, 3);
+					if (bestDistance < 0 || distance < bestDistance)
+					{
+						bestIndex = index;
+						bestDistance = distance;
+					}
+				}
+
+				candidate.Indices[n] = bestIndex;
+				candidate.Error += bestDistance;
+			}
+
+			if (best.Error < 0 || candidate.Error < best.Error)
+			{
+				best = candidate;
+			}
+		}
+
+		return best;
+	}
+
+	void EncodeETC2RGB(const uint8_t* pixels, uint8_t* block)
+	{
+		uint64_t bestBits = 0;
+		int bestError = -1;
+
+		for (int flip = 0; flip < 2; flip++)
+		{
+			int pixelIndices[2][8];
+			float average[2][3] = {};
+
+			for (int s = 0; s < 2; s++)
+			{
+				GetSubblockPixels(flip, s, pixelIndices[s]);
+				for (int n = 0; n < 8; n++)
+				{
+					int j = pixelIndices[s][n];
+					const uint8_t* pixel = pixels + ((j % 4) * 4 + j / 4) * 4;
+					for (int c = 0; c < 3; c++)
+					{
+						average[s][c] += pixel[c] / 8.0f;
+					}
+				}
+			}
+
+			for (int differential = 0; differential < 2; differential++)
+			{
+				int quantized[2][3], base[2][3];
+				bool valid = true;
+
+				for (int s = 0; s < 2; s++)
+				{
+					for (int c = 0; c < 3; c++)
+					{
+						if (differential)
+						{
+							quantized[s][c] = (int)(average[s][c] * 31.0f / 255.0f + 0.5f);
+							base[s][c] = (quantized[s][c] << 3) | (quantized[s][c] >> 2);
+						}
+						else
+						{
+							quantized[s][c] = (int)(average[s][c] * 15.0f / 255.0f + 0.5f);
+							base[s][c] = quantized[s][c] * 17;
+						}
+					}
+				}
+
+				// Out of range deltas select the ETC2 T, H and planar modes instead
+				int delta[3];
+				for (int c = 0; c < 3 && differential; c++)
+				{
+					delta[c] = quantized[1][c] - quantized[0][c];
+					valid &= delta[c] >= -4 && delta[c] <= 3;
+				}
+
+				if (!valid)
+				{
+					continue;
+				}
+
+				ETCSubblock subblocks[2] = {
+					FitSubblockTable(pixels, pixelIndices[0], base[0]),
+					FitSubblockTable(pixels, pixelIndices[1], base[1])
+				};
+
+				int error = subblocks[0].Error + subblocks[1].Error;
+				if (bestError >= 0 && error >= bestError)
+				{
+					continue;
+				}
+
+				uint64_t bits = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					int shift = 59 - c * 8;
+					if (differential)
+					{
+						bits |= (uint64_t)quantized[0][c] << shift;
+						bits |= (uint64_t)(delta[c] & 7) << (shift - 3);
+					}
+					else
+					{
+						bits |= (uint64_t)quantized[0][c] << (shift + 1);
+						bits |= (uint64_t)quantized[1][c] << (shift - 3);
+					}
+				}
+
+				bits |= (uint64_t)subblocks[0].Table << 37;
+				bits |= (uint64_t)subblocks[1].Table << 34;
+				bits |= (uint64_t)differential << 33;
+				bits |= (uint64_t)flip << 32;
+
+				for (int s = 0; s < 2; s++)
+				{
+					for (int n = 0; n < 8; n++)
+					{
+						int j = pixelIndices[s][n];
+						int index = subblocks[s].Indices[n];
+						bits |= (uint64_t)(index >> 1) << (j + 16);
+						bits |= (uint64_t)(index & 1) << j;
+					}
+				}
+
+				bestBits = bits;
+				bestError = error;
+			}
+		}
+
+		WriteBigEndian(bestBits, block);
+	}
+
+	static void EncodeEACAlpha(const uint8_t* pixels, uint8_t* block)
+	{
+		int minAlpha = 255, maxAlpha = 0, sum = 0;
+		for (int i = 0; i < 16; i++)
+		{
+			int alpha = pixels[i * 4 + 3];
+			minAlpha = std::min(minAlpha, alpha);
+			maxAlpha = std::max(maxAlpha, alpha);
+			sum += alpha;
+		}
+
+		uint64_t bestBits = 0;
+		int bestError = -1;
+
+		for (int table = 0; table < 16; table++)
+		{
+			const int* modifiers = s_EACModifiers[table];
+			int range = modifiers[7] - modifiers[3];
+
+			// Multipliers and bases stretching the table's modifiers over the block's alpha range
+			int idealMultiplier = std::max((maxAlpha - minAlpha + range / 2) / range, 1);
+			for (int multiplier = std::max(idealMultiplier - 1, 1); multiplier <= std::min(idealMultiplier + 1, 15); multiplier++)
+			{
+				int idealBase = minAlpha - modifiers[3] * multiplier;
+				int bases[4] = { idealBase - 1, idealBase, idealBase + 1, (sum + 8) / 16 };
+
+				for (int candidate = 0; candidate < 4; candidate++)
+				{
+					int base = Clamp255(bases[candidate]);
+
+					uint64_t indices = 0;
+					int error = 0;
+					for (int x = 0; x < 4; x++)
+					{
+						for (int y = 0; y < 4; y++)
+						{
+							int alpha = pixels[(y * 4 + x) * 4 + 3];
+
+							int bestIndex = 0, bestDistance = -1;
+							for (int index = 0; index < 8; index++)
+							{
+								int distance = std::abs(Clamp255(base + modifiers[index] * multiplier) - alpha);
+								if (bestDistance < 0 || distance < bestDistance)
+								{
+									bestIndex = index;
+									bestDistance = distance;
+								}
+							}
+
+							int j = x * 4 + y;
+							indices |= (uint64_t)bestIndex << (45 - j * 3);
+							error += bestDistance * bestDistance;
+						}
+					}
+
+					if (bestError < 0 || error < bestError)
+					{
+						bestError = error;
+						bestBits = ((uint64_t)base << 56) | ((uint64_t)multiplier << 52) | ((uint64_t)table << 48) | indices;
+					}
+				}
+			}
+		}
+
+		WriteBigEndian(bestBits, block);
+	}
+
+	void EncodeETC2RGBA(const uint8_t* pixels, uint8_t* block)
+	{
+		EncodeEACAlpha(pixels, block);
+		EncodeETC2RGB(pixels, block + 8);
+	}
+
+}
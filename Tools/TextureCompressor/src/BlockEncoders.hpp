@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace BladeEngine::Tools {
+
+	// Every encoder takes the 16 RGBA8 pixels of a 4x4 block in row major order
+
+	// 8 bytes. Pixels with alpha below 128 switch the block to the 3 color mode with a transparent index
+	void EncodeBC1(const uint8_t* pixels, uint8_t* block);
+	// 16 bytes, interpolated alpha followed by a 4 color BC1 block
+	void EncodeBC3(const uint8_t* pixels, uint8_t* block);
+	// 16 bytes, modes 5 and 6 only: one subset, with RGBA or separate RGB and alpha endpoints
+	void EncodeBC7(const uint8_t* pixels, uint8_t* block);
+	// 8 bytes, individual and differential modes only, which every ETC2 decoder reads like ETC1
+	void EncodeETC2RGB(const uint8_t* pixels, uint8_t* block);
+	// 16 bytes, EAC alpha followed by an ETC2 RGB block
+	void EncodeETC2RGBA(const uint8_t* pixels, uint8_t* block);
+
+}
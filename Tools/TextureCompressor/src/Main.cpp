@@ -0,0 +1,294 @@
+#include "BlockEncoders.hpp"
+
+#include "Graphics/TextureContainer.hpp"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace BladeEngine::Graphics;
+using namespace BladeEngine::Tools;
+
+struct Image
+{
+	uint32_t Width, Height;
+	std::vector<uint8_t> Pixels;
+};
+
+static void PrintUsage()
+{
+	printf(
+		"Usage: TextureCompressor <input image> <output.btex> [options]\n"
+		"\n"
+		"Writing the .btex next to the image with the same name makes the engine load it in place of the image\n"
+		"\n"
+		"Options:\n"
+		"  --format <bc1|bc3|bc7|etc2|etc2a|rgba8>  Pixel format, bc7 by default, rgba8 stores the pixels uncompressed\n"
+		"  --no-mips                                Only store the full size level\n");
+}
+
+static bool ParseFormat(const char* name, TextureFormat& format)
+{
+	struct { const char* Name; TextureFormat Format; } formats[] = {
+		{ "bc1", TextureFormat::BC1 },
+		{ "bc3", TextureFormat::BC3 },
+		{ "bc7", TextureFormat::BC7 },
+		{ "etc2", TextureFormat::ETC2_RGB8 },
+		{ "etc2a", TextureFormat::ETC2_RGBA8 },
+		{ "rgba8", TextureFormat::RGBA8 }
+	};
+
+	for (const auto& entry : formats)
+	{
+		if (strcmp(name, entry.Name) == 0)
+		{
+			format = entry.Format;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Same 2x2 box filter the engine uses for uncompressed mip chains
+static Image Downsample(const Image& source)
+{
+	Image level;
+	level.Width = std::max(source.Width / 2, 1u);
+	level.Height = std::max(source.Height / 2, 1u);
+	level.Pixels.resize((size_t)level.Width * level.Height * 4);
+
+	for (uint32_t y = 0; y < level.Height; y++)
+	{
+		uint32_t y0 = std::min(y * 2, source.Height - 1);
+		uint32_t y1 = std::min(y * 2 + 1, source.Height - 1);
+
+		for (uint32_t x = 0; x < level.Width; x++)
+		{
+			uint32_t x0 = std::min(x * 2, source.Width - 1);
+			uint32_t x1 = std::min(x * 2 + 1, source.Width - 1);
+
+			for (uint32_t c = 0; c < 4; c++)
+			{
+				uint32_t sum =
+					source.Pixels[(y0 * source.Width + x0) * 4 + c] + source.Pixels[(y0 * source.Width + x1) * 4 + c] +
+					source.Pixels[(y1 * source.Width + x0) * 4 + c] + source.Pixels[(y1 * source.Width + x1) * 4 + c];
+
+				level.Pixels[(y * level.Width + x) * 4 + c] = (uint8_t)((sum + 2) / 4);
+			}
+		}
+	}
+
+	return level;
+}
+
+// Colors under fully transparent pixels are never seen, giving them the average of the visible ones keeps
+// them from pulling the endpoints away and from bleeding dark fringes in when filtered
+static void FillTransparentColors(uint8_t* pixels)
+{
+	uint32_t sum[3] = {}, count = 0;
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		if (pixels[i * 4 + 3] != 0)
+		{
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				sum[c] += pixels[i * 4 + c];
+			}
+			count++;
+		}
+	}
+
+	if (count == 0 || count == 16)
+	{
+		return;
+	}
+
+	for (uint32_t i = 0; i < 16; i++)
+	{
+		if (pixels[i * 4 + 3] == 0)
+		{
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				pixels[i * 4 + c] = (uint8_t)((sum[c] + count / 2) / count);
+			}
+		}
+	}
+}
+
+static void EncodeLevel(const Image& image, TextureFormat format, std::vector<uint8_t>& output)
+{
+	if (format == TextureFormat::RGBA8)
+	{
+		output.insert(output.end(), image.Pixels.begin(), image.Pixels.end());
+		return;
+	}
+
+	const uint32_t blockSize = GetFormatBlockSize(format);
+	const uint32_t blocksX = (image.Width + 3) / 4;
+	const uint32_t blocksY = (image.Height + 3) / 4;
+
+	size_t offset = output.size();
+	output.resize(offset + (size_t)blocksX * blocksY * blockSize);
+
+	uint8_t pixels[16 * 4];
+	for (uint32_t by = 0; by < blocksY; by++)
+	{
+		for (uint32_t bx = 0; bx < blocksX; bx++)
+		{
+			// Blocks hanging over the edge repeat the last row and column
+			for (uint32_t y = 0; y < 4; y++)
+			{
+				for (uint32_t x = 0; x < 4; x++)
+				{
+					uint32_t sx = std::min(bx * 4 + x, image.Width - 1);
+					uint32_t sy = std::min(by * 4 + y, image.Height - 1);
+					memcpy(&pixels[(y * 4 + x) * 4], &image.Pixels[(sy * image.Width + sx) * 4], 4);
+				}
+			}
+
+			if (format != TextureFormat::BC1)
+			{
+				FillTransparentColors(pixels);
+			}
+
+			uint8_t* block = &output[offset];
+			switch (format)
+			{
+			case TextureFormat::BC1:
+				EncodeBC1(pixels, block);
+				break;
+			case TextureFormat::BC3:
+				EncodeBC3(pixels, block);
+				break;
+			case TextureFormat::BC7:
+				EncodeBC7(pixels, block);
+				break;
+			case TextureFormat::ETC2_RGB8:
+				EncodeETC2RGB(pixels, block);
+				break;
+			case TextureFormat::ETC2_RGBA8:
+				EncodeETC2RGBA(pixels, block);
+				break;
+			default:
+				break;
+			}
+
+			offset += blockSize;
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	const char* inputPath = argv[1];
+	const char* outputPath = argv[2];
+
+	TextureFormat format = TextureFormat::BC7;
+	bool generateMips = true;
+
+	for (int i = 3; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--format") == 0 && i + 1 < argc)
+		{
+			if (!ParseFormat(argv[++i], format))
+			{
+				printf("Unknown format %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--no-mips") == 0)
+		{
+			generateMips = false;
+		}
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	int width, height, channels;
+	uint8_t* pixels = stbi_load(inputPath, &width, &height, &channels, STBI_rgb_alpha);
+	if (!pixels)
+	{
+		printf("Failed to load %s: %s\n", inputPath, stbi_failure_reason());
+		return 1;
+	}
+
+	Image image;
+	image.Width = (uint32_t)width;
+	image.Height = (uint32_t)height;
+	image.Pixels.assign(pixels, pixels + (size_t)width * height * 4);
+	stbi_image_free(pixels);
+
+	bool hasTranslucency = false, hasTransparency = false;
+	for (size_t i = 3; i < image.Pixels.size(); i += 4)
+	{
+		hasTranslucency |= image.Pixels[i] != 0 && image.Pixels[i] != 255;
+		hasTransparency |= image.Pixels[i] != 255;
+	}
+
+	if (hasTransparency && format == TextureFormat::ETC2_RGB8)
+	{
+		printf("Warning: %s has an alpha channel, etc2 drops it, use etc2a to keep it\n", inputPath);
+	}
+	else if (hasTranslucency && format == TextureFormat::BC1)
+	{
+		printf("Warning: %s has translucent pixels, bc1 rounds alpha to 0 or 255\n", inputPath);
+	}
+
+	// BC1 alpha is a single bit, ETC2 RGB has none
+	bool storesTranslucency = format != TextureFormat::BC1 && format != TextureFormat::ETC2_RGB8;
+
+	BTexHeader header = {};
+	header.Magic = BTexMagic;
+	header.Version = BTexVersion;
+	header.Format = (uint32_t)format;
+	header.Width = image.Width;
+	header.Height = image.Height;
+	header.MipLevels = generateMips ? (uint32_t)std::floor(std::log2(std::max(image.Width, image.Height))) + 1 : 1;
+	header.Flags = hasTranslucency && storesTranslucency ? (uint32_t)BTexFlagTranslucent : 0u;
+
+	std::vector<uint8_t> data;
+	size_t uncompressedSize = 0;
+	Image level = image;
+	for (uint32_t i = 0; i < header.MipLevels; i++)
+	{
+		if (i > 0)
+		{
+			level = Downsample(level);
+		}
+
+		EncodeLevel(level, format, data);
+		uncompressedSize += level.Pixels.size();
+	}
+
+	FILE* file = fopen(outputPath, "wb");
+	if (!file)
+	{
+		printf("Failed to open %s for writing\n", outputPath);
+		return 1;
+	}
+
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(data.data(), 1, data.size(), file);
+	fclose(file);
+
+	printf("%s: %ux%u, %u levels, %zu KB (%zu KB as RGBA8)\n", outputPath, image.Width, image.Height,
+		header.MipLevels, data.size() / 1024, uncompressedSize / 1024);
+
+	return 0;
+}